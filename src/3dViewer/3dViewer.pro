@@ -1,6 +1,7 @@
 QT       += core gui opengl
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 5): QT += openglwidgets
 
 CONFIG += c++17
 
@@ -14,13 +15,54 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     ../model/model.cpp \
+    ../model/mapped_file.cpp \
+    ../model/edge_list.cpp \
+    ../model/frame_stats.cpp \
+    ../model/load_stream.cpp \
+    ../model/mesh_bvh.cpp \
+    ../model/mesh_cache.cpp \
+    ../model/mesh_chunks.cpp \
+    ../model/mesh_lod.cpp \
+    ../model/mesh_reorder.cpp \
+    ../model/mesh_weld.cpp \
+    ../model/obj_parser.cpp \
+    ../model/ply_parser.cpp \
+    ../model/quantized_vertices.cpp \
+    ../model/stl_parser.cpp \
+    ../model/thread_pool.cpp \
+    ../model/vertex_kernels.cpp \
     ../controller/controller.cpp \
+    meshrenderer.cpp \
     widgetgl.cpp
 
 HEADERS += \
     mainwindow.h \
     ../model/model.h \
+    ../model/cell_map.h \
+    ../model/edge_list.h \
+    ../model/face_list.h \
+    ../model/frame_stats.h \
+    ../model/load_progress.h \
+    ../model/load_stream.h \
+    ../model/mapped_file.h \
+    ../model/mesh_bvh.h \
+    ../model/mesh_cache.h \
+    ../model/mesh_chunks.h \
+    ../model/mesh_format.h \
+    ../model/mesh_lod.h \
+    ../model/mesh_reorder.h \
+    ../model/mesh_view.h \
+    ../model/mesh_weld.h \
+    ../model/obj_parser.h \
+    ../model/ply_parser.h \
+    ../model/quantized_vertices.h \
+    ../model/soa_vertices.h \
+    ../model/stl_parser.h \
+    ../model/thread_pool.h \
+    ../model/transform_queue.h \
+    ../model/vertex_kernels.h \
     ../controller/controller.h\
+    meshrenderer.h \
     widgetgl.h
 
 FORMS += \
@@ -1,10 +1,68 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QSurfaceFormat>
+#include <iostream>
 
 #include "mainwindow.h"
+#include "widgetgl.h"
 
 int main(int argc, char *argv[]) {
+  // Профиль совместимости 3.3: шейдеры GLSL 3.30 и прежний режим glBegin
+  QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+  format.setVersion(3, 3);
+  format.setProfile(QSurfaceFormat::CompatibilityProfile);
+  QSurfaceFormat::setDefaultFormat(format);
+
   QApplication a(argc, argv);
+
+  // Замеры кадров для сравнения сборок: --stats-overlay показывает их
+  // поверх модели, --frame-log сохраняет последние кадры при выходе
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  QCommandLineOption overlay("stats-overlay", "Показывать замеры кадров.");
+  QCommandLineOption frame_log(
+      "frame-log", "Сохранить замеры кадров в файл (.json или .csv).", "file");
+  QCommandLineOption quantized(
+      "quantized-vertices",
+      "Загружать вершины в видеопамять 16-битными кодами: буфер вершин "
+      "вдвое меньше, в оперативной памяти вершины остаются float и к ним "
+      "добавляются коды (6 байт на вершину).");
+  parser.addOption(overlay);
+  parser.addOption(frame_log);
+  QCommandLineOption weld(
+      "weld-vertices",
+      "Сваривать вершины ближе epsilon и удалять вершины без граней.",
+      "epsilon");
+  QCommandLineOption reorder(
+      "reorder-mesh",
+      "Переставлять грани и вершины модели для кэша вершин и памяти.");
+  QCommandLineOption cache_limit(
+      "cache-limit",
+      "Предел размера кэша разобранных моделей, МБ (0 - не сохранять).",
+      "megabytes");
+  parser.addOption(quantized);
+  parser.addOption(weld);
+  parser.addOption(reorder);
+  parser.addOption(cache_limit);
+  parser.process(a);
+
   MainWindow w;
+  w.viewer()->setStatsOverlay(parser.isSet(overlay));
+  w.viewer()->setQuantizedVertices(parser.isSet(quantized));
+  w.viewer()->setOptimizeLocality(parser.isSet(reorder));
+  if (parser.isSet(cache_limit)) {
+    w.viewer()->setCacheLimit(parser.value(cache_limit).toULongLong() << 20);
+  }
+  if (parser.isSet(weld)) {
+    w.viewer()->setWeldEpsilon(parser.value(weld).toFloat());
+  }
   w.show();
-  return a.exec();
+  int result = a.exec();
+  if (parser.isSet(frame_log)) {
+    std::string filename = parser.value(frame_log).toStdString();
+    if (!w.viewer()->saveFrameStats(filename)) {
+      std::cerr << "Не удалось сохранить замеры в " << filename << std::endl;
+    }
+  }
+  return result;
 }
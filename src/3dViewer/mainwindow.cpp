@@ -1,5 +1,7 @@
 #include "mainwindow.h"
 
+#include <QShortcut>
+
 #include "ui_mainwindow.h"
 
 MainWindow::MainWindow(QWidget *parent)
@@ -7,8 +9,13 @@ MainWindow::MainWindow(QWidget *parent)
   ui->setupUi(this);
   this->setWindowTitle("3dViewer");
 
-  connect(ui->file_button, &QPushButton::clicked, this,
-          &MainWindow::on_file_button_clicked);
+  // on_file_button_clicked подключается автоматически (connectSlotsByName);
+  // второе подключение запускало бы загрузку и тут же отменяло ее
+  file_button_text = ui->file_button->text();
+  connect(ui->openGLWidget, &s21::WidgetGL::loadProgress, this,
+          &MainWindow::load_progress);
+  connect(ui->openGLWidget, &s21::WidgetGL::loadFinished, this,
+          &MainWindow::load_finished);
   connect(ui->line_x, &QLineEdit::textChanged, this,
           &MainWindow::on_line_x_textChanged);
   connect(ui->line_y, &QLineEdit::textChanged, this,
@@ -42,18 +49,56 @@ MainWindow::MainWindow(QWidget *parent)
           &MainWindow::vertex_color);
   connect(ui->background_color, &QPushButton::clicked, this,
           &MainWindow::background_color);
+  // F3 показывает и скрывает замеры кадров поверх модели
+  connect(new QShortcut(QKeySequence(Qt::Key_F3), this), &QShortcut::activated,
+          this, [this] {
+            ui->openGLWidget->setStatsOverlay(
+                !ui->openGLWidget->isStatsOverlay());
+          });
 }
 
 MainWindow::~MainWindow() { delete ui; }
 
+s21::WidgetGL *MainWindow::viewer() const { return ui->openGLWidget; }
+
 void MainWindow::on_file_button_clicked() {
+  // Во время загрузки кнопка отменяет ее
+  if (ui->openGLWidget->isLoading()) {
+    ui->openGLWidget->cancelLoad();
+    load_finished(false);
+    return;
+  }
   std::string file = ui->file_change_name->text().toStdString();
+  ui->file_button->setText("Отмена");
   ui->openGLWidget->loadModel(file);
+}
+
+void MainWindow::load_progress(qint64 bytes, qint64 total, qint64 vertices,
+                               qint64 faces) {
+  QString status = "Загрузка...";
+  if (total > 0) status = QString("Загрузка: %1%").arg(bytes * 100 / total);
+  ui->file_name->setText(status);
+  ui->vertex_count->setText(QString::number(vertices));
+  ui->face_count->setText(QString::number(faces));
+}
+
+void MainWindow::load_finished(bool ok) {
+  ui->file_button->setText(file_button_text);
   ui->file_name->setText(
       QString().fromStdString(ui->openGLWidget->getFileName()));
   ui->vertex_count->setText(
       QString::number(ui->openGLWidget->getVertexCount()));
   ui->face_count->setText(QString::number(ui->openGLWidget->getFacesCount()));
+  // После сварки в подсказке остается число вершин в файле
+  const s21::MeshWeld::Stats &weld = ui->openGLWidget->getWeldStats();
+  ui->vertex_count->setToolTip(
+      weld.vertices_after != weld.vertices_before
+          ? QString("В файле: %1 (слито %2, без граней %3)")
+                .arg(weld.vertices_before)
+                .arg(weld.welded)
+                .arg(weld.unreferenced)
+          : QString());
+  if (!ok) return;
   ui->line_x->setText("0");
   ui->line_y->setText("0");
   ui->line_z->setText("0");
@@ -11,6 +11,10 @@ class MainWindow;
 }
 QT_END_NAMESPACE
 
+namespace s21 {
+class WidgetGL;
+}
+
 /**
  * @brief Главное окно приложения.
  *
@@ -38,6 +42,13 @@ class MainWindow : public QMainWindow {
    */
   ~MainWindow();
 
+  /**
+   * @brief Возвращает виджет отрисовки модели.
+   *
+   * @return Виджет OpenGL главного окна.
+   */
+  s21::WidgetGL *viewer() const;
+
  signals:
   /**
    * @brief Сигнал, отправляемый при изменении позиции модели.
@@ -54,6 +65,24 @@ class MainWindow : public QMainWindow {
    */
   void on_file_button_clicked();
 
+  /**
+   * @brief Показывает ход загрузки модели.
+   *
+   * @param bytes Разобрано байт.
+   * @param total Размер файла в байтах.
+   * @param vertices Найдено вершин.
+   * @param faces Найдено граней.
+   */
+  void load_progress(qint64 bytes, qint64 total, qint64 vertices,
+                     qint64 faces);
+
+  /**
+   * @brief Обновляет сведения о модели по окончании загрузки.
+   *
+   * @param ok true, если модель загружена.
+   */
+  void load_finished(bool ok);
+
   /**
    * @brief Обработчик события изменения текста в поле ввода координаты x.
    *
@@ -171,6 +200,7 @@ class MainWindow : public QMainWindow {
 
  private:
   Ui::MainWindow *ui;  // Указатель на объект пользовательского интерфейса
+  QString file_button_text;  // Надпись кнопки загрузки вне загрузки
 };
 
 #endif  // MAINWINDOW_H
@@ -0,0 +1,270 @@
+#include "meshrenderer.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+namespace {
+
+// Сжатые координаты (uploadQuantizedVertices) приходят нормализованными в
+// [0, 1], и их раскодирование входит в матрицу mvp
+const char* kVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 mvp;
+uniform float point_size;
+void main() {
+  gl_Position = mvp * vec4(position, 1.0);
+  gl_PointSize = point_size;
+}
+)";
+
+const char* kFragmentShader = R"(
+#version 330 core
+uniform vec4 color;
+uniform bool round_points;
+out vec4 frag_color;
+void main() {
+  if (round_points && length(gl_PointCoord - vec2(0.5)) > 0.5) discard;
+  frag_color = color;
+}
+)";
+
+// Рисует диапазоны привязанного буфера индексов или весь буфер и
+// возвращает число отправленных индексов
+size_t drawRanges(QOpenGLExtraFunctions* gl, GLenum mode, size_t count,
+                  const std::vector<MeshChunks::Range>* ranges) {
+  if (ranges == nullptr) {
+    gl->glDrawElements(mode, static_cast<GLsizei>(count), GL_UNSIGNED_INT,
+                       nullptr);
+    return count;
+  }
+  size_t submitted = 0;
+  for (const MeshChunks::Range& range : *ranges) {
+    gl->glDrawElements(
+        mode, static_cast<GLsizei>(range.count), GL_UNSIGNED_INT,
+        reinterpret_cast<const void*>(range.first * sizeof(uint32_t)));
+    submitted += range.count;
+  }
+  return submitted;
+}
+
+}  // namespace
+
+MeshRenderer::MeshRenderer()
+    : valid(false),
+      vertex_buffer(QOpenGLBuffer::VertexBuffer),
+      index_buffer(QOpenGLBuffer::IndexBuffer),
+      point_buffer(QOpenGLBuffer::IndexBuffer),
+      vertex_count(0),
+      edge_index_count(0),
+      point_index_count(0),
+      vertex_capacity(0),
+      edge_index_capacity(0),
+      frame_stats(nullptr),
+      quantized(false),
+      dequantization(1.0f) {}
+
+bool MeshRenderer::initialize() {
+  initializeOpenGLFunctions();
+  valid = program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                          kVertexShader) &&
+          program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                          kFragmentShader) &&
+          program.link() && vao.create() && vertex_buffer.create() &&
+          index_buffer.create() && point_buffer.create();
+  if (!valid) {
+    release();
+    return false;
+  }
+  vertex_buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+  index_buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+  point_buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+  vao.bind();
+  index_buffer.bind();
+  glEnableVertexAttribArray(0);
+  vao.release();
+  setVertexFormat(false);
+  return true;
+}
+
+void MeshRenderer::setVertexFormat(bool compressed) {
+  vao.bind();
+  vertex_buffer.bind();
+  if (compressed) {
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE,
+                          3 * sizeof(uint16_t), nullptr);
+  } else {
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3),
+                          nullptr);
+    dequantization = glm::mat4(1.0f);
+  }
+  vao.release();
+  vertex_buffer.release();
+  quantized = compressed;
+}
+
+void MeshRenderer::release() {
+  vao.destroy();
+  vertex_buffer.destroy();
+  index_buffer.destroy();
+  point_buffer.destroy();
+  program.removeAllShaders();
+  valid = false;
+  clear();
+  vertex_capacity = 0;
+  edge_index_capacity = 0;
+}
+
+void MeshRenderer::clear() {
+  vertex_count = 0;
+  edge_index_count = 0;
+  point_index_count = 0;
+}
+
+void MeshRenderer::uploadVertices(const glm::vec3* vertices, size_t count) {
+  if (!valid) return;
+  bool reformat = quantized;
+  if (reformat) setVertexFormat(false);
+  int bytes = static_cast<int>(count * sizeof(glm::vec3));
+  vertex_buffer.bind();
+  if (count == vertex_count && count != 0 && !reformat) {
+    vertex_buffer.write(0, vertices, bytes);
+  } else {
+    vertex_buffer.allocate(vertices, bytes);
+    vertex_capacity = count;
+  }
+  vertex_buffer.release();
+  vertex_count = count;
+}
+
+void MeshRenderer::uploadQuantizedVertices(const QuantizedVertices& vertices) {
+  if (!valid) return;
+  if (!quantized) setVertexFormat(true);
+  vertex_buffer.bind();
+  vertex_buffer.allocate(
+      vertices.data(),
+      static_cast<int>(vertices.size() * 3 * sizeof(uint16_t)));
+  vertex_buffer.release();
+  vertex_count = vertices.size();
+  // Емкость считается во float-вершинах: дозагрузка перевыделит буфер
+  vertex_capacity = 0;
+  dequantization = vertices.dequantization_matrix();
+}
+
+void MeshRenderer::appendVertices(const glm::vec3* vertices, size_t count) {
+  if (!valid || count <= vertex_count) return;
+  if (quantized) {
+    setVertexFormat(false);
+    vertex_count = 0;
+    vertex_capacity = 0;
+  }
+  vertex_buffer.bind();
+  if (count > vertex_capacity) {
+    vertex_capacity = std::max(count, vertex_capacity * 2);
+    vertex_buffer.allocate(
+        static_cast<int>(vertex_capacity * sizeof(glm::vec3)));
+    vertex_buffer.write(0, vertices,
+                        static_cast<int>(count * sizeof(glm::vec3)));
+  } else {
+    vertex_buffer.write(
+        static_cast<int>(vertex_count * sizeof(glm::vec3)),
+        vertices + vertex_count,
+        static_cast<int>((count - vertex_count) * sizeof(glm::vec3)));
+  }
+  vertex_buffer.release();
+  vertex_count = count;
+}
+
+void MeshRenderer::uploadEdges(const std::vector<uint32_t>& edges) {
+  if (!valid) return;
+  vao.bind();
+  index_buffer.bind();
+  index_buffer.allocate(edges.data(),
+                        static_cast<int>(edges.size() * sizeof(uint32_t)));
+  vao.release();
+  edge_index_count = edges.size();
+  edge_index_capacity = edges.size();
+}
+
+void MeshRenderer::uploadPoints(const std::vector<uint32_t>& points) {
+  if (!valid) return;
+  // Привязка буфера индексов хранится в VAO, поэтому после записи точек
+  // в нем снова остается буфер ребер
+  vao.bind();
+  point_buffer.bind();
+  point_buffer.allocate(points.data(),
+                        static_cast<int>(points.size() * sizeof(uint32_t)));
+  index_buffer.bind();
+  vao.release();
+  point_index_count = points.size();
+}
+
+void MeshRenderer::appendEdges(const std::vector<uint32_t>& edges) {
+  if (!valid || edges.size() <= edge_index_count) return;
+  vao.bind();
+  index_buffer.bind();
+  if (edges.size() > edge_index_capacity) {
+    edge_index_capacity = std::max(edges.size(), edge_index_capacity * 2);
+    index_buffer.allocate(
+        static_cast<int>(edge_index_capacity * sizeof(uint32_t)));
+    index_buffer.write(0, edges.data(),
+                       static_cast<int>(edges.size() * sizeof(uint32_t)));
+  } else {
+    index_buffer.write(
+        static_cast<int>(edge_index_count * sizeof(uint32_t)),
+        edges.data() + edge_index_count,
+        static_cast<int>((edges.size() - edge_index_count) * sizeof(uint32_t)));
+  }
+  vao.release();
+  edge_index_count = edges.size();
+}
+
+void MeshRenderer::draw(const glm::mat4& mvp, const Style& style,
+                        const std::vector<MeshChunks::Range>* edge_ranges,
+                        const std::vector<MeshChunks::Range>* point_ranges) {
+  if (!valid || vertex_count == 0) return;
+  program.bind();
+  vao.bind();
+  glm::mat4 matrix = mvp * dequantization;
+  glUniformMatrix4fv(program.uniformLocation("mvp"), 1, GL_FALSE,
+                     glm::value_ptr(matrix));
+  int color = program.uniformLocation("color");
+  int round_points = program.uniformLocation("round_points");
+
+  program.setUniformValue(round_points, false);
+  program.setUniformValue(color, style.edge_color);
+  size_t edges = drawRanges(this, GL_LINES, edge_index_count, edge_ranges) / 2;
+  size_t points = 0;
+  if (frame_stats) frame_stats->mark(FrameStats::kEdges);
+
+  if (style.vertex_type != 0) {
+    glEnable(GL_PROGRAM_POINT_SIZE);
+#ifdef GL_POINT_SPRITE
+    // В профиле совместимости gl_PointCoord работает только со спрайтами
+    glEnable(GL_POINT_SPRITE);
+#endif
+    program.setUniformValue("point_size", style.vertex_size);
+    program.setUniformValue(round_points, style.vertex_type == 1);
+    program.setUniformValue(color, style.vertex_color);
+    if (point_index_count != 0) {
+      point_buffer.bind();
+      points = drawRanges(this, GL_POINTS, point_index_count, point_ranges);
+      index_buffer.bind();
+    } else {
+      glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertex_count));
+      points = vertex_count;
+    }
+    glDisable(GL_PROGRAM_POINT_SIZE);
+  }
+
+  vao.release();
+  program.release();
+  if (frame_stats) {
+    frame_stats->mark(FrameStats::kPoints);
+    frame_stats->add_submitted(edges, points);
+  }
+}
+
+}  // namespace s21
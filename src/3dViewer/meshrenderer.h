@@ -0,0 +1,173 @@
+#ifndef MESHRENDERER_H
+#define MESHRENDERER_H
+
+#include <QColor>
+#include <QOpenGLBuffer>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <glm/ext.hpp>
+#include <vector>
+
+#include "../model/frame_stats.h"
+#include "../model/mesh_chunks.h"
+#include "../model/quantized_vertices.h"
+
+namespace s21 {
+
+/**
+ * @brief Отрисовщик модели через буферы OpenGL (VBO/IBO) и шейдеры.
+ *
+ * Класс MeshRenderer хранит вершины модели и список уникальных ребер в
+ * видеопамяти и рисует их вызовами glDrawElements/glDrawArrays. Данные
+ * загружаются только при изменении геометрии, а не на каждом кадре.
+ * Все методы вызываются при активном контексте OpenGL.
+ */
+class MeshRenderer : protected QOpenGLExtraFunctions {
+ public:
+  /**
+   * @brief Параметры отображения модели.
+   */
+  struct Style {
+    QColor edge_color;    // Цвет линий
+    QColor vertex_color;  // Цвет вершин
+    float vertex_size;    // Размер вершин
+    int vertex_type;      // Тип вершин: 0 - нет, 1 - круг, 2 - квадрат
+  };
+
+  /**
+   * @brief Конструктор по умолчанию.
+   */
+  MeshRenderer();
+
+  /**
+   * @brief Компилирует шейдеры и создает буферы.
+   *
+   * @return true, если контекст поддерживает шейдеры GLSL 3.30.
+   */
+  bool initialize();
+
+  /**
+   * @brief Освобождает ресурсы OpenGL.
+   */
+  void release();
+
+  /**
+   * @brief Проверяет, готов ли отрисовщик к работе.
+   *
+   * @return true, если инициализация прошла успешно.
+   */
+  bool isValid() const { return valid; }
+
+  /**
+   * @brief Загружает вершины в видеопамять.
+   *
+   * @param vertices Указатель на вершины.
+   * @param count Количество вершин.
+   */
+  void uploadVertices(const glm::vec3* vertices, size_t count);
+
+  /**
+   * @brief Загружает в видеопамять сжатые вершины.
+   *
+   * Буфер занимает 6 байт на вершину вместо 12; шейдер раскодирует
+   * координаты матрицей QuantizedVertices::dequantization_matrix,
+   * умноженной на матрицу модели-вида-проекции в draw.
+   *
+   * @param vertices Сжатые вершины.
+   */
+  void uploadQuantizedVertices(const QuantizedVertices& vertices);
+
+  /**
+   * @brief Загружает индексы ребер в видеопамять.
+   *
+   * @param edges Пары индексов вершин (отсчет с нуля).
+   */
+  void uploadEdges(const std::vector<uint32_t>& edges);
+
+  /**
+   * @brief Загружает порядок вершин для отрисовки точек по кускам.
+   *
+   * Без него точки рисуются всем массивом вершин.
+   *
+   * @param points Индексы вершин, упорядоченные по кускам модели.
+   */
+  void uploadPoints(const std::vector<uint32_t>& points);
+
+  /**
+   * @brief Дозагружает вершины, появившиеся в конце массива.
+   *
+   * В видеопамять пишутся только вершины после уже загруженных. Буфер
+   * растет с запасом (вдвое), и лишь при росте массив пишется целиком,
+   * поэтому дозагрузка по частям стоит O(1) на вершину.
+   *
+   * @param vertices Все вершины, включая уже загруженные.
+   * @param count Общее количество вершин.
+   */
+  void appendVertices(const glm::vec3* vertices, size_t count);
+
+  /**
+   * @brief Дозагружает индексы ребер, появившиеся в конце массива.
+   *
+   * @param edges Все пары индексов, включая уже загруженные.
+   */
+  void appendEdges(const std::vector<uint32_t>& edges);
+
+  /**
+   * @brief Забывает загруженные данные, не освобождая буферы.
+   *
+   * Следующая дозагрузка начнется с начала буферов.
+   */
+  void clear();
+
+  /**
+   * @brief Рисует ребра и вершины модели.
+   *
+   * @param mvp Матрица модели-вида-проекции.
+   * @param style Параметры отображения.
+   * @param edge_ranges Видимые диапазоны буфера ребер (nullptr - все ребра).
+   * @param point_ranges Видимые диапазоны порядка точек из uploadPoints
+   * (nullptr - все точки).
+   */
+  void draw(const glm::mat4& mvp, const Style& style,
+            const std::vector<MeshChunks::Range>* edge_ranges = nullptr,
+            const std::vector<MeshChunks::Range>* point_ranges = nullptr);
+
+  /**
+   * @brief Задает замеры кадра, в которые draw отмечает свои фазы.
+   *
+   * draw отмечает фазы kEdges и kPoints и учитывает отправленные ребра
+   * и вершины.
+   *
+   * @param stats Замеры кадра или nullptr, чтобы не замерять.
+   */
+  void setFrameStats(FrameStats* stats) { frame_stats = stats; }
+
+ private:
+  /**
+   * @brief Задает формат атрибута вершин в VAO.
+   *
+   * @param compressed true - три GL_UNSIGNED_SHORT, нормализованные в
+   * [0, 1]; false - три float.
+   */
+  void setVertexFormat(bool compressed);
+
+  bool valid;                         // Признак успешной инициализации
+  QOpenGLShaderProgram program;       // Шейдерная программа
+  QOpenGLVertexArrayObject vao;       // Состояние вершинных атрибутов
+  QOpenGLBuffer vertex_buffer;        // Буфер вершин
+  QOpenGLBuffer index_buffer;         // Буфер индексов ребер
+  QOpenGLBuffer point_buffer;         // Буфер индексов точек по кускам
+  size_t vertex_count;                // Количество загруженных вершин
+  size_t edge_index_count;            // Количество загруженных индексов ребер
+  size_t point_index_count;           // Количество загруженных индексов точек
+  size_t vertex_capacity;             // Вместимость буфера вершин
+  size_t edge_index_capacity;         // Вместимость буфера индексов
+  FrameStats* frame_stats;            // Замеры кадра или nullptr
+  bool quantized;                     // В буфере вершин сжатые координаты
+  glm::mat4 dequantization;           // Раскодирование сжатых координат
+};
+
+}  // namespace s21
+
+#endif  // MESHRENDERER_H
@@ -1,9 +1,28 @@
 #include "widgetgl.h"
 
+#include <QPainter>
 #include <iostream>
 
 namespace s21 {
-WidgetGL::WidgetGL(QWidget* parent) : QOpenGLWidget(parent) {}
+WidgetGL::WidgetGL(QWidget* parent) : QOpenGLWidget(parent) {
+  // Вращение, масштаб и перемещение меняют только матрицу модели, а вершины
+  // в видеопамяти остаются прежними
+  controller.setTransformMode(TransformMode::kMatrix);
+  connect(&progress_timer, &QTimer::timeout, this, &WidgetGL::reportProgress);
+  settle_timer.setSingleShot(true);
+  settle_timer.setInterval(300);
+  connect(&settle_timer, &QTimer::timeout, this, &WidgetGL::endInteraction);
+}
+
+WidgetGL::~WidgetGL() {
+  cancelLoad();
+  makeCurrent();
+  renderer.release();
+  lod_renderer.release();
+  for (GpuTimer& timer : gpu_timers) timer.query.destroy();
+  doneCurrent();
+}
+
 void WidgetGL::initializeGL() {
   vertex_size = 5;
   vertex_color = QColor(0, 255, 255);
@@ -17,6 +36,25 @@ void WidgetGL::initializeGL() {
 
   glClearColor(0, 0, 0, 1);
   glEnable(GL_DEPTH_TEST);
+
+  // Без GLSL 3.30 остается прежний режим отрисовки glBegin/glEnd
+  renderer.initialize();
+  lod_renderer.initialize();
+  renderer.setFrameStats(&frame_stats);
+  lod_renderer.setFrameStats(&frame_stats);
+  uploaded.invalidate();
+  lod_uploaded = 0;
+
+  // Запросы таймера есть в OpenGL 3.3 и в расширении ARB_timer_query;
+  // без них замеряется только время на процессоре
+  gpu_timing = true;
+  for (GpuTimer& timer : gpu_timers) {
+    timer.pending = false;
+    gpu_timing = gpu_timing && timer.query.create();
+  }
+  if (!gpu_timing) {
+    for (GpuTimer& timer : gpu_timers) timer.query.destroy();
+  }
 }
 
 void WidgetGL::resizeGL(int w, int h) {
@@ -31,6 +69,17 @@ void WidgetGL::resizeGL(int w, int h) {
 }
 
 void WidgetGL::paintGL() {
+  uint64_t frame = frame_stats.begin_frame();
+  // Все изменения положения, поворота и масштаба с прошлого кадра
+  // применяются одним преобразованием
+  controller.applyTransforms();
+  collectGpuTimes();
+  GpuTimer* timer = nullptr;
+  if (gpu_timing && !gpu_timers[gpu_timer_next].pending) {
+    timer = &gpu_timers[gpu_timer_next];
+    timer->query.begin();
+  }
+
   glClearColor(background_color.redF(), background_color.greenF(),
                background_color.blueF(), 1);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -60,20 +109,183 @@ void WidgetGL::paintGL() {
       break;
   }
 
-  vertices = std::vector<glm::vec3>(controller.getVertices(),
-                                    controller.getVerticesEnd());
-  faces = std::vector<std::vector<size_t>>(controller.getFaces(),
-                                           controller.getFacesEnd());
+  frame_stats.mark(FrameStats::kSetup);
+
+  if (renderer.isValid()) {
+    paintRetained();
+  } else if (previewing) {
+    paintPreviewImmediate();
+  } else {
+    paintImmediate();
+  }
+
+  if (timer) {
+    timer->query.end();
+    timer->frame = frame;
+    timer->pending = true;
+    gpu_timer_next = (gpu_timer_next + 1) % gpu_timers.size();
+  }
+  glFlush();
+  frame_stats.end_frame();
+
+  // Замеры рисуются после конца кадра и в него не входят
+  if (stats_overlay) paintOverlay();
+}
+
+void WidgetGL::collectGpuTimes() {
+  for (GpuTimer& timer : gpu_timers) {
+    if (!timer.pending || !timer.query.isResultAvailable()) continue;
+    frame_stats.set_gpu_time(timer.frame, timer.query.waitForResult() / 1e6);
+    timer.pending = false;
+  }
+}
+
+void WidgetGL::paintOverlay() {
+  FrameStats::Summary summary = frame_stats.summarize();
+  const FrameStats::Frame& frame = frame_stats.last();
+  QString text =
+      QString("CPU, мс: %1 (p50 %2, p95 %3, p99 %4)\n")
+          .arg(frame.cpu, 0, 'f', 2)
+          .arg(summary.cpu_p50, 0, 'f', 2)
+          .arg(summary.cpu_p95, 0, 'f', 2)
+          .arg(summary.cpu_p99, 0, 'f', 2) +
+      QString("  подготовка %1, данные %2, ребра %3, вершины %4\n")
+          .arg(frame.phases[FrameStats::kSetup], 0, 'f', 2)
+          .arg(frame.phases[FrameStats::kPrepare], 0, 'f', 2)
+          .arg(frame.phases[FrameStats::kEdges], 0, 'f', 2)
+          .arg(frame.phases[FrameStats::kPoints], 0, 'f', 2);
+  if (summary.gpu_frames != 0) {
+    text += QString("GPU, мс: p50 %1, p95 %2, p99 %3\n")
+                .arg(summary.gpu_p50, 0, 'f', 2)
+                .arg(summary.gpu_p95, 0, 'f', 2)
+                .arg(summary.gpu_p99, 0, 'f', 2);
+  } else {
+    text += "GPU: нет замеров\n";
+  }
+  text += QString("Ребер: %1, вершин: %2")
+              .arg(static_cast<qulonglong>(frame.edges))
+              .arg(static_cast<qulonglong>(frame.points));
+
+  QPainter painter(this);
+  painter.setPen(QColor(255, 255, 0));
+  painter.setFont(QFont("monospace", 9));
+  painter.drawText(rect().adjusted(8, 8, -8, -8), Qt::AlignLeft | Qt::AlignTop,
+                   text);
+  painter.end();
+  // QPainter выключает проверку глубины, а initializeGL включает ее один раз
+  glEnable(GL_DEPTH_TEST);
+}
+
+void WidgetGL::paintRetained() {
+  glm::mat4 model_matrix;
+  if (previewing) {
+    // Во время загрузки дописываются только новые вершины и ребра
+    if (preview_reset) {
+      renderer.clear();
+      preview_reset = false;
+    }
+    renderer.appendVertices(preview_vertices.data(), preview_vertices.size());
+    renderer.appendEdges(preview_edges);
+    model_matrix = preview_matrix;
+  } else {
+    // Данные уходят в видеопамять прямо из хранилища модели и только если
+    // модель изменилась с прошлого кадра
+    MeshView mesh = controller.getView();
+    MeshViewTracker::Changes changes = uploaded.sync(mesh);
+    if (changes.topology) {
+      // Ребра и вершины уходят упорядоченными по кускам, чтобы видимые
+      // куски рисовались диапазонами
+      const MeshChunks& chunks = controller.getChunks();
+      renderer.uploadEdges(chunks.edge_indices());
+      renderer.uploadPoints(chunks.point_indices());
+    }
+    if (changes.vertices && quantize_vertices) {
+      // Коды хранятся в модели и пересобираются только с новым поколением
+      // вершин, а не при каждой перезагрузке буфера
+      renderer.uploadQuantizedVertices(controller.getQuantizedVertices());
+    } else if (changes.vertices) {
+      renderer.uploadVertices(mesh.vertices.data(), mesh.vertices.size());
+    }
+    model_matrix = mesh.model_matrix;
+  }
+
+  // Во время преобразований большая модель рисуется упрощенной; полная
+  // остается в видеопамяти и возвращается сразу после паузы
+  MeshRenderer* active = &renderer;
+  if (const LodLevel* lod = activeLod()) {
+    if (lod->generation != lod_uploaded) {
+      lod_renderer.uploadEdges(lod->edges);
+      lod_renderer.uploadVertices(lod->vertices.data(), lod->vertices.size());
+      lod_uploaded = lod->generation;
+    }
+    active = &lod_renderer;
+  }
+
+  glm::mat4 mvp = viewProjection() * model_matrix;
+  MeshRenderer::Style style{edge_color, vertex_color, vertex_size,
+                            vertex_type};
+  if (active == &renderer && !previewing) {
+    cullChunks(mvp);
+    frame_stats.mark(FrameStats::kPrepare);
+    active->draw(mvp, style, &edge_ranges, &point_ranges);
+  } else {
+    frame_stats.mark(FrameStats::kPrepare);
+    active->draw(mvp, style);
+  }
+}
+
+glm::mat4 WidgetGL::viewProjection() const {
+  float aspect = static_cast<float>(width()) / std::max(height(), 1);
+  glm::mat4 projection =
+      projection_type == 1
+          ? glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, -10.0f, 10.0f)
+          : glm::perspective(glm::radians(45.0f), aspect, 0.01f, 100.0f);
+  glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 5), glm::vec3(0, 0, 0),
+                               glm::vec3(0.0f, 1.0f, 0.0f));
+  return projection * view;
+}
+
+void WidgetGL::cullChunks(const glm::mat4& mvp) {
+  cull_stats = controller.getChunks().cull(mvp, width(), height(), cull_small,
+                                           edge_ranges, point_ranges);
+}
+
+void WidgetGL::paintImmediate() {
+  MeshView view = controller.getView();
+  const MeshChunks& chunks = controller.getChunks();
+  const std::vector<uint32_t>* edges = &chunks.edge_indices();
+  const std::vector<uint32_t>* points = &chunks.point_indices();
+  if (const LodLevel* lod = activeLod()) {
+    view.vertices = Span<const glm::vec3>(lod->vertices.data(),
+                                          lod->vertices.size());
+    edges = &lod->edges;
+    points = nullptr;
+    edge_ranges.assign(
+        1, {0, static_cast<uint32_t>(lod->edges.size())});
+    point_ranges.assign(
+        1, {0, static_cast<uint32_t>(lod->vertices.size())});
+  } else {
+    cullChunks(viewProjection() * view.model_matrix);
+  }
+  const glm::vec3* vertices = view.vertices.data();
+  frame_stats.mark(FrameStats::kPrepare);
+  size_t submitted_edges = 0;
+  size_t submitted_points = 0;
+
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glMultMatrixf(glm::value_ptr(view.model_matrix));
 
   glColor3f(edge_color.redF(), edge_color.greenF(), edge_color.blueF());
   glBegin(GL_LINES);
-  for (const auto& face : faces) {
-    for (size_t i = 0; i < face.size() - 1; i++) {
-      glVertex3fv(glm::value_ptr(vertices[face[i] - 1]));
-      glVertex3fv(glm::value_ptr(vertices[face[i + 1] - 1]));
+  for (const MeshChunks::Range& range : edge_ranges) {
+    for (uint32_t i = range.first; i < range.first + range.count; ++i) {
+      glVertex3fv(glm::value_ptr(vertices[(*edges)[i]]));
     }
+    submitted_edges += range.count / 2;
   }
   glEnd();
+  frame_stats.mark(FrameStats::kEdges);
 
   glColor3f(vertex_color.redF(), vertex_color.greenF(), vertex_color.blueF());
   switch (vertex_type) {
@@ -90,36 +302,181 @@ void WidgetGL::paintGL() {
       break;
   }
 
-  for (const glm::vec3& vertex : vertices) {
-    glVertex3fv(glm::value_ptr(vertex));
+  for (const MeshChunks::Range& range : point_ranges) {
+    for (uint32_t i = range.first; i < range.first + range.count; ++i) {
+      glVertex3fv(glm::value_ptr(vertices[points ? (*points)[i] : i]));
+    }
+    if (vertex_type != 0) submitted_points += range.count;
   }
   glEnd();
-  glFlush();
+
+  glPopMatrix();
+  frame_stats.mark(FrameStats::kPoints);
+  frame_stats.add_submitted(submitted_edges, submitted_points);
+}
+
+void WidgetGL::paintPreviewImmediate() {
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glMultMatrixf(glm::value_ptr(preview_matrix));
+  glColor3f(edge_color.redF(), edge_color.greenF(), edge_color.blueF());
+  glBegin(GL_LINES);
+  for (uint32_t index : preview_edges) {
+    glVertex3fv(glm::value_ptr(preview_vertices[index]));
+  }
+  glEnd();
+  glPopMatrix();
+  frame_stats.mark(FrameStats::kEdges);
+  frame_stats.add_submitted(preview_edges.size() / 2, 0);
 }
 
 void WidgetGL::loadModel(const std::string& filename) {
-  controller.loadModel(filename.c_str());
-  this->filename = filename;
-  vertex_count = controller.getVerticesSize();
-  faces_count = controller.getFacesSize();
+  cancelLoad();
+  job = std::make_shared<LoadJob>();
+  job->filename = filename;
+  job->model = controller.prepareModel();
+  LoadStream* stream = nullptr;
+  if (streaming) {
+    // Уведомление приходит, только когда очередь была пуста, поэтому в
+    // очереди событий не больше одного вызова drainStream
+    job->stream.set_callback([this] {
+      QMetaObject::invokeMethod(
+          this, [this] { drainStream(); }, Qt::QueuedConnection);
+    });
+    stream = &job->stream;
+  }
+  // Рабочий поток трогает только свою модель; текущая модель продолжает
+  // рисоваться, пока загрузка не закончится
+  loader = std::thread([this, started = job, stream] {
+    started->ok = controller.loadModel(started->filename, started->model,
+                                       &started->progress, stream);
+    if (started->ok && started->model.faces_size() != 0) {
+      buildStructures(started->model, started->progress);
+    }
+    QMetaObject::invokeMethod(
+        this, [this, started] { finishLoad(started); }, Qt::QueuedConnection);
+  });
+  progress_timer.start(100);
+}
+
+void WidgetGL::buildStructures(Model& model, LoadProgress& progress) {
+  // Модель еще принадлежит рабочему потоку, поэтому дерево граней и уровни
+  // детализации строятся прямо по ее массивам, без копии геометрии
+  MeshView view = model.view();
+  MeshBvh bvh;
+  bvh.build(view.vertices.data(), view.vertices.size(), *view.faces, 0,
+            &progress);
+  if (progress.cancelled()) return;
+  model.set_bvh(std::move(bvh), view.topology_generation,
+                view.geometry_generation);
+  const MeshLod::Settings& settings = model.get_lod_settings();
+  if (settings.resolutions.empty() || model.faces_size() < settings.min_faces)
+    return;
+  std::vector<LodLevel> lods =
+      MeshLod::build(view.vertices.data(), view.vertices.size(),
+                     model.get_edges(), settings, &progress);
+  if (!progress.cancelled()) {
+    model.set_lods(std::move(lods), view.geometry_generation);
+  }
+}
+
+void WidgetGL::cancelLoad() {
+  if (!job) return;
+  job->progress.cancel();
+  loader.join();
+  progress_timer.stop();
+  controller.recycleModel(job->model);
+  // Отложенный вызов finishLoad для этой загрузки будет проигнорирован
+  job.reset();
+  endPreview();
+}
+
+void WidgetGL::finishLoad(const std::shared_ptr<LoadJob>& finished) {
+  if (finished != job) return;
+  progress_timer.stop();
+  loader.join();
+  job.reset();
+  endPreview();
+  if (finished->ok) {
+    controller.swapModel(finished->model);
+    filename = finished->filename;
+    vertex_count = controller.getVerticesSize();
+    faces_count = controller.getFacesSize();
+    update();
+  }
+  // Старая модель (или неудачная новая) отдает память следующей загрузке
+  controller.recycleModel(finished->model);
+  emit loadFinished(finished->ok);
+}
+
+void WidgetGL::drainStream() {
+  if (!job || !job->stream.take(batch)) return;
+  if (!previewing) {
+    previewing = true;
+    preview_reset = true;
+  }
+  // Ребра строятся только для этой порции; ребра к еще не прочитанным
+  // вершинам пропускаются до окончательной модели
+  preview_vertices.insert(preview_vertices.end(), batch.vertices.begin(),
+                          batch.vertices.end());
+  std::vector<uint32_t> edges =
+      EdgeList::build(batch.faces, preview_vertices.size());
+  preview_edges.insert(preview_edges.end(), edges.begin(), edges.end());
+  // Границы прочитанной части только растут, поэтому модель постепенно
+  // сжимается и к концу загрузки совпадает с нормализованной
+  preview_matrix = Model::normalization_matrix(batch.bounds);
   update();
 }
 
-void WidgetGL::setModelPosition(float x, float y, float z) {
-  controller.setPossition(glm::vec3(x, y, z));
+void WidgetGL::endPreview() {
+  if (!previewing) return;
+  previewing = false;
+  preview_vertices = std::vector<glm::vec3>();
+  preview_edges = std::vector<uint32_t>();
+  // Отрисовщик держит частичную модель, текущую нужно загрузить заново
+  uploaded.invalidate();
   update();
 }
 
+void WidgetGL::reportProgress() {
+  if (!job) return;
+  const LoadProgress& progress = job->progress;
+  emit loadProgress(static_cast<qint64>(progress.bytes_parsed()),
+                    static_cast<qint64>(progress.total_bytes()),
+                    static_cast<qint64>(progress.vertices()),
+                    static_cast<qint64>(progress.faces()));
+}
+
+void WidgetGL::setModelPosition(float x, float y, float z) {
+  controller.queuePosition(glm::vec3(x, y, z));
+  beginInteraction();
+}
+
 void WidgetGL::setRotation(float angle, glm::vec3 axis) {
-  controller.setRotation(angle, axis);
-  update();
+  controller.queueRotation(angle, axis);
+  beginInteraction();
 }
 
 void WidgetGL::setScale(float scale) {
-  controller.setScale(scale);
+  controller.queueScale(scale);
+  beginInteraction();
+}
+
+void WidgetGL::beginInteraction() {
+  interacting = true;
+  settle_timer.start();
   update();
 }
 
+void WidgetGL::endInteraction() {
+  interacting = false;
+  update();
+}
+
+const LodLevel* WidgetGL::activeLod() const {
+  return interacting ? controller.getLod(interactive_edges) : nullptr;
+}
+
 void WidgetGL::setProjection(int index) {
   projection_type = index;
   update();
@@ -4,12 +4,19 @@
 #include <GL/glut.h>
 
 #include <QMainWindow>
+#include <QOpenGLTimerQuery>
 #include <QOpenGLWidget>
+#include <QTimer>
 #include <QWidget>
+#include <array>
 #include <glm/ext.hpp>
+#include <memory>
+#include <thread>
 
 #include "../controller/controller.h"
+#include "../model/frame_stats.h"
 #include "../model/model.h"
+#include "meshrenderer.h"
 
 namespace s21 {
 
@@ -33,6 +40,13 @@ class WidgetGL : public QOpenGLWidget {
    */
   WidgetGL(QWidget* parent = nullptr);
 
+  /**
+   * @brief Деструктор класса WidgetGL.
+   *
+   * Освобождает буферы OpenGL модели.
+   */
+  ~WidgetGL() override;
+
   /**
    * @brief Возвращает имя загруженного файла модели.
    *
@@ -54,17 +68,200 @@ class WidgetGL : public QOpenGLWidget {
    */
   size_t getFacesCount() { return faces_count; }
 
+  /**
+   * @brief Проверяет, идет ли загрузка модели.
+   *
+   * @return true, если файл загружается в фоновом потоке.
+   */
+  bool isLoading() const { return job != nullptr; }
+
+  /**
+   * @brief Включает показ модели по мере загрузки (по умолчанию включен).
+   *
+   * Пока файл разбирается, уже прочитанные вершины и ребра дорисовываются
+   * с предварительной нормализацией по границам прочитанной части; по
+   * окончании загрузки их сменяет готовая модель.
+   *
+   * @param enabled true, чтобы показывать модель по мере загрузки.
+   */
+  void setStreaming(bool enabled) { streaming = enabled; }
+
+  /**
+   * @brief Задает каталог кэша разобранных моделей.
+   *
+   * @param directory Каталог кэша; пустая строка отключает кэш.
+   */
+  void setCacheDirectory(const std::string& directory) {
+    controller.setCacheDirectory(directory);
+  }
+
+  /**
+   * @brief Задает предел общего размера кэша разобранных моделей.
+   *
+   * @param bytes Предел в байтах; 0 - не сохранять модели в кэш.
+   */
+  void setCacheLimit(uint64_t bytes) { controller.setCacheLimit(bytes); }
+
+  /**
+   * @brief Включает сварку вершин у следующих загружаемых моделей.
+   *
+   * @param epsilon Расстояние сварки в нормализованных координатах;
+   * отрицательное значение отключает сварку (см. Controller::setWeldEpsilon).
+   */
+  void setWeldEpsilon(float epsilon) { controller.setWeldEpsilon(epsilon); }
+
+  /**
+   * @brief Возвращает итог сварки вершин текущей модели.
+   *
+   * @return Число вершин до и после сварки.
+   */
+  const MeshWeld::Stats& getWeldStats() const {
+    return controller.getWeldStats();
+  }
+
+  /**
+   * @brief Включает перестановку граней и вершин у следующих загрузок.
+   *
+   * @param enabled true, чтобы переставлять (см. Controller::setOptimizeLocality).
+   */
+  void setOptimizeLocality(bool enabled) {
+    controller.setOptimizeLocality(enabled);
+  }
+
+  /**
+   * @brief Задает бюджет ребер для кадра во время преобразований.
+   *
+   * Пока пользователь меняет положение, поворот или масштаб, модель, в
+   * которой ребер больше бюджета, рисуется упрощенным уровнем детализации;
+   * через короткую паузу после последнего изменения - целиком.
+   *
+   * @param edges Сколько ребер можно рисовать за кадр.
+   */
+  void setInteractiveEdges(size_t edges) { interactive_edges = edges; }
+
+  /**
+   * @brief Включает отбрасывание кусков модели меньше пикселя.
+   *
+   * Куски вне пирамиды видимости не рисуются всегда; куски, которые на
+   * экране меньше пикселя, - только при включенном режиме (по умолчанию
+   * выключен: такие куски дают на экране точку).
+   *
+   * @param enabled true, чтобы отбрасывать мелкие куски.
+   */
+  void setSmallFeatureCulling(bool enabled) {
+    cull_small = enabled;
+    update();
+  }
+
+  /**
+   * @brief Включает сжатие вершин в видеопамяти.
+   *
+   * Буфер вершин на видеокарте заполняется 16-битными кодами (6 байт на
+   * вершину вместо 12, см. QuantizedVertices), которые раскодируются в
+   * шейдере. Ошибка не больше 1/131070 размаха модели по оси. Экономится
+   * только видеопамять: модель по-прежнему хранит вершины в float и
+   * держит коды рядом (Model::quantized_vertices), так что в оперативной
+   * памяти добавляется 6 байт на вершину.
+   *
+   * @param enabled true, чтобы сжимать вершины.
+   */
+  void setQuantizedVertices(bool enabled) {
+    quantize_vertices = enabled;
+    uploaded.invalidate();
+    update();
+  }
+
+  /**
+   * @brief Возвращает итог отсечения последнего кадра.
+   *
+   * @return Число нарисованных и отброшенных кусков, ребер и вершин.
+   */
+  const MeshChunks::Stats& getCullStats() const { return cull_stats; }
+
+  /**
+   * @brief Показывает или скрывает поверх модели замеры кадров.
+   *
+   * @param enabled true, чтобы показывать замеры.
+   */
+  void setStatsOverlay(bool enabled) {
+    stats_overlay = enabled;
+    update();
+  }
+
+  /**
+   * @brief Проверяет, показываются ли замеры кадров.
+   *
+   * @return true, если замеры показываются.
+   */
+  bool isStatsOverlay() const { return stats_overlay; }
+
+  /**
+   * @brief Возвращает замеры последних кадров.
+   *
+   * Время фаз paintGL на процессоре, время на видеокарте (если контекст
+   * поддерживает запросы таймера) и число отправленных ребер и вершин.
+   *
+   * @return Замеры кадров.
+   */
+  const FrameStats& getFrameStats() const { return frame_stats; }
+
+  /**
+   * @brief Сохраняет замеры последних кадров.
+   *
+   * @param filename Имя файла: .json - JSON, иначе CSV.
+   * @return true, если файл записан.
+   */
+  bool saveFrameStats(const std::string& filename) const {
+    return frame_stats.save(filename);
+  }
+
+  /**
+   * @brief Забывает замеры прошлых кадров.
+   */
+  void clearFrameStats() { frame_stats.clear(); }
+
+ signals:
+  /**
+   * @brief Сигнал о ходе загрузки (примерно каждые 100 мс).
+   *
+   * @param bytes Разобрано байт.
+   * @param total Размер файла в байтах (0, если неизвестен).
+   * @param vertices Найдено вершин.
+   * @param faces Найдено граней.
+   */
+  void loadProgress(qint64 bytes, qint64 total, qint64 vertices, qint64 faces);
+
+  /**
+   * @brief Сигнал о завершении загрузки.
+   *
+   * @param ok true, если модель загружена и показана; false при ошибке или
+   * отмене (остается прежняя модель).
+   */
+  void loadFinished(bool ok);
+
  public slots:
   /**
-   * @brief Загружает модель из указанного файла.
+   * @brief Начинает загрузку модели из указанного файла.
+   *
+   * Файл разбирается в фоновом потоке, интерфейс и отрисовка прежней
+   * модели не блокируются. Загрузка, начатая раньше, отменяется. В том же
+   * потоке строятся дерево граней и уровни детализации; затем готовая
+   * модель подменяет текущую и отправляется сигнал loadFinished.
    *
    * @param filename Путь к файлу с моделью.
    */
   void loadModel(const std::string& filename);
 
+  /**
+   * @brief Отменяет текущую загрузку; прежняя модель остается на экране.
+   */
+  void cancelLoad();
+
   /**
    * @brief Устанавливает позицию модели.
    *
+   * Изменение применяется в начале следующего кадра вместе с остальными.
+   *
    * @param x Координата x позиции.
    * @param y Координата y позиции.
    * @param z Координата z позиции.
@@ -74,6 +271,8 @@ class WidgetGL : public QOpenGLWidget {
   /**
    * @brief Устанавливает вращение модели.
    *
+   * Изменение применяется в начале следующего кадра вместе с остальными.
+   *
    * @param angle Угол вращения в радианах.
    * @param axis Ось вращения.
    */
@@ -82,6 +281,8 @@ class WidgetGL : public QOpenGLWidget {
   /**
    * @brief Устанавливает масштаб модели.
    *
+   * Изменение применяется в начале следующего кадра вместе с остальными.
+   *
    * @param scale Коэффициент масштабирования.
    */
   void setScale(float scale);
@@ -162,6 +363,109 @@ class WidgetGL : public QOpenGLWidget {
   virtual void paintGL() override;
 
  private:
+  /**
+   * @brief Фоновая загрузка: файл, модель, в которую он читается, и ход.
+   */
+  struct LoadJob {
+    std::string filename;              // Путь к файлу
+    Model model;                       // Загружаемая модель
+    LoadProgress progress;             // Ход загрузки и запрос отмены
+    LoadStream stream;                 // Части модели, прочитанные к этому моменту
+    bool ok = false;                   // Результат загрузки
+  };
+
+  /**
+   * @brief Забирает из очереди загрузки новые части модели для показа.
+   */
+  void drainStream();
+
+  /**
+   * @brief Прекращает показ частично загруженной модели.
+   */
+  void endPreview();
+
+  /**
+   * @brief Подменяет модель загруженной (в потоке интерфейса).
+   *
+   * @param finished Завершившаяся загрузка.
+   */
+  void finishLoad(const std::shared_ptr<LoadJob>& finished);
+
+  /**
+   * @brief Строит дерево граней и уровни детализации загруженной модели
+   * (в рабочем потоке, до передачи модели контроллеру).
+   *
+   * @param model Загруженная модель.
+   * @param progress Ход загрузки и запрос отмены.
+   */
+  static void buildStructures(Model& model, LoadProgress& progress);
+
+  /**
+   * @brief Отправляет сигнал loadProgress по таймеру.
+   */
+  void reportProgress();
+
+  /**
+   * @brief Отмечает изменение преобразования модели пользователем.
+   *
+   * Переключает отрисовку на уровень детализации и перезапускает таймер
+   * возврата к полной модели.
+   */
+  void beginInteraction();
+
+  /**
+   * @brief Возвращает отрисовку полной модели после паузы в изменениях.
+   */
+  void endInteraction();
+
+  /**
+   * @brief Возвращает уровень детализации для текущего кадра.
+   *
+   * @return Уровень или nullptr, если рисуется полная модель.
+   */
+  const LodLevel* activeLod() const;
+
+  /**
+   * @brief Отрисовка из буферов видеопамяти через шейдеры.
+   */
+  void paintRetained();
+
+  /**
+   * @brief Отрисовка в режиме glBegin/glEnd (если нет GLSL 3.30).
+   */
+  void paintImmediate();
+
+  /**
+   * @brief Возвращает произведение матриц проекции и камеры.
+   *
+   * @return Матрица вида-проекции текущего кадра.
+   */
+  glm::mat4 viewProjection() const;
+
+  /**
+   * @brief Отбирает видимые куски полной модели.
+   *
+   * Заполняет edge_ranges, point_ranges и cull_stats.
+   *
+   * @param mvp Матрица модели-вида-проекции.
+   */
+  void cullChunks(const glm::mat4& mvp);
+
+  /**
+   * @brief Дописывает к кадрам готовые результаты запросов таймера.
+   */
+  void collectGpuTimes();
+
+  /**
+   * @brief Рисует замеры кадров поверх модели.
+   */
+  void paintOverlay();
+
+  /**
+   * @brief Отрисовка частично загруженной модели без шейдеров.
+   */
+  void paintPreviewImmediate();
+
   std::string filename;  // Имя загруженного файла модели
 
   size_t vertex_count;      // Количество вершин модели
@@ -178,8 +482,48 @@ class WidgetGL : public QOpenGLWidget {
 
   s21::Controller controller;  // Контроллер модели
 
-  std::vector<glm::vec3> vertices;  // Векторы вершин
-  std::vector<std::vector<size_t>> faces;  // Индексы вершин в гранях
+  MeshRenderer renderer;     // Отрисовщик через VBO/IBO
+  MeshViewTracker uploaded;  // Поколения модели, уже загруженные в видеопамять
+
+  std::shared_ptr<LoadJob> job;  // Текущая фоновая загрузка
+  std::thread loader;            // Поток фоновой загрузки
+  QTimer progress_timer;         // Таймер отчета о ходе загрузки
+
+  bool streaming = true;    // Показывать модель по мере загрузки
+  bool previewing = false;  // Показывается частично загруженная модель
+  bool preview_reset = false;  // Буферы отрисовщика еще не очищены для показа
+  LoadStream::Batch batch;     // Последняя порция из очереди загрузки
+  std::vector<glm::vec3> preview_vertices;  // Прочитанные вершины
+  std::vector<uint32_t> preview_edges;      // Ребра прочитанных граней
+  glm::mat4 preview_matrix;  // Предварительная нормализация
+
+  MeshRenderer lod_renderer;          // Отрисовщик уровня детализации
+  uint64_t lod_uploaded = 0;          // Номер уровня в видеопамяти
+  bool interacting = false;           // Пользователь меняет преобразование
+  QTimer settle_timer;                // Пауза до возврата к полной модели
+  size_t interactive_edges = 1 << 20;  // Бюджет ребер во время изменений
+
+  bool cull_small = false;  // Отбрасывать куски меньше пикселя
+  bool quantize_vertices = false;  // Хранить вершины в видеопамяти сжатыми
+  std::vector<MeshChunks::Range> edge_ranges;   // Видимые ребра кадра
+  std::vector<MeshChunks::Range> point_ranges;  // Видимые вершины кадра
+  MeshChunks::Stats cull_stats;                 // Итог отсечения кадра
+
+  /**
+   * @brief Запрос времени кадра на видеокарте.
+   */
+  struct GpuTimer {
+    QOpenGLTimerQuery query;  // Запрос таймера
+    uint64_t frame = 0;       // Номер замеряемого кадра
+    bool pending = false;     // Результат еще не забран
+  };
+
+  FrameStats frame_stats;       // Замеры последних кадров
+  bool stats_overlay = false;   // Показывать замеры поверх модели
+  bool gpu_timing = false;      // Контекст поддерживает запросы таймера
+  // Результат приходит через несколько кадров, поэтому запросов несколько
+  std::array<GpuTimer, 4> gpu_timers;
+  size_t gpu_timer_next = 0;  // Следующий запрос по кругу
 };
 
 }  // namespace s21
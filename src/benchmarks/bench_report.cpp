@@ -0,0 +1,169 @@
+#include "bench_report.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace s21 {
+
+    namespace {
+        // Строка JSON с экранированием кавычек, обратной черты и управляющих символов
+        void write_string(std::ostream& out, const std::string& text){
+            out << '"';
+            for(char c : text){
+                if(c == '"' || c == '\\'){
+                    out << '\\' << c;
+                } else if(static_cast<unsigned char>(c) < 0x20){
+                    out << ' ';
+                } else {
+                    out << c;
+                }
+            }
+            out << '"';
+        }
+
+        std::vector<std::string> split(const std::string& list){
+            std::vector<std::string> items;
+            std::stringstream stream(list);
+            std::string item;
+            while(std::getline(stream, item, ',')){
+                if(!item.empty()){
+                    items.push_back(item);
+                }
+            }
+            return items;
+        }
+
+        bool parse_size(const std::string& text, size_t& size){
+            char* end = nullptr;
+            double value = std::strtod(text.c_str(), &end);
+            if(end == text.c_str() || value <= 0.0){
+                return false;
+            }
+            std::string suffix(end);
+            if(suffix == "k" || suffix == "K"){
+                value *= 1e3;
+            } else if(suffix == "m" || suffix == "M"){
+                value *= 1e6;
+            } else if(!suffix.empty()){
+                return false;
+            }
+            size = static_cast<size_t>(value);
+            return true;
+        }
+    } // namespace
+
+    bool BenchOptions::parse(int argc, char** argv, std::string& error){
+        for(int i = 1; i < argc; ++i){
+            std::string option = argv[i];
+            bool known = option == "--sizes" || option == "--arities" || option == "--runs" ||
+                         option == "--output" || option == "--work-dir";
+            if(!known){
+                continue;
+            }
+            if(i + 1 >= argc){
+                error = "missing value for " + option;
+                return false;
+            }
+            std::string value = argv[++i];
+            if(option == "--sizes"){
+                sizes.clear();
+                for(const std::string& item : split(value)){
+                    size_t size = 0;
+                    if(!parse_size(item, size)){
+                        error = "bad size " + item;
+                        return false;
+                    }
+                    sizes.push_back(size);
+                }
+            } else if(option == "--arities"){
+                arities.clear();
+                for(const std::string& item : split(value)){
+                    MeshGenerator::Arity arity;
+                    if(!MeshGenerator::parse_arity(item, arity)){
+                        error = "bad arity " + item;
+                        return false;
+                    }
+                    arities.push_back(arity);
+                }
+            } else if(option == "--runs"){
+                runs = std::strtoul(value.c_str(), nullptr, 10);
+            } else if(option == "--output"){
+                output = value;
+            } else {
+                work_dir = value;
+            }
+        }
+        return true;
+    }
+
+    size_t BenchOptions::runs_for(size_t vertices) const {
+        if(runs != 0){
+            return runs;
+        }
+        return std::min<size_t>(20, std::max<size_t>(1, 3000000 / std::max<size_t>(vertices, 1)));
+    }
+
+    std::string BenchOptions::size_name(size_t size){
+        if(size >= 1000000 && size % 1000000 == 0){
+            return std::to_string(size / 1000000) + "m";
+        }
+        if(size >= 1000 && size % 1000 == 0){
+            return std::to_string(size / 1000) + "k";
+        }
+        return std::to_string(size);
+    }
+
+    void BenchReport::add(const std::string& name, std::vector<double> times, const Counters& counters){
+        results.push_back({name, std::move(times), counters});
+    }
+
+    void BenchReport::write_json(std::ostream& out) const {
+        // Счетчики вроде 10000000 должны выводиться целыми, а не 1e+07
+        out.precision(12);
+        out << "{\n  \"suite\": ";
+        write_string(out, suite);
+        out << ",\n  \"info\": {";
+        for(size_t i = 0; i < info.size(); ++i){
+            out << (i == 0 ? "" : ", ");
+            write_string(out, info[i].first);
+            out << ": ";
+            write_string(out, info[i].second);
+        }
+        out << "},\n  \"results\": [";
+        for(size_t i = 0; i < results.size(); ++i){
+            const Result& result = results[i];
+            std::vector<double> sorted = result.times;
+            std::sort(sorted.begin(), sorted.end());
+            double median = 0.0;
+            if(!sorted.empty()){
+                size_t middle = sorted.size() / 2;
+                median = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2.0;
+            }
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+            write_string(out, result.name);
+            out << ", \"runs\": " << sorted.size() << ", \"median_ms\": " << median
+                << ", \"min_ms\": " << (sorted.empty() ? 0.0 : sorted.front())
+                << ", \"max_ms\": " << (sorted.empty() ? 0.0 : sorted.back());
+            for(const auto& counter : result.counters){
+                out << ", ";
+                write_string(out, counter.first);
+                out << ": " << counter.second;
+            }
+            out << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    bool BenchReport::save(const std::string& filename) const {
+        if(filename.empty()){
+            write_json(std::cout);
+            return static_cast<bool>(std::cout);
+        }
+        std::ofstream out(filename, std::ios::trunc);
+        write_json(out);
+        return static_cast<bool>(out);
+    }
+} // namespace s21
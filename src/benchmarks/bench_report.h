@@ -0,0 +1,158 @@
+#ifndef SRC_BENCHMARKS_BENCH_REPORT_H
+#define SRC_BENCHMARKS_BENCH_REPORT_H
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mesh_generator.h"
+
+namespace s21 {
+    /**
+     * @brief Параметры запуска набора замеров из командной строки.
+     *
+     * --sizes 10k,1m,10m - размеры сеток (число вершин, суффиксы k и m);
+     * --arities tri,quad,mixed - виды граней;
+     * --runs N - число повторов каждого замера (по умолчанию зависит от размера);
+     * --output FILE - куда писать JSON (по умолчанию стандартный вывод);
+     * --work-dir DIR - каталог для сгенерированных файлов.
+     */
+    struct BenchOptions {
+        std::vector<size_t> sizes{10000, 1000000, 10000000}; // Размеры сеток
+        std::vector<MeshGenerator::Arity> arities{MeshGenerator::Arity::kTriangles,
+                                                  MeshGenerator::Arity::kQuads,
+                                                  MeshGenerator::Arity::kMixed}; // Виды граней
+        size_t runs = 0; // Повторов каждого замера (0 - по размеру сетки)
+        std::string output; // Файл отчета
+        std::string work_dir = "."; // Каталог сгенерированных файлов
+
+        /**
+         * @brief Разбирает аргументы командной строки.
+         *
+         * Неизвестные аргументы пропускаются: их может разбирать Qt.
+         *
+         * @param argc Число аргументов.
+         * @param argv Аргументы.
+         * @param error Описание ошибки, если разбор не удался.
+         * @return true, если аргументы разобраны.
+         */
+        bool parse(int argc, char** argv, std::string& error);
+
+        /**
+         * @brief Число повторов замера для сетки заданного размера.
+         *
+         * Без --runs большие сетки замеряются реже: около 3 * 10^6 вершин
+         * на замер, но не меньше одного и не больше 20 повторов.
+         *
+         * @param vertices Число вершин сетки.
+         * @return Число повторов.
+         */
+        size_t runs_for(size_t vertices) const;
+
+        /**
+         * @brief Стабильное имя размера для имен замеров.
+         *
+         * @param size Число вершин.
+         * @return Например "10k", "1m", "10m".
+         */
+        static std::string size_name(size_t size);
+    };
+
+    /**
+     * @brief Отчет о замерах в JSON.
+     *
+     * Каждый замер - это имя вида "группа/операция/грани/размер", по
+     * которому результаты разных запусков сравниваются построчно, время
+     * всех повторов (медиана, минимум, максимум) и числовые сведения о
+     * сетке.
+     */
+    class BenchReport {
+        public:
+            using Counters = std::vector<std::pair<std::string, double>>;
+
+            /**
+             * @brief Создает отчет.
+             *
+             * @param suite Имя набора замеров.
+             */
+            explicit BenchReport(std::string suite) : suite(std::move(suite)) {}
+
+            /**
+             * @brief Добавляет сведения о машине или сборке.
+             *
+             * @param key Имя.
+             * @param value Значение.
+             */
+            void set_info(const std::string& key, const std::string& value){
+                info.emplace_back(key, value);
+            }
+
+            /**
+             * @brief Добавляет замер.
+             *
+             * @param name Стабильное имя замера.
+             * @param times Время повторов, мс.
+             * @param counters Числовые сведения (вершины, грани и т. п.).
+             */
+            void add(const std::string& name, std::vector<double> times, const Counters& counters = {});
+
+            /**
+             * @brief Добавляет замер, повторяя функцию runs раз.
+             *
+             * @param name Стабильное имя замера.
+             * @param runs Число повторов.
+             * @param f Замеряемая функция.
+             * @param counters Числовые сведения.
+             */
+            template <typename F>
+            void measure(const std::string& name, size_t runs, F&& f, const Counters& counters = {}){
+                std::vector<double> times;
+                for(size_t i = 0; i < runs; ++i){
+                    times.push_back(measure_ms(f));
+                }
+                add(name, std::move(times), counters);
+            }
+
+            /**
+             * @brief Пишет отчет в JSON.
+             *
+             * @param out Поток вывода.
+             */
+            void write_json(std::ostream& out) const;
+
+            /**
+             * @brief Пишет отчет в файл или в стандартный вывод.
+             *
+             * @param filename Имя файла; пустое - стандартный вывод.
+             * @return true, если отчет записан.
+             */
+            bool save(const std::string& filename) const;
+
+            /**
+             * @brief Время выполнения функции.
+             *
+             * @param f Функция.
+             * @return Время, мс.
+             */
+            template <typename F>
+            static double measure_ms(F&& f){
+                auto start = std::chrono::steady_clock::now();
+                f();
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+
+        private:
+            struct Result {
+                std::string name; // Имя замера
+                std::vector<double> times; // Время повторов, мс
+                Counters counters; // Числовые сведения
+            };
+
+            std::string suite; // Имя набора
+            std::vector<std::pair<std::string, std::string>> info; // Сведения о машине
+            std::vector<Result> results; // Замеры в порядке добавления
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,605 @@
+#include <malloc.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "../model/edge_list.h"
+#include "../model/mesh_cache.h"
+#include "../model/model.h"
+#include "../model/obj_parser.h"
+#include "../model/soa_vertices.h"
+#include "../model/vertex_kernels.h"
+
+namespace {
+    // Учет памяти, выделенной через new: текущий объем и пик, а также
+    // число выделений и их суммарный объем
+    std::atomic<size_t> live_bytes{0};
+    std::atomic<size_t> peak_bytes{0};
+    std::atomic<size_t> allocation_count{0};
+    std::atomic<size_t> allocated_bytes{0};
+} // namespace
+
+void* operator new(size_t size){
+    void* ptr = std::malloc(size != 0 ? size : 1);
+    if(ptr == nullptr){
+        throw std::bad_alloc();
+    }
+    ++allocation_count;
+    allocated_bytes += size;
+    size_t live = live_bytes += malloc_usable_size(ptr);
+    size_t peak = peak_bytes.load();
+    while(live > peak && !peak_bytes.compare_exchange_weak(peak, live)){
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    if(ptr != nullptr){
+        live_bytes -= malloc_usable_size(ptr);
+        std::free(ptr);
+    }
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+namespace {
+
+    using Faces = std::vector<std::vector<size_t>>;
+
+    // Прежняя реализация Model::read_file (getline + stringstream + strtok)
+    void legacy_parse(const char* filename, std::vector<glm::vec3>& vertices, Faces& faces){
+        std::ifstream file(filename);
+        std::string line;
+        while(getline(file, line)){
+            if(line.empty()){
+                continue;
+            }
+            if (line[0] == 'v' && line[1] == ' '){
+                line = line.substr(2);
+                std::stringstream ss(line);
+                float x, y, z;
+                ss >> x >> y >> z;
+                vertices.emplace_back(x, y, z);
+            } else if (line[0] == 'f'){
+                std::vector<size_t> cur_vec;
+                char* pars_str = strtok((char*)line.c_str(), "f ");
+                while(pars_str != nullptr){
+                    int cur;
+                    sscanf(pars_str, "%d", &cur);
+                    cur_vec.push_back(cur);
+                    pars_str = strtok(nullptr, " ");
+                }
+                faces.push_back(cur_vec);
+            }
+        }
+    }
+
+    // Сетка grid x grid со случайным рельефом, по два треугольника на ячейку
+    void generate_obj(const char* filename, size_t grid){
+        std::ofstream out(filename);
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> height(-1.0f, 1.0f);
+        out.precision(7);
+        for(size_t i = 0; i < grid; ++i){
+            for(size_t j = 0; j < grid; ++j){
+                out << "v " << i * 0.01f << ' ' << j * 0.01f << ' ' << height(rng) << '\n';
+            }
+        }
+        for(size_t i = 0; i + 1 < grid; ++i){
+            for(size_t j = 0; j + 1 < grid; ++j){
+                size_t a = i * grid + j + 1, b = a + 1, c = a + grid, d = c + 1;
+                out << "f " << a << ' ' << b << ' ' << d << '\n';
+                out << "f " << a << ' ' << d << ' ' << c << '\n';
+            }
+        }
+    }
+
+    template <typename F>
+    double measure_ms(F&& f){
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto diff = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::milli>(diff).count();
+    }
+
+    // Прежний разбор хранит индексы как в файле (с единицы), FaceList - с нуля
+    bool same_faces(const Faces& nested, const s21::FaceList& flat){
+        if(nested.size() != flat.size()){
+            return false;
+        }
+        for(size_t i = 0; i < nested.size(); ++i){
+            auto face = flat[i];
+            if(!std::equal(nested[i].begin(), nested[i].end(), face.begin(), face.end(),
+                           [](size_t legacy, uint32_t index){ return legacy == size_t(index) + 1; })){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Оценка памяти std::vector<std::vector<size_t>> с учетом служебных
+    // данных malloc (16 байт на блок)
+    size_t nested_bytes(const Faces& faces){
+        size_t bytes = faces.capacity() * sizeof(std::vector<size_t>);
+        for(const auto& face : faces){
+            bytes += face.capacity() * sizeof(size_t) + 16;
+        }
+        return bytes;
+    }
+
+    // Прежняя Model::normalization: пять проходов по вершинам; возвращает
+    // итоговый центр, который она пересчитывала в конце
+    glm::vec3 legacy_normalization(std::vector<glm::vec3>& vertices){
+        glm::vec3 min_values = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max_values = glm::vec3(std::numeric_limits<float>::lowest());
+        for(const glm::vec3& vertex : vertices){
+            min_values = glm::min(min_values, vertex);
+            max_values = glm::max(max_values, vertex);
+        }
+        glm::vec3 range = max_values - min_values;
+        float scale = 2.0 / std::max(range.x, glm::max(range.y, range.z));
+        for(auto& vertex : vertices){
+            vertex = (vertex - min_values) * scale - glm::vec3(1.0f);
+        }
+        glm::vec3 center(0.0f);
+        for(const glm::vec3& vertex : vertices){
+            center += vertex;
+        }
+        center /= static_cast<float>(vertices.size());
+        for(glm::vec3& vertex : vertices){
+            vertex -= center;
+        }
+        glm::vec3 result(0.0f);
+        for(const glm::vec3& vertex : vertices){
+            result += vertex;
+        }
+        return result / static_cast<float>(vertices.size());
+    }
+
+    // Прежний Model::rotate: три прохода по вершинам
+    void legacy_rotate(std::vector<glm::vec3>& vertices, const glm::mat4& rotation, const glm::vec3& center){
+        for(auto &vertex : vertices){
+            vertex -= center;
+        }
+        for(auto &vertex : vertices){
+            vertex = rotation * glm::vec4(vertex, 1.0f);
+        }
+        for(auto &vertex : vertices){
+            vertex += center;
+        }
+    }
+
+    // Однопроходные ядра против прежних циклов на count вершинах
+    void benchmark_kernels(size_t count){
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+        std::vector<glm::vec3> source(count);
+        for(auto& vertex : source){
+            vertex = glm::vec3(coord(rng), coord(rng), coord(rng));
+        }
+        glm::vec3 center(1.0f, 2.0f, 3.0f);
+        glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 around_center = glm::translate(glm::mat4(1.0f), center) * rotation *
+                                  glm::translate(glm::mat4(1.0f), -center);
+
+        std::cout << "vertex kernels on " << count << " vertices:" << std::endl;
+        std::vector<glm::vec3> vertices = source;
+        glm::vec3 legacy_center;
+        double legacy_ms = measure_ms([&] { legacy_center = legacy_normalization(vertices); });
+        std::cout << "  legacy normalization (5 passes): " << legacy_ms << " ms (center drift "
+                  << glm::length(legacy_center) << ")" << std::endl;
+        vertices = source;
+        std::cout << "  legacy rotate (3 passes):        "
+                  << measure_ms([&] { legacy_rotate(vertices, rotation, center); }) << " ms" << std::endl;
+
+        using Isa = s21::VertexKernels::Isa;
+        for(Isa isa : {Isa::kScalar, Isa::kSse, Isa::kAvx}){
+            if(isa > s21::VertexKernels::best_isa()){
+                break;
+            }
+            s21::VertexKernels::set_isa(isa);
+            const char* name = s21::VertexKernels::isa_name(isa);
+            s21::VertexKernels::Bounds bounds;
+            double reduce_ms = measure_ms([&] { bounds = s21::VertexKernels::reduce(source.data(), source.size()); });
+            vertices = source;
+            double transform_ms = measure_ms([&] {
+                s21::VertexKernels::transform(vertices.data(), vertices.size(), around_center);
+            });
+            std::cout << "  " << name << ": reduce " << reduce_ms << " ms, transform "
+                      << transform_ms << " ms, normalization "
+                      << reduce_ms + transform_ms << " ms" << std::endl;
+        }
+        s21::VertexKernels::set_isa(s21::VertexKernels::best_isa());
+    }
+
+    // AoS против SoA: преобразование, свертка и подготовка к загрузке в VBO.
+    // Для AoS загрузка - это копия готового массива, для SoA - сборка в vec3
+    void benchmark_layouts(size_t count){
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+        std::vector<glm::vec3> aos(count);
+        for(auto& vertex : aos){
+            vertex = glm::vec3(coord(rng), coord(rng), coord(rng));
+        }
+        s21::SoaVertices soa;
+        soa.assign(aos.data(), aos.size());
+        std::vector<glm::vec3> staging(count);
+        glm::mat4 matrix = glm::rotate(glm::mat4(1.0f), glm::radians(30.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        double aos_transform = measure_ms([&] { s21::VertexKernels::transform(aos.data(), aos.size(), matrix); });
+        double soa_transform = measure_ms([&] { soa.transform(matrix); });
+        double aos_reduce = measure_ms([&] { s21::VertexKernels::reduce(aos.data(), aos.size()); });
+        double soa_reduce = measure_ms([&] { soa.bounds(); });
+        double aos_upload = measure_ms([&] { std::copy(aos.begin(), aos.end(), staging.begin()); });
+        double soa_upload = measure_ms([&] { soa.export_interleaved(staging.data()); });
+        bool same = std::equal(aos.begin(), aos.end(), staging.begin());
+
+        std::cout << "layouts on " << count << " vertices ("
+                  << s21::VertexKernels::isa_name(s21::VertexKernels::isa()) << "):" << std::endl;
+        std::cout << "  transform: AoS " << aos_transform << " ms, SoA " << soa_transform << " ms" << std::endl;
+        std::cout << "  reduce:    AoS " << aos_reduce << " ms, SoA " << soa_reduce << " ms" << std::endl;
+        std::cout << "  upload:    AoS " << aos_upload << " ms, SoA " << soa_upload << " ms"
+                  << (same ? "" : " MISMATCH") << std::endl;
+    }
+
+    // Model::rotate на count вершинах от 1 до max_threads потоков
+    void benchmark_parallel_rotate(const char* filename, size_t max_threads){
+        s21::Model md;
+        md.read_file(filename);
+        std::vector<glm::vec3> reference;
+        for(size_t threads = 1; ; threads = std::min(threads * 2, max_threads)){
+            md.read_file(filename);
+            md.set_transform_threads(threads);
+            double ms = measure_ms([&] { md.rotate(30.0f, glm::vec3(0.0f, 1.0f, 0.0f)); });
+            std::vector<glm::vec3> result(md.vertices_begin(), md.vertices_end());
+            if(reference.empty()){
+                reference = result;
+            }
+            std::cout << "rotate " << md.vertices_size() << " vertices, threads " << threads
+                      << ": " << ms << " ms" << (result == reference ? "" : " MISMATCH") << std::endl;
+            if(threads >= max_threads){
+                break;
+            }
+        }
+    }
+
+    // Пиковая дополнительная память, выделенная через new за время f
+    template <typename F>
+    size_t measure_peak_bytes(F&& f){
+        size_t before = live_bytes.load();
+        peak_bytes = before;
+        f();
+        return peak_bytes.load() - before;
+    }
+
+    // Прежнее построение ребер: сортировка ключей всех сторон граней
+    std::vector<uint32_t> legacy_edges(const s21::FaceList& faces, size_t vertex_count){
+        std::vector<uint64_t> keys;
+        keys.reserve(faces.index_data().size());
+        for(const auto face : faces){
+            for(size_t i = 0; i + 1 < face.size(); i++){
+                uint32_t a = face[i], b = face[i + 1];
+                if(a >= vertex_count || b >= vertex_count || a == b){
+                    continue;
+                }
+                if(a > b){
+                    std::swap(a, b);
+                }
+                keys.push_back(static_cast<uint64_t>(a) << 32 | b);
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        std::vector<uint32_t> edges;
+        edges.reserve(keys.size() * 2);
+        for(uint64_t key : keys){
+            edges.push_back(static_cast<uint32_t>(key >> 32));
+            edges.push_back(static_cast<uint32_t>(key));
+        }
+        return edges;
+    }
+
+    // Уникальные ребра на сетке grid x grid (2 (grid - 1)^2 треугольников)
+    void benchmark_edges(size_t grid){
+        s21::FaceList faces;
+        for(uint32_t i = 0; i + 1 < grid; ++i){
+            for(uint32_t j = 0; j + 1 < grid; ++j){
+                uint32_t a = i * grid + j + 1, b = a + 1, c = a + grid, d = c + 1;
+                const uint32_t triangles[] = {a, b, d, a, d, c};
+                faces.push_face(triangles, 3);
+                faces.push_face(triangles + 3, 3);
+            }
+        }
+        size_t vertex_count = grid * grid;
+        std::vector<uint32_t> legacy, edges;
+        double legacy_ms = 0.0, hash_ms = 0.0;
+        size_t legacy_bytes = measure_peak_bytes([&] {
+            legacy_ms = measure_ms([&] { legacy = legacy_edges(faces, vertex_count); });
+        });
+        size_t hash_bytes = measure_peak_bytes([&] {
+            hash_ms = measure_ms([&] { edges = s21::EdgeList::build(faces, vertex_count); });
+        });
+        size_t sides = faces.index_data().size();
+        std::cout << "edges on " << faces.size() << " faces (" << sides << " sides):" << std::endl;
+        std::cout << "  legacy sort (no closing edges): " << legacy.size() / 2 << " edges, "
+                  << legacy_ms << " ms, peak " << legacy_bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "  EdgeList hash:                  " << edges.size() / 2 << " edges, "
+                  << hash_ms << " ms, peak " << hash_bytes / (1024.0 * 1024.0) << " MB, result "
+                  << edges.size() * sizeof(uint32_t) / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+
+    // Построение, пересчет и запросы иерархии объемов против перебора граней
+    void benchmark_bvh(const char* filename){
+        s21::Model md;
+        md.read_file(filename);
+        s21::MeshView view = md.view();
+        const s21::FaceList& faces = md.get_faces();
+        std::cout << "BVH over " << faces.size() << " faces:" << std::endl;
+        s21::MeshBvh bvh;
+        double serial_ms = measure_ms([&] {
+            bvh.build(view.vertices.data(), view.vertices.size(), faces, 1);
+        });
+        double parallel_ms = measure_ms([&] {
+            bvh.build(view.vertices.data(), view.vertices.size(), faces);
+        });
+        double refit_ms = measure_ms([&] {
+            bvh.refit(view.vertices.data(), view.vertices.size(), faces);
+        });
+        std::cout << "  build: " << serial_ms << " ms (1 thread), " << parallel_ms
+                  << " ms (pool); refit " << refit_ms << " ms; "
+                  << bvh.get_nodes().size() << " nodes" << std::endl;
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> spread(-1.0f, 1.0f);
+        const int rays = 10000;
+        int hits = 0;
+        s21::MeshBvh::Hit hit;
+        double pick_ms = measure_ms([&] {
+            for(int i = 0; i < rays; ++i){
+                glm::vec3 origin(spread(rng), spread(rng), 3.0f);
+                hits += bvh.ray_pick(view.vertices.data(), view.vertices.size(), faces,
+                                     origin, glm::vec3(0.0f, 0.0f, -1.0f), hit);
+            }
+        });
+        // Перебор: каждая грань проверяется на попадание луча
+        const int brute_rays = 10;
+        volatile float sink = 0.0f;
+        double brute_ms = measure_ms([&] {
+            for(int i = 0; i < brute_rays; ++i){
+                glm::vec3 origin(spread(rng), spread(rng), 3.0f);
+                glm::vec3 direction(0.0f, 0.0f, -1.0f);
+                float best = std::numeric_limits<float>::infinity();
+                for(const auto face : faces){
+                    glm::vec3 a = view.vertices[face[0]];
+                    glm::vec3 ab = view.vertices[face[1]] - a;
+                    glm::vec3 ac = view.vertices[face[2]] - a;
+                    glm::vec3 p = glm::cross(direction, ac);
+                    float det = glm::dot(ab, p);
+                    glm::vec3 d = origin - a;
+                    float u = glm::dot(d, p) / det;
+                    glm::vec3 q = glm::cross(d, ab);
+                    float v = glm::dot(direction, q) / det;
+                    float t = glm::dot(ac, q) / det;
+                    if(u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < best){
+                        best = t;
+                    }
+                }
+                sink = sink + best;
+            }
+        });
+        std::cout << "  ray pick: " << pick_ms * 1000.0 / rays << " us/ray (" << hits << "/"
+                  << rays << " hit), brute force " << brute_ms * 1000.0 / brute_rays
+                  << " us/ray" << std::endl;
+
+        glm::vec4 planes[6];
+        std::vector<uint32_t> selected;
+        const int boxes = 1000;
+        double box_ms = measure_ms([&] {
+            for(int i = 0; i < boxes; ++i){
+                glm::vec3 corner(spread(rng), spread(rng), -1.0f);
+                s21::MeshBvh::box_planes(corner, corner + glm::vec3(0.1f, 0.1f, 2.0f), planes);
+                selected.clear();
+                bvh.query(view.vertices.data(), view.vertices.size(), faces, planes, 6, selected);
+            }
+        });
+        glm::mat4 clip = glm::perspective(glm::radians(30.0f), 1.0f, 0.1f, 100.0f) *
+                         glm::lookAt(glm::vec3(0.5f, 0.5f, 3.0f), glm::vec3(0.5f, 0.5f, 0.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+        s21::MeshBvh::frustum_planes(clip, planes);
+        selected.clear();
+        double frustum_ms = measure_ms([&] {
+            bvh.query(view.vertices.data(), view.vertices.size(), faces, planes, 6, selected);
+        });
+        std::cout << "  box query (0.1 x 0.1): " << box_ms * 1000.0 / boxes << " us; frustum query: "
+                  << frustum_ms << " ms, " << selected.size() << " faces" << std::endl;
+    }
+
+    // Уровни детализации: время построения и размер каждого уровня
+    void benchmark_lod(const char* filename){
+        s21::Model md;
+        md.read_file(filename);
+        const std::vector<uint32_t>& edges = md.get_edges();
+        std::vector<glm::vec3> vertices(md.vertices_begin(), md.vertices_end());
+        std::cout << "LOD from " << vertices.size() << " vertices, " << edges.size() / 2 << " edges:" << std::endl;
+        s21::MeshLod::Settings settings;
+        for(unsigned resolution : settings.resolutions){
+            s21::LodLevel level;
+            double ms = measure_ms([&] {
+                level = s21::MeshLod::cluster(vertices.data(), vertices.size(), edges, resolution);
+            });
+            std::cout << "  grid " << resolution << ": " << level.vertices.size() << " vertices, "
+                      << level.edges.size() / 2 << " edges, " << ms << " ms" << std::endl;
+        }
+        double all_ms = measure_ms([&] { md.build_lods(); });
+        std::cout << "  all levels in parallel: " << all_ms << " ms" << std::endl;
+    }
+
+    // Повторные загрузки файла: новая модель на каждую загрузку против
+    // модели, забирающей память предыдущей (Model::recycle) и общих буферов
+    // параллельного разбора. Загрузка включает построение кусков каркаса,
+    // как в Controller::loadModel; выгрузка - уничтожение модели или
+    // передача ее памяти следующей загрузке
+    void benchmark_reload(const char* filename, size_t threads){
+        const int loads = 4;
+        std::cout << "reload x" << loads << ", threads " << threads << ":" << std::endl;
+        for(bool reuse : {false, true}){
+            s21::Model spare;
+            s21::ObjParser::Scratch scratch;
+            double load_ms = 0.0, unload_ms = 0.0;
+            size_t allocations = 0, bytes = 0;
+            for(int i = 0; i < loads; ++i){
+                size_t count_before = allocation_count.load();
+                size_t bytes_before = allocated_bytes.load();
+                auto md = std::make_unique<s21::Model>();
+                md->set_load_threads(threads);
+                double load = measure_ms([&] {
+                    if(reuse){
+                        md->recycle(spare);
+                        md->set_parse_scratch(&scratch);
+                    }
+                    md->read_file(filename);
+                    md->get_chunks();
+                });
+                double unload = measure_ms([&] {
+                    if(reuse){
+                        spare.recycle(*md);
+                    }
+                    md.reset();
+                });
+                // Первая загрузка (для пула - его заполнение) не считается
+                if(i != 0){
+                    load_ms += load;
+                    unload_ms += unload;
+                    allocations += allocation_count.load() - count_before;
+                    bytes += allocated_bytes.load() - bytes_before;
+                }
+            }
+            std::cout << "  " << (reuse ? "recycled buffers" : "new model each ") << ": load "
+                      << load_ms / (loads - 1) << " ms, unload " << unload_ms / (loads - 1) << " ms, "
+                      << allocations / (loads - 1) << " allocations ("
+                      << bytes / (loads - 1) / (1024.0 * 1024.0) << " MB) per reload" << std::endl;
+        }
+    }
+
+    size_t file_size(const char* filename){
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        return file ? static_cast<size_t>(file.tellg()) : 0;
+    }
+} // namespace
+
+int main(int argc, char** argv){
+    const char* filename = "bench_grid.obj";
+    if(argc > 1){
+        filename = argv[1];
+    } else {
+        generate_obj(filename, 1000);
+    }
+    double megabytes = file_size(filename) / (1024.0 * 1024.0);
+
+    std::vector<glm::vec3> legacy_vertices;
+    Faces legacy_faces;
+    double legacy_ms = measure_ms([&] { legacy_parse(filename, legacy_vertices, legacy_faces); });
+
+    std::vector<glm::vec3> vertices;
+    s21::FaceList faces;
+    double parser_ms = measure_ms([&] { s21::ObjParser().parse_file(filename, vertices, faces); });
+
+    s21::Model md;
+    double model_ms = measure_ms([&] { md.read_file(filename); });
+
+    bool same = legacy_vertices == vertices && same_faces(legacy_faces, faces);
+
+    std::cout << filename << ": " << megabytes << " MB, " << vertices.size()
+              << " vertices, " << faces.size() << " faces" << std::endl;
+    std::cout << "legacy getline/stringstream: " << legacy_ms << " ms ("
+              << megabytes / legacy_ms * 1000.0 << " MB/s)" << std::endl;
+    std::cout << "mmap ObjParser:              " << parser_ms << " ms ("
+              << megabytes / parser_ms * 1000.0 << " MB/s)" << std::endl;
+    std::cout << "Model::read_file (with normalization): " << model_ms << " ms" << std::endl;
+    std::cout << "results identical: " << (same ? "yes" : "NO") << std::endl;
+    std::cout << "faces memory: nested vectors " << nested_bytes(legacy_faces) / (1024.0 * 1024.0)
+              << " MB, CSR " << faces.memory_bytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    // Повторная загрузка из двоичного кэша
+    {
+        s21::MeshCache cache("bench_cache");
+        cache.store(filename, md);
+        s21::Model cached;
+        bool hit = false;
+        double cache_ms = measure_ms([&] { hit = cache.load(filename, cached); });
+        bool cache_same = hit && std::equal(md.vertices_begin(), md.vertices_end(), cached.vertices_begin()) &&
+                          md.get_faces() == cached.get_faces();
+        same = same && cache_same;
+        std::cout << "MeshCache::load:             " << cache_ms << " ms"
+                  << (cache_same ? "" : " MISMATCH") << std::endl;
+        std::remove(cache.cache_path(filename).c_str());
+        std::remove("bench_cache");
+    }
+
+    // Масштабирование параллельной загрузки от 1 до N потоков
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    if(argc > 2){
+        max_threads = std::max(1ul, std::stoul(argv[2]));
+    }
+    for(size_t threads = 1; ; threads = std::min(threads * 2, max_threads)){
+        std::vector<glm::vec3> scaled_vertices;
+        s21::FaceList scaled_faces;
+        s21::ObjParser parser;
+        parser.set_threads(threads);
+        double ms = measure_ms([&] { parser.parse_file(filename, scaled_vertices, scaled_faces); });
+        bool scaled_same = scaled_vertices == vertices && scaled_faces == faces;
+        same = same && scaled_same;
+        std::cout << "threads " << threads << ": " << ms << " ms ("
+                  << megabytes / ms * 1000.0 << " MB/s)"
+                  << (scaled_same ? "" : " MISMATCH") << std::endl;
+        if(threads == max_threads){
+            break;
+        }
+    }
+
+    // Время до первой порции при потоковой загрузке против полной загрузки
+    {
+        s21::LoadStream stream;
+        s21::LoadStream::Batch batch;
+        auto start = std::chrono::steady_clock::now();
+        double first_ms = -1.0;
+        stream.set_callback([&] {
+            if(first_ms < 0.0){
+                first_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+            }
+            stream.take(batch);
+        });
+        s21::Model streamed;
+        streamed.read_file(filename, nullptr, &stream);
+        double total_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "streaming: first batch " << first_ms << " ms, full model "
+                  << total_ms << " ms" << std::endl;
+    }
+
+    benchmark_reload(filename, 1);
+    benchmark_reload(filename, std::max<size_t>(max_threads, 4));
+    benchmark_parallel_rotate(filename, max_threads);
+    benchmark_edges(708);
+    benchmark_lod(filename);
+    benchmark_bvh(filename);
+    benchmark_kernels(10000000);
+    benchmark_layouts(1000000);
+    benchmark_layouts(10000000);
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+#include "mesh_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace s21 {
+
+    namespace {
+        // Буферизованная запись текста OBJ: printf на каждое число слишком
+        // медленный для сеток в десятки миллионов строк
+        class ObjWriter {
+            public:
+                explicit ObjWriter(std::FILE* file) : file(file) { buffer.reserve(kCapacity); }
+
+                ~ObjWriter(){ flush(); }
+
+                void vertex(float x, float y, float z){
+                    char line[96];
+                    int length = std::snprintf(line, sizeof(line), "v %.6g %.6g %.6g\n", x, y, z);
+                    append(line, static_cast<size_t>(length));
+                }
+
+                void face(const size_t* indices, size_t count){
+                    append("f", 1);
+                    for(size_t i = 0; i < count; ++i){
+                        char digits[24];
+                        char* end = digits + sizeof(digits);
+                        char* begin = end;
+                        size_t value = indices[i];
+                        do {
+                            *--begin = static_cast<char>('0' + value % 10);
+                            value /= 10;
+                        } while(value != 0);
+                        *--begin = ' ';
+                        append(begin, static_cast<size_t>(end - begin));
+                    }
+                    append("\n", 1);
+                }
+
+                void flush(){
+                    good = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size() && good;
+                    written += buffer.size();
+                    buffer.clear();
+                }
+
+                size_t bytes() const { return written + buffer.size(); }
+
+                bool ok() const { return good; }
+
+            private:
+                static constexpr size_t kCapacity = 1 << 20;
+
+                void append(const char* text, size_t length){
+                    if(buffer.size() + length > kCapacity){
+                        flush();
+                    }
+                    buffer.insert(buffer.end(), text, text + length);
+                }
+
+                std::FILE* file; // Файл OBJ
+                std::vector<char> buffer; // Еще не записанный текст
+                size_t written = 0; // Записано байт
+                bool good = true; // Все записи удались
+        };
+
+        // Перестановка [0, n) умножением на взаимно простое с n число: без
+        // памяти под таблицу и одинаковая при каждом запуске
+        class Permutation {
+            public:
+                explicit Permutation(size_t n) : n(n){
+                    factor = static_cast<size_t>(n * 0.6180339887) | 1;
+                    while(gcd(factor, n) != 1){
+                        factor += 2;
+                    }
+                    factor %= n;
+                    // Обратный множитель по расширенному алгоритму Евклида
+                    long long r = static_cast<long long>(n), next_r = static_cast<long long>(factor);
+                    long long t = 0, next_t = 1;
+                    while(next_r != 0){
+                        long long q = r / next_r;
+                        long long rest = r - q * next_r;
+                        r = next_r;
+                        next_r = rest;
+                        long long coefficient = t - q * next_t;
+                        t = next_t;
+                        next_t = coefficient;
+                    }
+                    long long size = static_cast<long long>(n);
+                    inverse_factor = static_cast<size_t>((t % size + size) % size);
+                }
+
+                // Элемент на позиции position
+                size_t operator()(size_t position) const { return mul(position, factor); }
+
+                // Позиция элемента value
+                size_t position(size_t value) const { return mul(value, inverse_factor); }
+
+            private:
+                static size_t gcd(size_t a, size_t b){
+                    while(b != 0){
+                        a %= b;
+                        std::swap(a, b);
+                    }
+                    return a;
+                }
+
+                // Сетки замеров меньше 2^32 вершин, произведение помещается в 64 бита
+                size_t mul(size_t a, size_t b) const { return static_cast<size_t>(uint64_t(a) * b % n); }
+
+                size_t n; // Размер перестановки
+                size_t factor = 1; // Множитель
+                size_t inverse_factor = 1; // Обратный множитель по модулю n
+        };
+    } // namespace
+
+    bool MeshGenerator::write_obj(const std::string& filename, size_t vertices, Arity arity, Info& info,
+                                  bool scattered){
+        std::FILE* file = std::fopen(filename.c_str(), "wb");
+        if(file == nullptr){
+            return false;
+        }
+        size_t side = std::max<size_t>(2, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(vertices)))));
+        info = Info();
+        bool ok = false;
+        {
+            ObjWriter writer(file);
+            float step = 2.0f / (side - 1);
+            Permutation vertex_order(scattered ? side * side : 1);
+            for(size_t k = 0; k < side * side; ++k){
+                size_t v = scattered ? vertex_order(k) : k;
+                size_t i = v / side;
+                size_t j = v % side;
+                float x = i * step - 1.0f;
+                float y = j * step - 1.0f;
+                writer.vertex(x, y, 0.1f * std::sin(i * 0.05f) * std::cos(j * 0.07f));
+            }
+            info.vertices = side * side;
+
+            // Вершина (i, j) в файле имеет номер i * side + j + 1 (в
+            // перемешанном файле - позицию в перестановке плюс один)
+            auto index = [&](size_t i, size_t j){
+                return (scattered ? vertex_order.position(i * side + j) : i * side + j) + 1;
+            };
+            Permutation row_order(scattered ? side - 1 : 1);
+            for(size_t row = 0; row + 1 < side; ++row){
+                size_t i = scattered ? row_order(row) : row;
+                for(size_t j = 0; j + 1 < side;){
+                    size_t cells = 1;
+                    size_t pattern = arity == Arity::kTriangles ? 0 : arity == Arity::kQuads ? 1 : j % 4;
+                    if(pattern == 0){
+                        const size_t first[] = {index(i, j), index(i, j + 1), index(i + 1, j + 1)};
+                        const size_t second[] = {index(i, j), index(i + 1, j + 1), index(i + 1, j)};
+                        writer.face(first, 3);
+                        writer.face(second, 3);
+                        info.faces += 2;
+                    } else if(pattern == 2 && j + 2 < side){
+                        // Шестиугольник над двумя соседними ячейками
+                        const size_t hexagon[] = {index(i, j), index(i, j + 1), index(i, j + 2),
+                                                  index(i + 1, j + 2), index(i + 1, j + 1), index(i + 1, j)};
+                        writer.face(hexagon, 6);
+                        ++info.faces;
+                        cells = 2;
+                    } else {
+                        const size_t quad[] = {index(i, j), index(i, j + 1), index(i + 1, j + 1), index(i + 1, j)};
+                        writer.face(quad, 4);
+                        ++info.faces;
+                    }
+                    j += cells;
+                }
+            }
+            writer.flush();
+            info.bytes = writer.bytes();
+            ok = writer.ok();
+        }
+        return std::fclose(file) == 0 && ok;
+    }
+
+    const char* MeshGenerator::arity_name(Arity arity){
+        switch(arity){
+            case Arity::kTriangles:
+                return "tri";
+            case Arity::kQuads:
+                return "quad";
+            case Arity::kMixed:
+                return "mixed";
+        }
+        return "";
+    }
+
+    bool MeshGenerator::parse_arity(const std::string& name, Arity& arity){
+        for(Arity candidate : {Arity::kTriangles, Arity::kQuads, Arity::kMixed}){
+            if(name == arity_name(candidate)){
+                arity = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace s21
@@ -0,0 +1,70 @@
+#ifndef SRC_BENCHMARKS_MESH_GENERATOR_H
+#define SRC_BENCHMARKS_MESH_GENERATOR_H
+#include <cstddef>
+#include <string>
+
+namespace s21 {
+    /**
+     * @brief Процедурные сетки для замеров.
+     *
+     * Сетка - это волнистая поверхность side x side вершин, где side -
+     * наименьшее целое с side^2 >= заданного числа вершин. Ячейки сетки
+     * закрываются гранями выбранного вида. Сетка зависит только от размера
+     * и вида граней, поэтому разные запуски замеряют одни и те же файлы.
+     */
+    class MeshGenerator {
+        public:
+            /**
+             * @brief Вид граней сетки.
+             */
+            enum class Arity {
+                kTriangles, // Два треугольника на ячейку
+                kQuads, // Четырехугольник на ячейку
+                kMixed // По строке чередуются треугольники, четырехугольники и шестиугольники
+            };
+
+            /**
+             * @brief Сведения о записанной сетке.
+             */
+            struct Info {
+                size_t vertices = 0; // Число вершин
+                size_t faces = 0; // Число граней
+                size_t bytes = 0; // Размер файла
+            };
+
+            /**
+             * @brief Записывает сетку в файл OBJ.
+             *
+             * В перемешанном файле та же сетка, но вершины идут в порядке
+             * псевдослучайной перестановки, а строки граней - в
+             * перемешанном порядке строк сетки, как в выгрузках сканеров.
+             *
+             * @param filename Имя файла.
+             * @param vertices Желаемое число вершин.
+             * @param arity Вид граней.
+             * @param info Сведения о записанной сетке.
+             * @param scattered true, чтобы перемешать вершины и грани.
+             * @return true, если файл записан.
+             */
+            static bool write_obj(const std::string& filename, size_t vertices, Arity arity, Info& info,
+                                  bool scattered = false);
+
+            /**
+             * @brief Стабильное имя вида граней.
+             *
+             * @param arity Вид граней.
+             * @return "tri", "quad" или "mixed".
+             */
+            static const char* arity_name(Arity arity);
+
+            /**
+             * @brief Вид граней по имени.
+             *
+             * @param name Имя из arity_name.
+             * @param arity Найденный вид граней.
+             * @return true, если имя известно.
+             */
+            static bool parse_arity(const std::string& name, Arity& arity);
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,187 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../model/edge_list.h"
+#include "../model/mesh_bvh.h"
+#include "../model/mesh_chunks.h"
+#include "../model/mesh_lod.h"
+#include "../model/mesh_reorder.h"
+#include "../model/mesh_weld.h"
+#include "../model/model.h"
+#include "../model/obj_parser.h"
+#include "../model/quantized_vertices.h"
+#include "../model/thread_pool.h"
+#include "../model/vertex_kernels.h"
+#include "bench_report.h"
+#include "mesh_generator.h"
+
+// Замеры загрузки, преобразований и производных структур модели на
+// процедурных сетках. Отчет в JSON; имена замеров вида
+// "load/read_file/tri/1m" не меняются между сборками.
+
+namespace {
+
+    // Замеры одной сетки: загрузка, преобразования вершин и построение
+    // ребер, дерева граней, кусков и уровней детализации
+    void benchmark_mesh(s21::BenchReport& report, const std::string& filename, const std::string& suffix,
+                        const s21::MeshGenerator::Info& info, size_t runs){
+        s21::BenchReport::Counters counters{{"vertices", static_cast<double>(info.vertices)},
+                                            {"faces", static_cast<double>(info.faces)}};
+        s21::BenchReport::Counters file_counters = counters;
+        file_counters.emplace_back("bytes", static_cast<double>(info.bytes));
+
+        report.measure("load/parse" + suffix, runs, [&] {
+            std::vector<glm::vec3> vertices;
+            s21::FaceList faces;
+            s21::ObjParser().parse_file(filename.c_str(), vertices, faces);
+        }, file_counters);
+        report.measure("load/read_file" + suffix, runs, [&] {
+            s21::Model model;
+            model.read_file(filename.c_str());
+        }, file_counters);
+
+        s21::Model model;
+        model.read_file(filename.c_str());
+        report.measure("transform/normalization" + suffix, runs, [&] { model.normalization(); }, counters);
+        report.measure("transform/rotate" + suffix, runs, [&] {
+            model.rotate(1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        }, counters);
+        report.measure("transform/scale" + suffix, runs, [&] { model.scale(1.001f); }, counters);
+        report.measure("transform/translate" + suffix, runs, [&] {
+            model.translate(glm::vec3(0.001f, 0.0f, 0.0f));
+        }, counters);
+        // Поворот по трем осям, масштаб и сдвиг одним проходом по вершинам
+        float angle = 0.0f;
+        report.measure("transform/apply" + suffix, runs, [&] {
+            s21::TransformQueue queue;
+            angle += 1.0f;
+            queue.set_rotation(angle, glm::vec3(1.0f, 0.0f, 0.0f));
+            queue.set_rotation(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+            queue.set_rotation(angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            queue.scale(1.001f);
+            queue.set_position(glm::vec3(angle * 0.001f, 0.0f, 0.0f));
+            model.apply(queue.take());
+        }, counters);
+
+        s21::MeshView view = model.view();
+        const glm::vec3* vertices = view.vertices.data();
+        size_t count = view.vertices.size();
+        const s21::FaceList& faces = *view.faces;
+        std::vector<uint32_t> edges;
+        report.measure("derive/edges" + suffix, runs, [&] { edges = s21::EdgeList::build(faces, count); },
+                       counters);
+        report.measure("derive/bvh" + suffix, runs, [&] {
+            s21::MeshBvh bvh;
+            bvh.build(vertices, count, faces);
+        }, counters);
+        report.measure("derive/chunks" + suffix, runs, [&] {
+            s21::MeshChunks chunks;
+            chunks.build(vertices, count, edges);
+        }, counters);
+        report.measure("derive/lod" + suffix, runs, [&] {
+            s21::MeshLod::build(vertices, count, edges, s21::MeshLod::Settings());
+        }, counters);
+        report.measure("derive/quantize" + suffix, runs, [&] {
+            s21::QuantizedVertices quantized;
+            quantized.assign(vertices, count);
+        }, counters);
+        // Сварка копии (с копированием): в сгенерированной сетке повторов
+        // нет, поэтому это цена прохода, когда сваривать нечего
+        report.measure("derive/weld" + suffix, runs, [&] {
+            std::vector<glm::vec3> welded(vertices, vertices + count);
+            s21::FaceList welded_faces = faces;
+            s21::MeshWeld::compact(welded, welded_faces, 1e-6f);
+        }, counters);
+
+        // В режиме матрицы преобразование не трогает вершины
+        model.set_transform_mode(s21::TransformMode::kMatrix);
+        report.measure("transform/rotate_matrix" + suffix, runs, [&] {
+            model.rotate(1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        }, counters);
+    }
+
+    // Замеры той же сетки с вершинами и гранями вразброс (см.
+    // MeshGenerator::write_obj) до и после MeshReorder: проходы по граням
+    // и ребрам читают вершины по индексам, поворот вершин идет подряд
+    void benchmark_locality(s21::BenchReport& report, const std::string& filename, const std::string& suffix,
+                            const s21::MeshGenerator::Info& info, size_t runs){
+        s21::BenchReport::Counters counters{{"vertices", static_cast<double>(info.vertices)},
+                                            {"faces", static_cast<double>(info.faces)}};
+        s21::Model scattered;
+        scattered.read_file(filename.c_str());
+        s21::Model reordered;
+        reordered.read_file(filename.c_str());
+        s21::MeshReorder::Stats stats = reordered.optimize_locality();
+        s21::BenchReport::Counters reorder_counters = counters;
+        reorder_counters.emplace_back("acmr_before", stats.acmr_before);
+        reorder_counters.emplace_back("acmr_after", stats.acmr_after);
+        // Проход на копии (с копированием)
+        s21::MeshView view = scattered.view();
+        report.measure("locality/reorder" + suffix, runs, [&] {
+            std::vector<glm::vec3> vertices(view.vertices.data(), view.vertices.data() + view.vertices.size());
+            s21::FaceList faces = *view.faces;
+            s21::MeshReorder::optimize(vertices, faces);
+        }, reorder_counters);
+
+        for(auto* model : {&scattered, &reordered}){
+            std::string order = model == &scattered ? "scattered" : "reordered";
+            model->get_chunks();
+            model->get_bvh();
+            report.measure("locality/edges_" + order + suffix, runs, [&] {
+                s21::EdgeList::build(model->get_faces(), model->vertices_size());
+            }, counters);
+            // Поворот и то, что после него пересчитывает кадр: параллелепипеды
+            // кусков и дерева граней
+            float angle = 0.0f;
+            report.measure("locality/rotate_refit_" + order + suffix, runs, [&] {
+                angle += 1.0f;
+                model->rotate(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+                model->get_chunks();
+                model->get_bvh();
+            }, counters);
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv){
+    s21::BenchOptions options;
+    std::string error;
+    if(!options.parse(argc, argv, error)){
+        std::cerr << error << std::endl;
+        return 2;
+    }
+    s21::BenchReport report("model");
+    report.set_info("threads", std::to_string(s21::ThreadPool::shared().size()));
+    report.set_info("isa", s21::VertexKernels::isa_name(s21::VertexKernels::isa()));
+    report.set_info("compiler", __VERSION__);
+
+    for(size_t size : options.sizes){
+        for(s21::MeshGenerator::Arity arity : options.arities){
+            std::string suffix = std::string("/") + s21::MeshGenerator::arity_name(arity) + "/" +
+                                 s21::BenchOptions::size_name(size);
+            std::string filename = options.work_dir + "/bench_" + s21::MeshGenerator::arity_name(arity) + "_" +
+                                   s21::BenchOptions::size_name(size) + ".obj";
+            s21::MeshGenerator::Info info;
+            if(!s21::MeshGenerator::write_obj(filename, size, arity, info)){
+                std::cerr << "cannot write " << filename << std::endl;
+                std::remove(filename.c_str());
+                return 1;
+            }
+            size_t runs = options.runs_for(info.vertices);
+            std::cerr << "model" << suffix << ": " << info.vertices << " vertices, " << info.faces
+                      << " faces, " << runs << " runs" << std::endl;
+            benchmark_mesh(report, filename, suffix, info, runs);
+            std::remove(filename.c_str());
+            if(!s21::MeshGenerator::write_obj(filename, size, arity, info, true)){
+                std::cerr << "cannot write " << filename << std::endl;
+                std::remove(filename.c_str());
+                return 1;
+            }
+            benchmark_locality(report, filename, suffix, info, runs);
+            std::remove(filename.c_str());
+        }
+    }
+    return report.save(options.output) ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+#include <QApplication>
+#include <QEventLoop>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QSurfaceFormat>
+#include <cstdio>
+#include <iostream>
+
+#include "../3dViewer/widgetgl.h"
+#include "bench_report.h"
+#include "mesh_generator.h"
+
+// Замеры отрисовки через WidgetGL без экрана. По умолчанию Qt рисует в
+// offscreen-поверхность; с LIBGL_ALWAYS_SOFTWARE=1 кадры считает Mesa
+// (llvmpipe), и результаты не зависят от видеокарты машины.
+
+namespace {
+
+constexpr int kWidth = 1280;
+constexpr int kHeight = 720;
+constexpr int kFrames = 60;
+
+// Загружает модель и ждет конца загрузки (вместе с деревом граней и
+// уровнями детализации)
+bool loadAndWait(s21::WidgetGL& widget, const std::string& filename) {
+  bool ok = false;
+  QEventLoop loop;
+  QObject::connect(&widget, &s21::WidgetGL::loadFinished, &loop,
+                   [&](bool result) {
+                     ok = result;
+                     loop.quit();
+                   });
+  widget.loadModel(filename);
+  loop.exec();
+  return ok;
+}
+
+// Рисует kFrames кадров; время кадра - paintGL вместе с чтением кадра,
+// процентили paintGL и видеокарты - из замеров WidgetGL
+void renderFrames(s21::BenchReport& report, s21::WidgetGL& widget,
+                  const std::string& name, bool rotate,
+                  s21::BenchReport::Counters counters) {
+  // Первый кадр загружает модель в видеопамять
+  widget.grabFramebuffer();
+  widget.clearFrameStats();
+  std::vector<double> times;
+  for (int frame = 0; frame < kFrames; ++frame) {
+    // Угол абсолютный: каждый кадр задает новый
+    if (rotate) {
+      widget.setRotation(frame + 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    times.push_back(
+        s21::BenchReport::measure_ms([&] { widget.grabFramebuffer(); }));
+  }
+  const s21::FrameStats& stats = widget.getFrameStats();
+  s21::FrameStats::Summary summary = stats.summarize();
+  counters.emplace_back("paint_p50_ms", summary.cpu_p50);
+  counters.emplace_back("paint_p95_ms", summary.cpu_p95);
+  counters.emplace_back("paint_p99_ms", summary.cpu_p99);
+  counters.emplace_back("gpu_frames", static_cast<double>(summary.gpu_frames));
+  counters.emplace_back("gpu_p50_ms", summary.gpu_p50);
+  counters.emplace_back("gpu_p95_ms", summary.gpu_p95);
+  counters.emplace_back("edges_submitted",
+                        static_cast<double>(stats.last().edges));
+  counters.emplace_back("points_submitted",
+                        static_cast<double>(stats.last().points));
+  report.add(name, std::move(times), counters);
+}
+
+// Сведения о контексте OpenGL для отчета
+bool describeContext(s21::BenchReport& report, s21::WidgetGL& widget) {
+  widget.grabFramebuffer();
+  if (!widget.context() || !widget.context()->isValid()) return false;
+  widget.makeCurrent();
+  QOpenGLFunctions* gl = widget.context()->functions();
+  auto text = [gl](GLenum name) {
+    const GLubyte* value = gl->glGetString(name);
+    return value ? std::string(reinterpret_cast<const char*>(value))
+                 : std::string();
+  };
+  report.set_info("gl_vendor", text(GL_VENDOR));
+  report.set_info("gl_renderer", text(GL_RENDERER));
+  report.set_info("gl_version", text(GL_VERSION));
+  widget.doneCurrent();
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  // Тот же контекст, что у приложения: профиль совместимости 3.3
+  QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+  format.setVersion(3, 3);
+  format.setProfile(QSurfaceFormat::CompatibilityProfile);
+  QSurfaceFormat::setDefaultFormat(format);
+  QApplication app(argc, argv);
+
+  s21::BenchOptions options;
+  std::string error;
+  if (!options.parse(argc, argv, error)) {
+    std::cerr << error << std::endl;
+    return 2;
+  }
+  s21::BenchReport report("render");
+  report.set_info("platform", QApplication::platformName().toStdString());
+  report.set_info("viewport", std::to_string(kWidth) + "x" +
+                                  std::to_string(kHeight));
+
+  s21::WidgetGL widget;
+  widget.setStreaming(false);
+  // Каждая загрузка замеряет разбор файла, а не чтение из кэша
+  widget.setCacheDirectory("");
+  widget.resize(kWidth, kHeight);
+  widget.show();
+  if (!describeContext(report, widget)) {
+    std::cerr << "no OpenGL context on platform "
+              << QApplication::platformName().toStdString() << std::endl;
+    return 1;
+  }
+
+  for (size_t size : options.sizes) {
+    for (s21::MeshGenerator::Arity arity : options.arities) {
+      std::string suffix = std::string("/") +
+                           s21::MeshGenerator::arity_name(arity) + "/" +
+                           s21::BenchOptions::size_name(size);
+      std::string filename = options.work_dir + "/bench_render_" +
+                             s21::MeshGenerator::arity_name(arity) + "_" +
+                             s21::BenchOptions::size_name(size) + ".obj";
+      s21::MeshGenerator::Info info;
+      bool ok = s21::MeshGenerator::write_obj(filename, size, arity, info);
+      double load_ms = 0.0;
+      if (ok) {
+        load_ms = s21::BenchReport::measure_ms(
+            [&] { ok = loadAndWait(widget, filename); });
+      }
+      std::remove(filename.c_str());
+      if (!ok) {
+        std::cerr << "cannot load " << filename << std::endl;
+        return 1;
+      }
+      std::cerr << "render" << suffix << ": " << info.vertices
+                << " vertices, " << info.faces << " faces" << std::endl;
+      s21::BenchReport::Counters counters{
+          {"vertices", static_cast<double>(info.vertices)},
+          {"faces", static_cast<double>(info.faces)}};
+      report.add("render/load" + suffix, {load_ms}, counters);
+
+      widget.setVertexType(0);
+      renderFrames(report, widget, "render/static" + suffix, false, counters);
+      widget.setVertexType(2);
+      renderFrames(report, widget, "render/static_points" + suffix, false,
+                   counters);
+      widget.setVertexType(0);
+      // Те же кадры со сжатыми вершинами в видеопамяти
+      widget.setQuantizedVertices(true);
+      renderFrames(report, widget, "render/static_quantized" + suffix, false,
+                   counters);
+      widget.setQuantizedVertices(false);
+      // Во время вращения рисуется уровень детализации
+      renderFrames(report, widget, "render/rotate" + suffix, true, counters);
+
+      // Та же сетка вразброс, как у сканеров, без перестановки и с ней
+      ok = s21::MeshGenerator::write_obj(filename, size, arity, info, true);
+      for (bool reorder : {false, true}) {
+        widget.setOptimizeLocality(reorder);
+        ok = ok && loadAndWait(widget, filename);
+        if (!ok) break;
+        std::string order = reorder ? "reordered" : "scattered";
+        renderFrames(report, widget, "render/static_" + order + suffix, false,
+                     counters);
+        renderFrames(report, widget, "render/rotate_" + order + suffix, true,
+                     counters);
+      }
+      widget.setOptimizeLocality(false);
+      std::remove(filename.c_str());
+      if (!ok) {
+        std::cerr << "cannot load " << filename << std::endl;
+        return 1;
+      }
+    }
+  }
+  return report.save(options.output) ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+QT       += core gui opengl
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+greaterThan(QT_MAJOR_VERSION, 5): QT += openglwidgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = render_benchmark
+
+LIBS += -lglut -lGLU -lGL
+
+SOURCES += \
+    render_benchmark.cpp \
+    bench_report.cpp \
+    mesh_generator.cpp \
+    ../model/model.cpp \
+    ../model/mapped_file.cpp \
+    ../model/edge_list.cpp \
+    ../model/frame_stats.cpp \
+    ../model/load_stream.cpp \
+    ../model/mesh_bvh.cpp \
+    ../model/mesh_cache.cpp \
+    ../model/mesh_chunks.cpp \
+    ../model/mesh_lod.cpp \
+    ../model/mesh_reorder.cpp \
+    ../model/mesh_weld.cpp \
+    ../model/obj_parser.cpp \
+    ../model/ply_parser.cpp \
+    ../model/quantized_vertices.cpp \
+    ../model/stl_parser.cpp \
+    ../model/thread_pool.cpp \
+    ../model/vertex_kernels.cpp \
+    ../controller/controller.cpp \
+    ../3dViewer/meshrenderer.cpp \
+    ../3dViewer/widgetgl.cpp
+
+HEADERS += \
+    bench_report.h \
+    mesh_generator.h \
+    ../3dViewer/meshrenderer.h \
+    ../3dViewer/widgetgl.h
@@ -1,5 +1,7 @@
 #include "controller.h"
 
+#include "../model/mapped_file.h"
+
 namespace s21 {
 
 void Controller::setPossition(const glm::vec3 &newPosition) {
@@ -13,7 +15,76 @@ void Controller::setRotation(float angle, glm::vec3 axis) {
 void Controller::setScale(float scale) { model.scale(scale); }
 
 void Controller::loadModel(const std::string &filename) {
-  model.read_file(filename.c_str());
+  Model loaded = prepareModel();
+  if (loadModel(filename, loaded, nullptr)) swapModel(loaded);
+  recycleModel(loaded);
+}
+
+Model Controller::prepareModel() {
+  Model prepared = model.empty_copy();
+  prepared.recycle(spare);
+  return prepared;
+}
+
+void Controller::releaseBuffers() {
+  spare = Model();
+  std::lock_guard<std::mutex> lock(scratch_mutex);
+  parse_scratch = ObjParser::Scratch();
+}
+
+bool Controller::loadModel(const std::string &filename, Model &target,
+                           LoadProgress *progress, LoadStream *stream) {
+  if (cache.load(filename, target)) {
+    if (progress != nullptr) {
+      progress->advance(0, target.vertices_size(), target.faces_size());
+    }
+  } else {
+    // Формат определяется по первым байтам файла, а не по расширению
+    MeshFormat format;
+    {
+      MappedFile file(filename.c_str());
+      if (!file.is_open()) return false;
+      format = detect_mesh_format(file.data(), file.size());
+    }
+    bool read;
+    {
+      // Буферы разбора общие для загрузок; если их занимает другая
+      // загрузка, эта разбирает во временные
+      std::unique_lock<std::mutex> lock(scratch_mutex, std::try_to_lock);
+      target.set_parse_scratch(lock.owns_lock() ? &parse_scratch : nullptr);
+      read = target.read_file(filename.c_str(), progress, stream, format);
+      target.set_parse_scratch(nullptr);
+    }
+    if (!read) return false;
+    if (target.vertices_size() != 0) cache.store(filename, target);
+  }
+  // В кэше лежит модель как в файле, поэтому сварка идет при каждой
+  // загрузке; без лишних вершин границы модели могли сжаться
+  if (weld_epsilon >= 0.0f &&
+      target.weld_vertices(weld_epsilon).unreferenced != 0) {
+    target.normalization();
+  }
+  if (optimize_locality) target.optimize_locality();
+  // Ребра и куски для отсечения строятся здесь, чтобы при фоновой
+  // загрузке это тоже шло вне потока интерфейса
+  target.get_chunks();
+  return true;
+}
+
+void Controller::facesInFrustum(const glm::mat4 &view_projection,
+                                std::vector<uint32_t> &faces) const {
+  glm::vec4 planes[6];
+  MeshBvh::frustum_planes(view_projection, planes);
+  faces.clear();
+  model.query_region(planes, 6, faces);
+}
+
+void Controller::facesInBox(const glm::vec3 &min, const glm::vec3 &max,
+                            std::vector<uint32_t> &faces) const {
+  glm::vec4 planes[6];
+  MeshBvh::box_planes(min, max, planes);
+  faces.clear();
+  model.query_region(planes, 6, faces);
 }
 
 void Controller::rotateModel(float angle, glm::vec3 axis) {
@@ -1,5 +1,8 @@
 #ifndef SRC_CONTROLLER_H
 #define SRC_CONTROLLER_H
+#include <mutex>
+
+#include "../model/mesh_cache.h"
 #include "../model/model.h"
 namespace s21 {
 /**
@@ -53,6 +56,93 @@ class Controller {
    * @return Количество граней в модели.
    */
   size_t getFacesSize() const { return model.faces_size(); }
+  /**
+   * @brief Возвращает плоский список граней модели.
+   *
+   * Грани перебираются как Span с индексами вершин, без вложенных векторов.
+   *
+   * @return Список граней модели.
+   */
+  const FaceList& getFaceList() const { return model.get_faces(); }
+  /**
+   * @brief Возвращает уникальные ребра каркаса модели.
+   *
+   * Список строится один раз после загрузки, включая замыкающие ребра
+   * граней, и каждое общее ребро входит в него один раз.
+   *
+   * @return Пары индексов вершин (отсчет с нуля) для GL_LINES.
+   */
+  const std::vector<uint32_t>& getEdges() const { return model.get_edges(); }
+  /**
+   * @brief Возвращает разбиение каркаса на куски для отсечения при отрисовке.
+   *
+   * @return Куски с ребрами и вершинами, упорядоченными по кускам.
+   */
+  const MeshChunks& getChunks() const { return model.get_chunks(); }
+  /**
+   * @brief Возвращает упрощенный каркас для показа во время преобразований.
+   *
+   * Уровни строятся по запросу (buildLods) или в фоне после загрузки
+   * (setLods); модели меньше порога из setLodSettings их не имеют.
+   *
+   * @param max_edges Сколько ребер можно рисовать за кадр.
+   * @return Уровень детализации или nullptr, если рисовать нужно модель.
+   */
+  const LodLevel* getLod(size_t max_edges) const {
+    return model.get_lod(max_edges);
+  }
+  /**
+   * @brief Задает настройки уровней детализации для следующих загрузок.
+   *
+   * @param settings Разрешения сеток и минимальный размер модели.
+   */
+  void setLodSettings(const MeshLod::Settings& settings) {
+    model.set_lod_settings(settings);
+  }
+  /**
+   * @brief Перестраивает уровни детализации текущей модели.
+   *
+   * @return true, если уровни построены.
+   */
+  bool buildLods() { return model.build_lods(); }
+  /**
+   * @brief Ищет грань модели под лучом (например, под курсором).
+   *
+   * Поиск идет по иерархии объемов (строится в потоке загрузки или при
+   * первом запросе) и занимает примерно O(log N) вместо перебора граней.
+   *
+   * @param origin Начало луча в мировых координатах.
+   * @param direction Направление луча.
+   * @param hit Грань, ближайшая к точке попадания вершина и сама точка.
+   * @return true, если луч пересекает модель.
+   */
+  bool pickFace(const glm::vec3& origin, const glm::vec3& direction,
+                MeshBvh::Hit& hit) const {
+    return model.ray_pick(origin, direction, hit);
+  }
+  /**
+   * @brief Выбирает грани, видимые через пирамиду видимости.
+   *
+   * @param view_projection Произведение матриц проекции и вида.
+   * @param faces Номера граней, которые могут попасть в кадр.
+   */
+  void facesInFrustum(const glm::mat4& view_projection,
+                      std::vector<uint32_t>& faces) const;
+  /**
+   * @brief Выбирает грани, пересекающие параллелепипед (выделение области).
+   *
+   * @param min Нижний угол области в мировых координатах.
+   * @param max Верхний угол области.
+   * @param faces Номера граней, параллелепипеды которых задевают область.
+   */
+  void facesInBox(const glm::vec3& min, const glm::vec3& max,
+                  std::vector<uint32_t>& faces) const;
+  /**
+   * @brief Возвращает представление геометрии модели только для чтения.
+   *
+   * @return Представление вершин и граней с номерами поколений.
+   */
+  MeshView getView() const { return model.view(); }
   /**
    * @brief Устанавливает позицию модели.
    *
@@ -72,12 +162,211 @@ class Controller {
    * @param scale Коэффициент масштабирования.
    */
   void setScale(float scale);
+  /**
+   * @brief Ставит в очередь новое положение центра модели.
+   *
+   * Запросы из очереди применяются вместе в applyTransforms().
+   *
+   * @param position Новое положение центра.
+   */
+  void queuePosition(const glm::vec3& position) {
+    transforms.set_position(position);
+  }
+  /**
+   * @brief Ставит в очередь новый угол поворота вокруг оси координат.
+   *
+   * @param angle Угол в градусах.
+   * @param axis Ось координат.
+   */
+  void queueRotation(float angle, const glm::vec3& axis) {
+    transforms.set_rotation(angle, axis);
+  }
+  /**
+   * @brief Ставит в очередь масштабирование.
+   *
+   * @param scale Коэффициент масштабирования.
+   */
+  void queueScale(float scale) { transforms.scale(scale); }
+  /**
+   * @brief Проверяет, есть ли в очереди неприменённые преобразования.
+   *
+   * @return true, если очередь не пуста.
+   */
+  bool hasPendingTransforms() const { return transforms.has_pending(); }
+  /**
+   * @brief Применяет все запросы из очереди одним преобразованием.
+   *
+   * @return true, если модель изменилась.
+   */
+  bool applyTransforms() { return model.apply(transforms.take()); }
   /**
    * @brief Загружает модель из файла.
    *
+   * Если в кэше есть действительная копия файла, модель берется из нее без
+   * разбора текста; иначе файл разбирается и результат сохраняется в кэш.
+   * Поддерживаются OBJ, STL (двоичный и текстовый) и двоичный PLY; формат
+   * определяется по первым байтам файла.
+   *
    * @param filename Путь к файлу с моделью.
    */
   void loadModel(const std::string& filename);
+  /**
+   * @brief Загружает файл в отдельную модель, не трогая текущую.
+   *
+   * Может вызываться из рабочего потока, пока интерфейс рисует текущую
+   * модель: из состояния контроллера меняются только общие буферы разбора
+   * (под scratch_mutex). Готовая модель подменяет текущую через swapModel.
+   *
+   * @param filename Путь к файлу с моделью.
+   * @param target Модель из prepareModel().
+   * @param progress Ход загрузки и запрос отмены (может отсутствовать).
+   * @param stream Очередь для показа модели по мере разбора (может
+   * отсутствовать; при загрузке из кэша не используется).
+   * @return true, если модель загружена; false при ошибке или отмене.
+   */
+  bool loadModel(const std::string& filename, Model& target,
+                 LoadProgress* progress, LoadStream* stream = nullptr);
+  /**
+   * @brief Создает пустую модель с настройками текущей для загрузки в потоке.
+   *
+   * Модель получает память, отданную через recycleModel, поэтому загрузка
+   * модели не больше прежней не растит массивы заново. Вызывается в потоке
+   * интерфейса.
+   *
+   * @return Пустая модель.
+   */
+  Model prepareModel();
+  /**
+   * @brief Подменяет текущую модель загруженной.
+   *
+   * Подмена занимает O(1) и выполняется в потоке интерфейса, поэтому
+   * отрисовка видит либо старую, либо полностью готовую новую модель.
+   *
+   * @param loaded Загруженная модель; после вызова в ней старая модель.
+   */
+  void swapModel(Model& loaded) { std::swap(model, loaded); }
+  /**
+   * @brief Сохраняет память ненужной модели для следующей загрузки.
+   *
+   * Обычно это старая модель после swapModel или модель неудачной загрузки.
+   * Пока память хранится, она остается занятой; releaseBuffers ее
+   * освобождает. Вызывается в потоке интерфейса.
+   *
+   * @param retired Ненужная модель; после вызова пуста.
+   */
+  void recycleModel(Model& retired) { spare.recycle(retired); }
+  /**
+   * @brief Освобождает память, сохраненную для следующих загрузок.
+   *
+   * Не должен вызываться во время загрузки.
+   */
+  void releaseBuffers();
+  /**
+   * @brief Задает каталог кэша разобранных моделей.
+   *
+   * @param directory Каталог кэша; пустая строка отключает кэш.
+   */
+  void setCacheDirectory(const std::string& directory) {
+    cache.set_directory(directory);
+  }
+  /**
+   * @brief Задает предел общего размера файлов кэша.
+   *
+   * @param bytes Предел в байтах (см. MeshCache::set_limit).
+   */
+  void setCacheLimit(uint64_t bytes) { cache.set_limit(bytes); }
+  /**
+   * @brief Включает сварку вершин после загрузки.
+   *
+   * Вершины ближе epsilon друг к другу сливаются, вершины без граней
+   * удаляются (см. Model::weld_vertices); счетчики модели показывают уже
+   * сжатую сетку.
+   *
+   * @param epsilon Расстояние сварки в нормализованных координатах (модель
+   * вписана в куб [-1, 1]); отрицательное значение отключает сварку.
+   */
+  void setWeldEpsilon(float epsilon) { weld_epsilon = epsilon; }
+  /**
+   * @brief Возвращает итог сварки вершин текущей модели.
+   *
+   * @return Число вершин до и после сварки; нули, если сварки не было.
+   */
+  const MeshWeld::Stats& getWeldStats() const {
+    return model.get_weld_stats();
+  }
+  /**
+   * @brief Включает перестановку граней и вершин после загрузки.
+   *
+   * Грани переставляются для кэша вершин, вершины - в порядке первого
+   * использования (см. Model::optimize_locality). Проход идет после сварки.
+   *
+   * @param enabled true, чтобы переставлять.
+   */
+  void setOptimizeLocality(bool enabled) { optimize_locality = enabled; }
+  /**
+   * @brief Задает число потоков для загрузки модели.
+   *
+   * @param threads Число потоков; 0 означает число ядер процессора.
+   */
+  void setLoadThreads(size_t threads) { model.set_load_threads(threads); }
+  /**
+   * @brief Задает число потоков для преобразования вершин модели.
+   *
+   * @param threads Число потоков; 0 означает число ядер процессора.
+   */
+  void setTransformThreads(size_t threads) {
+    model.set_transform_threads(threads);
+  }
+  /**
+   * @brief Задает способ хранения вершин модели.
+   *
+   * @param layout VertexLayout::kAoS - массив glm::vec3, VertexLayout::kSoA -
+   * три выровненных массива координат.
+   */
+  void setVertexLayout(VertexLayout layout) { model.set_vertex_layout(layout); }
+  /**
+   * @brief Возвращает способ хранения вершин модели.
+   *
+   * @return Текущий способ хранения.
+   */
+  VertexLayout getVertexLayout() const { return model.get_vertex_layout(); }
+  /**
+   * @brief Возвращает вершины по осям (structure of arrays).
+   *
+   * При хранении VertexLayout::kAoS массивы собираются по запросу. Вершины
+   * в виде glm::vec3 (для загрузки в видеопамять) доступны через getView().
+   *
+   * @return Вершины по осям.
+   */
+  const SoaVertices& getSoaVertices() const { return model.soa_vertices(); }
+  /**
+   * @brief Возвращает вершины, сжатые до 16-битных кодов.
+   *
+   * Коды собираются заново, только когда изменились вершины модели.
+   *
+   * @return Сжатые вершины для загрузки в видеопамять.
+   */
+  const QuantizedVertices& getQuantizedVertices() const {
+    return model.quantized_vertices();
+  }
+  /**
+   * @brief Задает способ применения преобразований модели.
+   *
+   * @param mode TransformMode::kMatrix - преобразования копятся в матрице
+   * модели и применяются на видеокарте; TransformMode::kVertices -
+   * преобразования сразу переписывают вершины.
+   */
+  void setTransformMode(TransformMode mode) { model.set_transform_mode(mode); }
+  /**
+   * @brief Возвращает матрицу модели с еще не примененными преобразованиями.
+   *
+   * @return Матрица модели.
+   */
+  const glm::mat4& getModelMatrix() const { return model.get_model_matrix(); }
+  /**
+   * @brief Применяет матрицу модели к вершинам (например, перед экспортом).
+   */
+  void bakeTransform() { model.bake(); }
   /**
    * @brief Вращает модель вокруг заданной оси на указанный угол.
    *
@@ -110,6 +399,14 @@ class Controller {
 
  private:
   s21::Model model;  // Модель данных
+  MeshCache cache;   // Кэш разобранных моделей
+  TransformQueue transforms;  // Преобразования, ждущие следующего кадра
+  float weld_epsilon = -1.0f;  // Расстояние сварки (< 0 - без сварки)
+  bool optimize_locality = false;  // Переставлять грани и вершины
+  // Память снятых моделей и буферы разбора для следующей загрузки
+  s21::Model spare;  // Пустая модель с памятью снятой модели
+  ObjParser::Scratch parse_scratch;  // Буферы параллельного разбора
+  std::mutex scratch_mutex;  // Занятость буферов разбора
 };
 }  // namespace s21
 #endif  // SRC_CONTROLLER_H
@@ -0,0 +1,108 @@
+#ifndef SRC_MODEL_CELL_MAP_H
+#define SRC_MODEL_CELL_MAP_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace s21 {
+    /**
+     * @brief Отображение ячеек пространственной сетки в плотные номера.
+     *
+     * Хеш-таблица с открытой адресацией: ключ - номер ячейки, значение -
+     * номер группы, выданный при первой встрече ячейки. Занятых ячеек обычно
+     * порядка площади поверхности модели, поэтому таблица начинается с
+     * оценки и растет вдвое при заполнении наполовину.
+     */
+    class CellMap {
+        public:
+            /**
+             * @brief Создает таблицу.
+             *
+             * @param expected Ожидаемое число занятых ячеек.
+             */
+            explicit CellMap(size_t expected){
+                size_t capacity = 16;
+                while(capacity < expected * 2){
+                    capacity *= 2;
+                }
+                keys.assign(capacity, kEmpty);
+                ids.resize(capacity);
+            }
+
+            /**
+             * @brief Возвращает номер группы ячейки.
+             *
+             * @param key Номер ячейки (любой, кроме ~0).
+             * @param next Номер, который получит ячейка, если ее еще нет.
+             * @return Номер группы ячейки; next, если ячейка новая.
+             */
+            uint32_t find_or_insert(uint64_t key, uint32_t next){
+                if((count + 1) * 2 > keys.size()){
+                    grow();
+                }
+                size_t mask = keys.size() - 1;
+                for(size_t slot = slot_of(key, mask); ; slot = (slot + 1) & mask){
+                    if(keys[slot] == key){
+                        return ids[slot];
+                    }
+                    if(keys[slot] == kEmpty){
+                        keys[slot] = key;
+                        ids[slot] = next;
+                        ++count;
+                        return next;
+                    }
+                }
+            }
+
+            /**
+             * @brief Ищет ячейку, не добавляя ее.
+             *
+             * @param key Номер ячейки (любой, кроме ~0).
+             * @return Номер группы ячейки или kMissing, если ячейки нет.
+             */
+            uint32_t find(uint64_t key) const {
+                size_t mask = keys.size() - 1;
+                for(size_t slot = slot_of(key, mask); ; slot = (slot + 1) & mask){
+                    if(keys[slot] == key){
+                        return ids[slot];
+                    }
+                    if(keys[slot] == kEmpty){
+                        return kMissing;
+                    }
+                }
+            }
+
+            static constexpr uint32_t kMissing = ~uint32_t(0); // Результат find для новой ячейки
+
+        private:
+            static constexpr uint64_t kEmpty = ~uint64_t(0);
+
+            static size_t slot_of(uint64_t key, size_t mask){
+                return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+            }
+
+            void grow(){
+                std::vector<uint64_t> old_keys(keys.size() * 2, kEmpty);
+                std::vector<uint32_t> old_ids(ids.size() * 2);
+                old_keys.swap(keys);
+                old_ids.swap(ids);
+                size_t mask = keys.size() - 1;
+                for(size_t i = 0; i < old_keys.size(); ++i){
+                    if(old_keys[i] == kEmpty){
+                        continue;
+                    }
+                    size_t slot = slot_of(old_keys[i], mask);
+                    while(keys[slot] != kEmpty){
+                        slot = (slot + 1) & mask;
+                    }
+                    keys[slot] = old_keys[i];
+                    ids[slot] = old_ids[i];
+                }
+            }
+
+            std::vector<uint64_t> keys; // Номера ячеек
+            std::vector<uint32_t> ids; // Номера групп
+            size_t count = 0; // Число занятых слотов
+    };
+} // namespace s21
+#endif
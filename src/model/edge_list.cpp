@@ -0,0 +1,163 @@
+#include "edge_list.h"
+
+#include <utility>
+
+namespace s21 {
+
+    namespace {
+        // Ключ ребра (a < b, поэтому все единицы не встречается)
+        constexpr uint64_t kEmpty = ~uint64_t(0);
+        // Таблица растет вдвое при заполнении на 3/4
+        constexpr size_t kMaxLoadNumerator = 3;
+        constexpr size_t kMaxLoadDenominator = 4;
+
+        // Участок таблицы: 8 соседних по номеру вершин, 64 слота, 512 байт
+        constexpr unsigned kGroupBits = 3;
+        constexpr unsigned kRegionBits = 6;
+        // Сколько слотов участка пробуется до перехода к общей таблице
+        constexpr unsigned kLocalProbes = 8;
+
+        // Хеш-множество ключей ребер с открытой адресацией.
+        //
+        // Ребра восьми соседних по номеру меньших вершин попадают в общий
+        // участок из 64 слотов, а сами участки разбросаны по таблице
+        // хешированием. Соседние в файле грани ссылаются на близкие индексы,
+        // поэтому обращения к таблице укладываются в немногие строки кэша.
+        // Место в участке зависит от всего ключа, но у вершины с большой
+        // степенью (вершина конуса, полюс сферы, веер n-угольника) ребер
+        // больше, чем слотов участка: после kLocalProbes занятых слотов
+        // ключ ищется линейным пробированием с места, выбранного хешем
+        // всего ключа по всей таблице, и вставка остается O(1) в среднем.
+        class EdgeSet {
+            public:
+                explicit EdgeSet(size_t expected){
+                    size_t capacity = size_t(1) << kRegionBits;
+                    bits = kRegionBits;
+                    while(capacity * kMaxLoadNumerator < expected * kMaxLoadDenominator){
+                        capacity *= 2;
+                        ++bits;
+                    }
+                    table.assign(capacity, kEmpty);
+                }
+
+                // Возвращает true, если ключа еще не было
+                bool insert(uint64_t key){
+                    if((count + 1) * kMaxLoadDenominator > table.size() * kMaxLoadNumerator){
+                        grow();
+                    }
+                    size_t slot = find(key);
+                    if(table[slot] == key){
+                        return false;
+                    }
+                    table[slot] = key;
+                    ++count;
+                    return true;
+                }
+
+            private:
+                // Слот с ключом или первый пустой слот на пути пробирования.
+                // Слоты не освобождаются, поэтому пустой слот значит, что
+                // ключа в таблице нет
+                size_t find(uint64_t key) const {
+                    uint64_t mixed = key * 0x9E3779B97F4A7C15ull;
+                    uint64_t a = key >> 32;
+                    size_t region = bits > kRegionBits
+                                        ? static_cast<size_t>(((a >> kGroupBits) * 0x9E3779B97F4A7C15ull) >> (64 - (bits - kRegionBits)))
+                                        : 0;
+                    size_t offset = static_cast<size_t>(mixed >> (64 - kRegionBits));
+                    const size_t region_mask = (size_t(1) << kRegionBits) - 1;
+                    for(unsigned step = 0; step < kLocalProbes; ++step){
+                        size_t slot = region << kRegionBits | ((offset + step) & region_mask);
+                        if(table[slot] == key || table[slot] == kEmpty){
+                            return slot;
+                        }
+                    }
+                    size_t mask = table.size() - 1;
+                    // Второй хеш независим от первого, чтобы ключи одного
+                    // переполненного участка расходились по таблице
+                    uint64_t spread = (key ^ (key >> 32)) * 0xBF58476D1CE4E5B9ull;
+                    for(size_t slot = static_cast<size_t>(spread >> (64 - bits)); ; slot = (slot + 1) & mask){
+                        if(table[slot] == key || table[slot] == kEmpty){
+                            return slot;
+                        }
+                    }
+                }
+
+                void grow(){
+                    std::vector<uint64_t> old(table.size() * 2, kEmpty);
+                    old.swap(table);
+                    ++bits;
+                    for(uint64_t key : old){
+                        if(key != kEmpty){
+                            table[find(key)] = key;
+                        }
+                    }
+                }
+
+                std::vector<uint64_t> table; // Слоты таблицы
+                unsigned bits = 0; // log2 числа слотов
+                size_t count = 0; // Число занятых слотов
+        };
+    } // namespace
+
+    std::vector<uint32_t> EdgeList::build(const FaceList& faces, size_t vertex_count){
+        std::vector<uint32_t> edges;
+        build(faces, vertex_count, edges);
+        // Запас больше четверти (открытые сетки, отрезки) возвращается
+        if(edges.capacity() - edges.size() > edges.size() / 4){
+            edges.shrink_to_fit();
+        }
+        return edges;
+    }
+
+    void EdgeList::build(const FaceList& faces, size_t vertex_count, std::vector<uint32_t>& edges){
+        // На замкнутой треугольной сетке уникальных ребер около половины
+        // сторон граней; при открытой сетке таблица дорастет сама
+        size_t sides = faces.index_data().size();
+        EdgeSet seen(sides / 2);
+        edges.clear();
+        // Небольшой запас на граничные ребра открытых сеток, чтобы массив
+        // не перевыделялся в конце
+        edges.reserve(sides + sides / 16);
+        for(const auto face : faces){
+            size_t n = face.size();
+            // У отрезка одно ребро, у многоугольника - n с замыкающим
+            size_t sides_in_face = n > 2 ? n : n - (n != 0);
+            for(size_t i = 0; i < sides_in_face; ++i){
+                uint32_t a = face[i];
+                uint32_t b = face[i + 1 < n ? i + 1 : 0];
+                if(a >= vertex_count || b >= vertex_count || a == b){
+                    continue;
+                }
+                if(a > b){
+                    std::swap(a, b);
+                }
+                if(seen.insert(static_cast<uint64_t>(a) << 32 | b)){
+                    edges.push_back(a);
+                    edges.push_back(b);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> EdgeList::remap(const std::vector<uint32_t>& edges,
+                                          const std::vector<uint32_t>& map){
+        EdgeSet seen(edges.size() / 2);
+        std::vector<uint32_t> result;
+        for(size_t i = 0; i + 1 < edges.size(); i += 2){
+            uint32_t a = map[edges[i]];
+            uint32_t b = map[edges[i + 1]];
+            if(a == b){
+                continue;
+            }
+            if(a > b){
+                std::swap(a, b);
+            }
+            if(seen.insert(static_cast<uint64_t>(a) << 32 | b)){
+                result.push_back(a);
+                result.push_back(b);
+            }
+        }
+        return result;
+    }
+} // namespace s21
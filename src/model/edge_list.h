@@ -0,0 +1,64 @@
+#ifndef SRC_MODEL_EDGE_LIST_H
+#define SRC_MODEL_EDGE_LIST_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "face_list.h"
+
+namespace s21 {
+    /**
+     * @brief Построение списка уникальных ребер каркаса.
+     *
+     * Каждая грань дает ребра между соседними вершинами, включая
+     * замыкающее ребро от последней вершины к первой. Ребро, общее для
+     * нескольких граней, попадает в список один раз, поэтому на замкнутой
+     * треугольной сетке ребер примерно вдвое меньше, чем сторон граней.
+     *
+     * Повторы отсеиваются хеш-таблицей с открытой адресацией за один проход
+     * по граням, без сортировки. Ребра идут в порядке первой встречи, что
+     * сохраняет локальность вершин исходного файла.
+     */
+    class EdgeList {
+        public:
+            /**
+             * @brief Строит список уникальных ребер.
+             *
+             * Ребра с индексами вне [0, vertex_count) и вырожденные ребра
+             * (из вершины в нее же) пропускаются.
+             *
+             * @param faces Грани с индексами вершин с нуля.
+             * @param vertex_count Количество вершин модели.
+             * @return Пары индексов вершин (отсчет с нуля) для GL_LINES.
+             */
+            static std::vector<uint32_t> build(const FaceList& faces, size_t vertex_count);
+
+            /**
+             * @brief Строит список уникальных ребер в готовый массив.
+             *
+             * Память массива сохраняется: при повторной загрузке модели не
+             * больше прежней ребра пишутся без выделения памяти, а запас
+             * открытых сеток не возвращается.
+             *
+             * @param faces Грани с индексами вершин с нуля.
+             * @param vertex_count Количество вершин модели.
+             * @param edges Массив для пар индексов; прежнее содержимое удаляется.
+             */
+            static void build(const FaceList& faces, size_t vertex_count, std::vector<uint32_t>& edges);
+
+            /**
+             * @brief Переводит ребра на новые вершины и убирает повторы.
+             *
+             * Нужен, когда несколько вершин сливаются в одну (упрощение,
+             * сварка): ребра, ставшие вырожденными, пропадают, а совпавшие
+             * остаются в одном экземпляре.
+             *
+             * @param edges Пары индексов старых вершин (отсчет с нуля).
+             * @param map Новый индекс для каждой старой вершины.
+             * @return Пары индексов новых вершин.
+             */
+            static std::vector<uint32_t> remap(const std::vector<uint32_t>& edges,
+                                               const std::vector<uint32_t>& map);
+    };
+} // namespace s21
+#endif
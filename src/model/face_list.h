@@ -0,0 +1,228 @@
+#ifndef SRC_MODEL_FACE_LIST_H
+#define SRC_MODEL_FACE_LIST_H
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace s21 {
+    /**
+     * @brief Невладеющее представление непрерывного диапазона элементов.
+     *
+     * Упрощенный аналог std::span из C++20.
+     */
+    template <typename T>
+    class Span {
+        public:
+            Span() = default;
+            Span(T* data, size_t size) : ptr(data), count(size) {}
+
+            T* begin() const { return ptr; }
+            T* end() const { return ptr + count; }
+            T* data() const { return ptr; }
+            size_t size() const { return count; }
+            bool empty() const { return count == 0; }
+            T& operator[](size_t i) const { return ptr[i]; }
+
+        private:
+            T* ptr = nullptr; // Начало диапазона
+            size_t count = 0; // Число элементов
+    };
+
+    /**
+     * @brief Плоское хранилище граней в формате CSR.
+     *
+     * Индексы вершин всех граней лежат подряд в одном массиве, а массив
+     * смещений хранит начало каждой грани (и конец последней). Это избавляет
+     * от отдельного выделения памяти на каждую грань и позволяет проходить
+     * по граням последовательно. Индексы хранятся 32-битными.
+     */
+    class FaceList {
+        public:
+            using index_type = uint32_t; // Тип индекса вершины
+            using face_type = Span<const index_type>; // Представление одной грани
+
+            /**
+             * @brief Итератор по граням, возвращающий их представления.
+             */
+            class const_iterator {
+                public:
+                    using iterator_category = std::random_access_iterator_tag;
+                    using value_type = face_type;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = face_type;
+
+                    const_iterator() = default;
+                    const_iterator(const FaceList* list, size_t face) : list(list), face(face) {}
+
+                    face_type operator*() const { return (*list)[face]; }
+                    face_type operator[](difference_type n) const { return (*list)[face + n]; }
+                    const_iterator& operator++() { ++face; return *this; }
+                    const_iterator operator++(int) { const_iterator it = *this; ++face; return it; }
+                    const_iterator& operator--() { --face; return *this; }
+                    const_iterator& operator+=(difference_type n) { face += n; return *this; }
+                    const_iterator operator+(difference_type n) const { return {list, face + n}; }
+                    difference_type operator-(const const_iterator& other) const {
+                        return static_cast<difference_type>(face) - static_cast<difference_type>(other.face);
+                    }
+                    bool operator==(const const_iterator& other) const { return face == other.face; }
+                    bool operator!=(const const_iterator& other) const { return face != other.face; }
+                    bool operator<(const const_iterator& other) const { return face < other.face; }
+
+                private:
+                    const FaceList* list = nullptr; // Список граней
+                    size_t face = 0; // Номер текущей грани
+            };
+
+            /**
+             * @brief Конструктор по умолчанию.
+             *
+             * Создает пустой список граней.
+             */
+            FaceList() : offsets(1, 0) {}
+
+            /**
+             * @brief Удаляет все грани.
+             */
+            void clear() {
+                indices.clear();
+                offsets.assign(1, 0);
+            }
+
+            /**
+             * @brief Резервирует память под грани и индексы.
+             *
+             * @param faces Ожидаемое число граней.
+             * @param total_indices Ожидаемое суммарное число индексов.
+             */
+            void reserve(size_t faces, size_t total_indices) {
+                offsets.reserve(faces + 1);
+                indices.reserve(total_indices);
+            }
+
+            /**
+             * @brief Заменяет содержимое готовыми массивами в формате CSR.
+             *
+             * @param offset_data Начала граней (face_count + 1 элементов, первый - 0).
+             * @param face_count Количество граней.
+             * @param index_data Индексы вершин всех граней подряд (offset_data[face_count] элементов).
+             */
+            void assign(const index_type* offset_data, size_t face_count, const index_type* index_data) {
+                offsets.assign(offset_data, offset_data + face_count + 1);
+                indices.assign(index_data, index_data + offsets.back());
+            }
+
+            /**
+             * @brief Добавляет индекс в текущую (незавершенную) грань.
+             *
+             * @param index Индекс вершины.
+             */
+            void push_index(index_type index) { indices.push_back(index); }
+
+            /**
+             * @brief Завершает текущую грань.
+             */
+            void close_face() { offsets.push_back(static_cast<index_type>(indices.size())); }
+
+            /**
+             * @brief Добавляет грань целиком.
+             *
+             * @param first Указатель на первый индекс.
+             * @param count Число индексов.
+             */
+            void push_face(const index_type* first, size_t count) {
+                indices.insert(indices.end(), first, first + count);
+                close_face();
+            }
+
+            /**
+             * @brief Дописывает в конец грани из другого списка.
+             *
+             * @param other Список граней.
+             */
+            void append(const FaceList& other) { append(other, 0, other.size()); }
+
+            /**
+             * @brief Дописывает в конец грани [first, last) из другого списка.
+             *
+             * @param other Список граней.
+             * @param first Номер первой грани.
+             * @param last Номер за последней гранью.
+             */
+            void append(const FaceList& other, size_t first, size_t last) {
+                index_type shift = static_cast<index_type>(indices.size()) - other.offsets[first];
+                indices.insert(indices.end(), other.indices.begin() + other.offsets[first],
+                               other.indices.begin() + other.offsets[last]);
+                offsets.reserve(offsets.size() + (last - first));
+                for (size_t i = first + 1; i <= last; ++i) {
+                    offsets.push_back(other.offsets[i] + shift);
+                }
+            }
+
+            /**
+             * @brief Возвращает количество граней.
+             *
+             * @return Количество граней.
+             */
+            size_t size() const { return offsets.size() - 1; }
+
+            /**
+             * @brief Проверяет, пуст ли список.
+             *
+             * @return true, если граней нет.
+             */
+            bool empty() const { return size() == 0; }
+
+            /**
+             * @brief Возвращает грань по номеру.
+             *
+             * @param face Номер грани.
+             * @return Представление индексов грани.
+             */
+            face_type operator[](size_t face) const {
+                return {indices.data() + offsets[face], static_cast<size_t>(offsets[face + 1] - offsets[face])};
+            }
+
+            const_iterator begin() const { return {this, 0}; }
+            const_iterator end() const { return {this, size()}; }
+
+            /**
+             * @brief Возвращает плоский массив индексов всех граней.
+             *
+             * @return Массив индексов.
+             */
+            const std::vector<index_type>& index_data() const { return indices; }
+
+            /**
+             * @brief Возвращает массив смещений граней (size() + 1 элементов).
+             *
+             * @return Массив смещений.
+             */
+            const std::vector<index_type>& offset_data() const { return offsets; }
+
+            /**
+             * @brief Возвращает объем занятой памяти в байтах.
+             *
+             * @return Объем памяти.
+             */
+            size_t memory_bytes() const {
+                return (indices.capacity() + offsets.capacity()) * sizeof(index_type);
+            }
+
+            bool operator==(const FaceList& other) const {
+                return indices == other.indices && offsets == other.offsets;
+            }
+            bool operator!=(const FaceList& other) const { return !(*this == other); }
+
+        private:
+            friend class MeshReorder;
+            friend class MeshWeld;
+            friend class ObjParser;
+            friend class PlyParser;
+
+            std::vector<index_type> indices; // Индексы вершин всех граней подряд
+            std::vector<index_type> offsets; // Начала граней в массиве индексов
+    };
+} // namespace s21
+#endif
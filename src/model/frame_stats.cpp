@@ -0,0 +1,168 @@
+#include "frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace s21 {
+
+    namespace {
+        constexpr const char* kPhaseNames[FrameStats::kPhaseCount] = {"setup", "prepare", "edges", "points"};
+
+        double milliseconds(std::chrono::steady_clock::duration duration){
+            return std::chrono::duration<double, std::milli>(duration).count();
+        }
+
+        bool ends_with(const std::string& text, const std::string& suffix){
+            return text.size() >= suffix.size() &&
+                   text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+    } // namespace
+
+    FrameStats::FrameStats(size_t capacity) : frames(std::max<size_t>(capacity, 1)) {}
+
+    uint64_t FrameStats::begin_frame(){
+        current = Frame();
+        current.number = next_number++;
+        frame_start = Clock::now();
+        phase_start = frame_start;
+        return current.number;
+    }
+
+    void FrameStats::mark(Phase phase){
+        Clock::time_point now = Clock::now();
+        current.phases[phase] += milliseconds(now - phase_start);
+        phase_start = now;
+    }
+
+    void FrameStats::end_frame(){
+        current.cpu = milliseconds(Clock::now() - frame_start);
+        frames[head] = current;
+        head = (head + 1) % frames.size();
+        stored = std::min(stored + 1, frames.size());
+    }
+
+    void FrameStats::set_gpu_time(uint64_t number, double milliseconds){
+        // Кадры в буфере идут подряд, поэтому место кадра вычисляется по номеру
+        uint64_t newest = next_number - 1;
+        if(stored == 0 || number > newest || newest - number >= stored){
+            return;
+        }
+        size_t back = static_cast<size_t>(newest - number);
+        Frame& frame = frames[(head + frames.size() - 1 - back) % frames.size()];
+        if(frame.number == number){
+            frame.gpu = milliseconds;
+        }
+    }
+
+    const FrameStats::Frame& FrameStats::at(size_t index) const {
+        return frames[(head + frames.size() - stored + index) % frames.size()];
+    }
+
+    const FrameStats::Frame& FrameStats::last() const {
+        static const Frame empty;
+        return stored == 0 ? empty : at(stored - 1);
+    }
+
+    double FrameStats::percentile(std::vector<double>& values, double fraction){
+        if(values.empty()){
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(fraction * values.size()));
+        size_t index = std::min(values.size() - 1, rank == 0 ? 0 : rank - 1);
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    FrameStats::Summary FrameStats::summarize() const {
+        Summary summary;
+        summary.frames = stored;
+        if(stored == 0){
+            return summary;
+        }
+        std::vector<double> cpu;
+        std::vector<double> gpu;
+        cpu.reserve(stored);
+        for(size_t i = 0; i < stored; ++i){
+            const Frame& frame = at(i);
+            cpu.push_back(frame.cpu);
+            if(frame.gpu >= 0.0){
+                gpu.push_back(frame.gpu);
+            }
+            for(int p = 0; p < kPhaseCount; ++p){
+                summary.phase_mean[p] += frame.phases[p] / stored;
+            }
+        }
+        summary.cpu_p50 = percentile(cpu, 0.50);
+        summary.cpu_p95 = percentile(cpu, 0.95);
+        summary.cpu_p99 = percentile(cpu, 0.99);
+        summary.cpu_max = *std::max_element(cpu.begin(), cpu.end());
+        summary.gpu_frames = gpu.size();
+        summary.gpu_p50 = percentile(gpu, 0.50);
+        summary.gpu_p95 = percentile(gpu, 0.95);
+        summary.gpu_p99 = percentile(gpu, 0.99);
+        return summary;
+    }
+
+    void FrameStats::write_csv(std::ostream& out) const {
+        out << "frame,cpu_ms";
+        for(const char* name : kPhaseNames){
+            out << ',' << name << "_ms";
+        }
+        out << ",gpu_ms,edges,points\n";
+        for(size_t i = 0; i < stored; ++i){
+            const Frame& frame = at(i);
+            out << frame.number << ',' << frame.cpu;
+            for(double phase : frame.phases){
+                out << ',' << phase;
+            }
+            // Неизвестное время видеокарты - пустое поле
+            out << ',';
+            if(frame.gpu >= 0.0){
+                out << frame.gpu;
+            }
+            out << ',' << frame.edges << ',' << frame.points << '\n';
+        }
+    }
+
+    void FrameStats::write_json(std::ostream& out) const {
+        Summary summary = summarize();
+        out << "{\n  \"summary\": {\"frames\": " << summary.frames
+            << ", \"cpu_p50_ms\": " << summary.cpu_p50 << ", \"cpu_p95_ms\": " << summary.cpu_p95
+            << ", \"cpu_p99_ms\": " << summary.cpu_p99 << ", \"cpu_max_ms\": " << summary.cpu_max
+            << ", \"gpu_frames\": " << summary.gpu_frames << ", \"gpu_p50_ms\": " << summary.gpu_p50
+            << ", \"gpu_p95_ms\": " << summary.gpu_p95 << ", \"gpu_p99_ms\": " << summary.gpu_p99;
+        for(int p = 0; p < kPhaseCount; ++p){
+            out << ", \"" << kPhaseNames[p] << "_mean_ms\": " << summary.phase_mean[p];
+        }
+        out << "},\n  \"frames\": [";
+        for(size_t i = 0; i < stored; ++i){
+            const Frame& frame = at(i);
+            out << (i == 0 ? "\n" : ",\n") << "    {\"frame\": " << frame.number << ", \"cpu_ms\": " << frame.cpu;
+            for(int p = 0; p < kPhaseCount; ++p){
+                out << ", \"" << kPhaseNames[p] << "_ms\": " << frame.phases[p];
+            }
+            out << ", \"gpu_ms\": ";
+            if(frame.gpu >= 0.0){
+                out << frame.gpu;
+            } else {
+                out << "null";
+            }
+            out << ", \"edges\": " << frame.edges << ", \"points\": " << frame.points << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    bool FrameStats::save(const std::string& filename) const {
+        std::ofstream out(filename, std::ios::trunc);
+        if(!out){
+            return false;
+        }
+        if(ends_with(filename, ".json")){
+            write_json(out);
+        } else {
+            write_csv(out);
+        }
+        return static_cast<bool>(out);
+    }
+} // namespace s21
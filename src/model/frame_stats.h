@@ -0,0 +1,195 @@
+#ifndef SRC_MODEL_FRAME_STATS_H
+#define SRC_MODEL_FRAME_STATS_H
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace s21 {
+    /**
+     * @brief Замеры времени кадров отрисовки.
+     *
+     * Кадр делится на фазы: время от начала кадра (или прошлой отметки) до
+     * отметки mark относится к указанной фазе. Хранятся последние кадры в
+     * кольцевом буфере заданной емкости, поэтому запись кадра не выделяет
+     * память. Время на видеокарте приходит с опозданием в несколько кадров
+     * и дописывается к кадру по его номеру.
+     *
+     * По сохраненным кадрам считаются процентили времени, а сами кадры
+     * выгружаются в CSV или JSON для сравнения сборок.
+     */
+    class FrameStats {
+        public:
+            /**
+             * @brief Фаза кадра.
+             */
+            enum Phase {
+                kSetup, // Очистка и настройка состояния OpenGL
+                kPrepare, // Загрузка данных в видеопамять и отсечение
+                kEdges, // Отрисовка ребер
+                kPoints, // Отрисовка вершин
+                kPhaseCount
+            };
+
+            /**
+             * @brief Замеры одного кадра.
+             */
+            struct Frame {
+                uint64_t number = 0; // Номер кадра с начала работы
+                double phases[kPhaseCount] = {}; // Время фаз, мс
+                double cpu = 0.0; // Время кадра на процессоре, мс
+                double gpu = -1.0; // Время кадра на видеокарте, мс (< 0 - неизвестно)
+                size_t edges = 0; // Отправлено ребер
+                size_t points = 0; // Отправлено вершин
+            };
+
+            /**
+             * @brief Процентили времени кадра на процессоре и видеокарте.
+             */
+            struct Summary {
+                size_t frames = 0; // Число кадров в выборке
+                double cpu_p50 = 0.0; // Медиана, мс
+                double cpu_p95 = 0.0; // 95-й процентиль, мс
+                double cpu_p99 = 0.0; // 99-й процентиль, мс
+                double cpu_max = 0.0; // Худший кадр, мс
+                size_t gpu_frames = 0; // Кадров с известным временем видеокарты
+                double gpu_p50 = 0.0; // Медиана, мс
+                double gpu_p95 = 0.0; // 95-й процентиль, мс
+                double gpu_p99 = 0.0; // 99-й процентиль, мс
+                double phase_mean[kPhaseCount] = {}; // Среднее время фаз, мс
+            };
+
+            /**
+             * @brief Создает буфер кадров.
+             *
+             * @param capacity Сколько последних кадров хранить.
+             */
+            explicit FrameStats(size_t capacity = 1024);
+
+            /**
+             * @brief Начинает кадр.
+             *
+             * @return Номер кадра, по которому потом дописывается время видеокарты.
+             */
+            uint64_t begin_frame();
+
+            /**
+             * @brief Относит время с прошлой отметки к фазе.
+             *
+             * Время складывается, если фаза отмечается в кадре несколько раз.
+             *
+             * @param phase Фаза, которая только что закончилась.
+             */
+            void mark(Phase phase);
+
+            /**
+             * @brief Учитывает отправленные на отрисовку ребра и вершины.
+             *
+             * @param edges Число ребер.
+             * @param points Число вершин.
+             */
+            void add_submitted(size_t edges, size_t points){
+                current.edges += edges;
+                current.points += points;
+            }
+
+            /**
+             * @brief Заканчивает кадр и сохраняет его замеры.
+             */
+            void end_frame();
+
+            /**
+             * @brief Дописывает время видеокарты к сохраненному кадру.
+             *
+             * Ничего не делает, если кадр уже вытеснен из буфера.
+             *
+             * @param number Номер кадра из begin_frame.
+             * @param milliseconds Время кадра на видеокарте.
+             */
+            void set_gpu_time(uint64_t number, double milliseconds);
+
+            /**
+             * @brief Возвращает число сохраненных кадров.
+             *
+             * @return Не больше емкости буфера.
+             */
+            size_t size() const { return stored; }
+
+            /**
+             * @brief Возвращает сохраненный кадр.
+             *
+             * @param index Номер с нуля, от самого старого кадра к последнему.
+             * @return Замеры кадра.
+             */
+            const Frame& at(size_t index) const;
+
+            /**
+             * @brief Возвращает последний законченный кадр.
+             *
+             * @return Замеры кадра; пустые, если кадров еще не было.
+             */
+            const Frame& last() const;
+
+            /**
+             * @brief Считает процентили по сохраненным кадрам.
+             *
+             * @return Процентили и средние времена фаз.
+             */
+            Summary summarize() const;
+
+            /**
+             * @brief Процентиль выборки по ближайшему рангу.
+             *
+             * @param values Выборка (переупорядочивается).
+             * @param fraction Доля от 0 до 1.
+             * @return Значение процентиля; 0 для пустой выборки.
+             */
+            static double percentile(std::vector<double>& values, double fraction);
+
+            /**
+             * @brief Выгружает кадры в CSV: строка заголовка и строка на кадр.
+             *
+             * @param out Поток вывода.
+             */
+            void write_csv(std::ostream& out) const;
+
+            /**
+             * @brief Выгружает кадры и процентили в JSON.
+             *
+             * @param out Поток вывода.
+             */
+            void write_json(std::ostream& out) const;
+
+            /**
+             * @brief Сохраняет кадры в файл.
+             *
+             * Формат выбирается по расширению: .json - JSON, иначе CSV.
+             *
+             * @param filename Имя файла.
+             * @return true, если файл записан.
+             */
+            bool save(const std::string& filename) const;
+
+            /**
+             * @brief Забывает сохраненные кадры.
+             */
+            void clear(){
+                stored = 0;
+                head = 0;
+            }
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            std::vector<Frame> frames; // Кольцевой буфер кадров
+            size_t head = 0; // Место следующего кадра
+            size_t stored = 0; // Сохранено кадров
+            uint64_t next_number = 0; // Номер следующего кадра
+            Frame current; // Текущий кадр
+            Clock::time_point frame_start; // Начало текущего кадра
+            Clock::time_point phase_start; // Прошлая отметка
+    };
+} // namespace s21
+#endif
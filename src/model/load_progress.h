@@ -0,0 +1,61 @@
+#ifndef SRC_MODEL_LOAD_PROGRESS_H
+#define SRC_MODEL_LOAD_PROGRESS_H
+#include <atomic>
+#include <cstdint>
+
+namespace s21 {
+    /**
+     * @brief Ход загрузки модели, общий для загрузчика и интерфейса.
+     *
+     * Загрузчик (в любом потоке) увеличивает счетчики и проверяет запрос
+     * отмены; интерфейс читает счетчики и может запросить отмену. Все
+     * операции атомарны и не блокируют.
+     */
+    class LoadProgress {
+        public:
+            /**
+             * @brief Запрашивает отмену загрузки.
+             */
+            void cancel() { cancel_requested.store(true, std::memory_order_relaxed); }
+
+            /**
+             * @brief Проверяет, запрошена ли отмена.
+             *
+             * @return true, если загрузку нужно прервать.
+             */
+            bool cancelled() const { return cancel_requested.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Задает общий объем данных для загрузки.
+             *
+             * @param bytes Размер файла в байтах.
+             */
+            void set_total_bytes(uint64_t bytes) { total.store(bytes, std::memory_order_relaxed); }
+
+            /**
+             * @brief Отмечает обработанную часть данных.
+             *
+             * @param bytes Число разобранных байт.
+             * @param vertex_count Число найденных вершин.
+             * @param face_count Число найденных граней.
+             */
+            void advance(uint64_t bytes, uint64_t vertex_count, uint64_t face_count){
+                parsed.fetch_add(bytes, std::memory_order_relaxed);
+                vertices_found.fetch_add(vertex_count, std::memory_order_relaxed);
+                faces_found.fetch_add(face_count, std::memory_order_relaxed);
+            }
+
+            uint64_t total_bytes() const { return total.load(std::memory_order_relaxed); } // Размер файла
+            uint64_t bytes_parsed() const { return parsed.load(std::memory_order_relaxed); } // Разобрано байт
+            uint64_t vertices() const { return vertices_found.load(std::memory_order_relaxed); } // Вершин найдено
+            uint64_t faces() const { return faces_found.load(std::memory_order_relaxed); } // Граней найдено
+
+        private:
+            std::atomic<bool> cancel_requested{false}; // Запрошена отмена
+            std::atomic<uint64_t> total{0}; // Размер файла
+            std::atomic<uint64_t> parsed{0}; // Разобрано байт
+            std::atomic<uint64_t> vertices_found{0}; // Вершин найдено
+            std::atomic<uint64_t> faces_found{0}; // Граней найдено
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,38 @@
+#include "load_stream.h"
+
+namespace s21 {
+
+    void LoadStream::publish(const glm::vec3* vertices, size_t vertex_count,
+                             const FaceList& faces, size_t first_face){
+        if(vertex_count == 0 && first_face == faces.size()){
+            return;
+        }
+        // Свертка считается до блокировки, пока вершины еще в кэше
+        VertexKernels::Bounds part = VertexKernels::reduce(vertices, vertex_count);
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.vertices.insert(pending.vertices.end(), vertices, vertices + vertex_count);
+            pending.faces.append(faces, first_face, faces.size());
+            bounds = VertexKernels::merge(bounds, part);
+            pending.bounds = bounds;
+            was_empty = empty;
+            empty = false;
+        }
+        if(was_empty && notify){
+            notify();
+        }
+    }
+
+    bool LoadStream::take(Batch& batch){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(empty){
+            return false;
+        }
+        batch.vertices.clear();
+        batch.faces.clear();
+        std::swap(batch, pending);
+        empty = true;
+        return true;
+    }
+} // namespace s21
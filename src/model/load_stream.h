@@ -0,0 +1,71 @@
+#ifndef SRC_MODEL_LOAD_STREAM_H
+#define SRC_MODEL_LOAD_STREAM_H
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "face_list.h"
+#include "vertex_kernels.h"
+
+namespace s21 {
+    /**
+     * @brief Очередь частей модели, публикуемых по мере разбора файла.
+     *
+     * Загрузчик дописывает в очередь новые вершины и грани в порядке файла;
+     * интерфейс забирает накопившееся одной порцией и дорисовывает его, не
+     * дожидаясь конца загрузки. Вместе с порцией отдается свертка всех уже
+     * опубликованных вершин, по которой модель предварительно нормализуется.
+     *
+     * Вершины публикуются до нормализации; индексы граней - с нуля от начала
+     * файла, поэтому грань может ссылаться на еще не пришедшие вершины.
+     */
+    class LoadStream {
+        public:
+            /**
+             * @brief Порция данных, накопившаяся с прошлого take.
+             */
+            struct Batch {
+                std::vector<glm::vec3> vertices; // Новые вершины (продолжают прежние)
+                FaceList faces; // Новые грани
+                VertexKernels::Bounds bounds; // Свертка всех опубликованных вершин
+            };
+
+            /**
+             * @brief Задает функцию, вызываемую при появлении данных в пустой очереди.
+             *
+             * Вызывается в потоке загрузчика, не чаще одного раза между
+             * вызовами take, поэтому достаточно отложенно вызвать take.
+             *
+             * @param callback Функция уведомления.
+             */
+            void set_callback(std::function<void()> callback) { notify = std::move(callback); }
+
+            /**
+             * @brief Публикует очередную часть модели.
+             *
+             * @param vertices Новые вершины.
+             * @param vertex_count Количество новых вершин.
+             * @param faces Список, из которого публикуются грани.
+             * @param first_face Номер первой новой грани в faces.
+             */
+            void publish(const glm::vec3* vertices, size_t vertex_count,
+                         const FaceList& faces, size_t first_face);
+
+            /**
+             * @brief Забирает все накопившиеся данные.
+             *
+             * @param batch Куда поместить данные (прежнее содержимое заменяется).
+             * @return false, если с прошлого вызова ничего не опубликовано.
+             */
+            bool take(Batch& batch);
+
+        private:
+            std::mutex mutex; // Защищает pending и bounds
+            Batch pending; // Опубликованное, но еще не забранное
+            VertexKernels::Bounds bounds; // Свертка всех опубликованных вершин
+            bool empty = true; // В pending нет данных
+            std::function<void()> notify; // Уведомление о новых данных
+    };
+} // namespace s21
+#endif
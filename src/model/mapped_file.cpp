@@ -0,0 +1,63 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+namespace s21 {
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : bytes(std::exchange(other.bytes, nullptr)),
+          length(std::exchange(other.length, 0)),
+          opened(std::exchange(other.opened, false)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            bytes = std::exchange(other.bytes, nullptr);
+            length = std::exchange(other.length, 0);
+            opened = std::exchange(other.opened, false);
+        }
+        return *this;
+    }
+
+    bool MappedFile::open(const char* filename){
+        close();
+        int fd = ::open(filename, O_RDONLY);
+        if(fd < 0){
+            return false;
+        }
+        struct stat st;
+        if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<size_t>(st.st_size);
+        if(length > 0){
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped == MAP_FAILED){
+                ::close(fd);
+                length = 0;
+                return false;
+            }
+            madvise(mapped, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(mapped);
+        }
+        // Отображение остается валидным и после закрытия дескриптора
+        ::close(fd);
+        opened = true;
+        return true;
+    }
+
+    void MappedFile::close(){
+        if(bytes != nullptr){
+            munmap(const_cast<char*>(bytes), length);
+        }
+        bytes = nullptr;
+        length = 0;
+        opened = false;
+    }
+} // namespace s21
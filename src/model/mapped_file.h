@@ -0,0 +1,83 @@
+#ifndef SRC_MODEL_MAPPED_FILE_H
+#define SRC_MODEL_MAPPED_FILE_H
+#include <cstddef>
+
+namespace s21 {
+    /**
+     * @brief Отображение файла в память только для чтения.
+     *
+     * Класс MappedFile отображает файл целиком в адресное пространство процесса
+     * (mmap), что позволяет разбирать его содержимое на месте, без копирования
+     * в промежуточные буферы. Ресурсы освобождаются в деструкторе.
+     */
+    class MappedFile {
+        public:
+            /**
+             * @brief Конструктор по умолчанию.
+             *
+             * Создает объект без отображенного файла.
+             */
+            MappedFile() = default;
+
+            /**
+             * @brief Открывает и отображает указанный файл.
+             *
+             * @param filename Путь к файлу.
+             */
+            explicit MappedFile(const char* filename) { open(filename); }
+
+            /**
+             * @brief Деструктор.
+             *
+             * Снимает отображение и закрывает файл.
+             */
+            ~MappedFile() { close(); }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+
+            /**
+             * @brief Отображает файл в память.
+             *
+             * Пустой файл считается успешно открытым и имеет нулевой размер.
+             *
+             * @param filename Путь к файлу.
+             * @return true, если файл удалось открыть.
+             */
+            bool open(const char* filename);
+
+            /**
+             * @brief Снимает отображение файла.
+             */
+            void close();
+
+            /**
+             * @brief Проверяет, открыт ли файл.
+             *
+             * @return true, если файл открыт.
+             */
+            bool is_open() const { return opened; }
+
+            /**
+             * @brief Возвращает указатель на начало содержимого файла.
+             *
+             * @return Указатель на данные или nullptr для пустого файла.
+             */
+            const char* data() const { return bytes; }
+
+            /**
+             * @brief Возвращает размер файла в байтах.
+             *
+             * @return Размер файла.
+             */
+            size_t size() const { return length; }
+
+        private:
+            const char* bytes = nullptr; // Начало отображения
+            size_t length = 0; // Размер отображения
+            bool opened = false; // Признак открытого файла
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,551 @@
+#include "mesh_bvh.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "thread_pool.h"
+
+namespace s21 {
+
+    namespace {
+        // Число корзин для оценки разбиения вдоль длинной оси центров
+        constexpr unsigned kBins = 12;
+        // Глубже этого уровня узлы делятся пополам по медиане, чтобы дерево
+        // не вырождалось в цепочку и стек обхода оставался фиксированным
+        constexpr unsigned kSahDepth = 48;
+        constexpr unsigned kStackSize = 96;
+        // Признак в записи стека: узел целиком внутри области
+        constexpr uint32_t kInside = 1u << 31;
+        // Номер грани без вершин в допустимом диапазоне
+        constexpr uint32_t kNoFace = ~0u;
+        // Участки не меньше этого проверяют запрос отмены
+        constexpr uint32_t kCancelCheckFaces = 1 << 16;
+
+        inline bool cancelled(const LoadProgress* progress){
+            return progress != nullptr && progress->cancelled();
+        }
+
+        struct Box {
+            glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+            void grow(const glm::vec3& p){
+                min = glm::min(min, p);
+                max = glm::max(max, p);
+            }
+
+            void grow(const Box& other){
+                min = glm::min(min, other.min);
+                max = glm::max(max, other.max);
+            }
+
+            glm::vec3 centroid() const { return (min + max) * 0.5f; }
+
+            // Половина площади поверхности (для сравнения разбиений хватает)
+            float area() const {
+                glm::vec3 d = max - min;
+                if(d.x < 0.0f || d.y < 0.0f || d.z < 0.0f){
+                    return 0.0f;
+                }
+                return d.x * d.y + d.y * d.z + d.z * d.x;
+            }
+        };
+
+        // Параллелепипед грани по вершинам в диапазоне; false, если их нет
+        bool face_box(const glm::vec3* vertices, size_t count, FaceList::face_type face, Box& box){
+            box = Box();
+            bool any = false;
+            for(uint32_t index : face){
+                if(index < count){
+                    box.grow(vertices[index]);
+                    any = true;
+                }
+            }
+            return any;
+        }
+
+        // Число частей для параллельной обработки count элементов
+        size_t parts_for(size_t count, size_t threads, size_t min_per_part){
+            ThreadPool& pool = ThreadPool::shared();
+            size_t limit = threads != 0 ? threads : pool.size();
+            return std::max<size_t>(1, std::min(limit, count / min_per_part));
+        }
+
+        // Грань при построении. Участки массива переставляются на месте,
+        // поэтому проходы по ним идут по памяти подряд
+        struct Ref {
+            Box box; // Параллелепипед грани
+            uint32_t face; // Номер грани
+        };
+
+        // Участок граней, поддерево которого еще предстоит построить
+        struct Task {
+            uint32_t node; // Индекс узла
+            uint32_t begin; // Начало участка
+            uint32_t end; // Конец участка
+            unsigned depth; // Глубина узла
+            Box bounds; // Параллелепипед граней участка
+            Box centroids; // Параллелепипед центров граней участка
+        };
+
+        // Считает параллелепипеды граней и их центров на участке
+        void measure(const std::vector<Ref>& refs, Task& task){
+            task.bounds = Box();
+            task.centroids = Box();
+            for(uint32_t i = task.begin; i < task.end; ++i){
+                task.bounds.grow(refs[i].box);
+                task.centroids.grow(refs[i].box.centroid());
+            }
+        }
+
+        // Строит узлы над участками общего массива граней. Разные участки
+        // можно строить параллельно: каждый поток переставляет только свой
+        class Builder {
+            public:
+                Builder(std::vector<Ref>& refs, const LoadProgress* progress)
+                    : refs(refs), progress(progress) {}
+
+                // Делит дерево начиная с nodes[root.node]. Участки не длиннее
+                // stop_size (если pending задан) не делятся, а откладываются
+                void subdivide(std::vector<MeshBvh::Node>& nodes, const Task& root,
+                               size_t stop_size, std::vector<Task>* pending) const {
+                    Task stack[kStackSize];
+                    size_t top = 0;
+                    stack[top++] = root;
+                    while(top != 0){
+                        Task task = stack[--top];
+                        MeshBvh::Node& node = nodes[task.node];
+                        node.min = task.bounds.min;
+                        node.max = task.bounds.max;
+                        node.first = task.begin;
+                        node.count = task.end - task.begin;
+                        if(pending != nullptr && task.end - task.begin <= stop_size){
+                            pending->push_back(task);
+                            continue;
+                        }
+                        if(task.end - task.begin >= kCancelCheckFaces && cancelled(progress)){
+                            return;
+                        }
+                        Task left;
+                        Task right;
+                        if(!split(task, left, right)){
+                            continue;
+                        }
+                        uint32_t index = static_cast<uint32_t>(nodes.size());
+                        nodes[task.node].first = index;
+                        nodes[task.node].count = 0;
+                        nodes.resize(nodes.size() + 2);
+                        left.node = index;
+                        right.node = index + 1;
+                        stack[top++] = right;
+                        stack[top++] = left;
+                    }
+                }
+
+            private:
+                // Делит участок на два; false, если участок остается листом.
+                // Параллелепипеды потомков собираются из корзин, поэтому на
+                // узел приходится один проход по граням и одна перестановка
+                bool split(const Task& task, Task& left, Task& right) const {
+                    uint32_t begin = task.begin;
+                    uint32_t end = task.end;
+                    if(end - begin <= MeshBvh::kLeafSize){
+                        return false;
+                    }
+                    left = {0, begin, 0, task.depth + 1, Box(), Box()};
+                    right = {0, 0, end, task.depth + 1, Box(), Box()};
+                    glm::vec3 extent = task.centroids.max - task.centroids.min;
+                    int axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2)
+                                                    : (extent.y >= extent.z ? 1 : 2);
+                    uint32_t mid = 0;
+                    if(extent[axis] > 0.0f && task.depth < kSahDepth){
+                        mid = binned_split(task, axis, left, right);
+                    }
+                    if(mid == 0){
+                        // Все центры совпадают, дерево слишком глубокое или
+                        // эвристика не нашла разбиения: участок делится пополам
+                        mid = extent[axis] > 0.0f ? median(begin, end, axis) : begin + (end - begin) / 2;
+                        left.end = mid;
+                        right.begin = mid;
+                        measure(refs, left);
+                        measure(refs, right);
+                        return true;
+                    }
+                    left.end = mid;
+                    right.begin = mid;
+                    return true;
+                }
+
+                // Разбиение по поверхностной эвристике вдоль оси axis;
+                // возвращает границу или 0, если разбиения нет
+                uint32_t binned_split(const Task& task, int axis, Task& left, Task& right) const {
+                    Box boxes[kBins];
+                    Box centers[kBins];
+                    uint32_t counts[kBins] = {};
+                    float origin = task.centroids.min[axis];
+                    float scale = kBins / (task.centroids.max[axis] - origin);
+                    for(uint32_t i = task.begin; i < task.end; ++i){
+                        const Box& box = refs[i].box;
+                        glm::vec3 center = box.centroid();
+                        unsigned bin = bin_of(center[axis], origin, scale);
+                        boxes[bin].grow(box);
+                        centers[bin].grow(center);
+                        ++counts[bin];
+                    }
+                    // Площади и числа граней справа от каждой границы
+                    float right_area[kBins];
+                    uint32_t right_count[kBins];
+                    Box accumulated;
+                    uint32_t count = 0;
+                    for(unsigned bin = kBins - 1; bin > 0; --bin){
+                        accumulated.grow(boxes[bin]);
+                        count += counts[bin];
+                        right_area[bin] = accumulated.area();
+                        right_count[bin] = count;
+                    }
+                    float best_cost = std::numeric_limits<float>::max();
+                    unsigned best = 0;
+                    accumulated = Box();
+                    count = 0;
+                    for(unsigned bin = 1; bin < kBins; ++bin){
+                        accumulated.grow(boxes[bin - 1]);
+                        count += counts[bin - 1];
+                        if(count == 0 || right_count[bin] == 0){
+                            continue;
+                        }
+                        float cost = accumulated.area() * count + right_area[bin] * right_count[bin];
+                        if(cost < best_cost){
+                            best_cost = cost;
+                            best = bin;
+                        }
+                    }
+                    if(best == 0){
+                        return 0;
+                    }
+                    for(unsigned bin = 0; bin < kBins; ++bin){
+                        Task& side = bin < best ? left : right;
+                        side.bounds.grow(boxes[bin]);
+                        side.centroids.grow(centers[bin]);
+                    }
+                    Ref* mid = std::partition(refs.data() + task.begin, refs.data() + task.end,
+                                              [&](const Ref& ref){
+                        return bin_of(ref.box.centroid()[axis], origin, scale) < best;
+                    });
+                    return static_cast<uint32_t>(mid - refs.data());
+                }
+
+                uint32_t median(uint32_t begin, uint32_t end, int axis) const {
+                    uint32_t mid = begin + (end - begin) / 2;
+                    std::nth_element(refs.data() + begin, refs.data() + mid, refs.data() + end,
+                                     [axis](const Ref& a, const Ref& b){
+                        return a.box.centroid()[axis] < b.box.centroid()[axis];
+                    });
+                    return mid;
+                }
+
+                static unsigned bin_of(float value, float origin, float scale){
+                    float bin = (value - origin) * scale;
+                    return bin < kBins - 1 ? static_cast<unsigned>(std::max(bin, 0.0f)) : kBins - 1;
+                }
+
+                std::vector<Ref>& refs; // Грани, переставляемые по участкам
+                const LoadProgress* progress; // Запрос отмены
+        };
+
+        // Пересечение луча с параллелепипедом; возвращает вход луча или
+        // бесконечность, если луч проходит мимо или дальше limit
+        float enter_box(const MeshBvh::Node& node, const glm::vec3& origin,
+                        const glm::vec3& inverse, float limit){
+            glm::vec3 t0 = (node.min - origin) * inverse;
+            glm::vec3 t1 = (node.max - origin) * inverse;
+            glm::vec3 near = glm::min(t0, t1);
+            glm::vec3 far = glm::max(t0, t1);
+            float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+            float exit = std::min(std::min(far.x, far.y), std::min(far.z, limit));
+            return enter <= exit ? enter : std::numeric_limits<float>::infinity();
+        }
+
+        // Пересечение луча с треугольником (Моллер - Трумбор)
+        bool hit_triangle(const glm::vec3& origin, const glm::vec3& direction,
+                          const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float& t){
+            glm::vec3 ab = b - a;
+            glm::vec3 ac = c - a;
+            glm::vec3 p = glm::cross(direction, ac);
+            float det = glm::dot(ab, p);
+            if(det == 0.0f){
+                return false;
+            }
+            float inv_det = 1.0f / det;
+            glm::vec3 s = origin - a;
+            float u = glm::dot(s, p) * inv_det;
+            if(u < 0.0f || u > 1.0f){
+                return false;
+            }
+            glm::vec3 q = glm::cross(s, ab);
+            float v = glm::dot(direction, q) * inv_det;
+            if(v < 0.0f || u + v > 1.0f){
+                return false;
+            }
+            t = glm::dot(ac, q) * inv_det;
+            return t >= 0.0f;
+        }
+
+        // 1 - параллелепипед внутри всех плоскостей, 0 - пересекает, -1 - снаружи
+        int classify(const glm::vec3& min, const glm::vec3& max,
+                     const glm::vec4* planes, size_t plane_count){
+            int result = 1;
+            for(size_t i = 0; i < plane_count; ++i){
+                glm::vec3 n(planes[i]);
+                glm::vec3 far(n.x >= 0.0f ? max.x : min.x, n.y >= 0.0f ? max.y : min.y,
+                              n.z >= 0.0f ? max.z : min.z);
+                if(glm::dot(n, far) + planes[i].w < 0.0f){
+                    return -1;
+                }
+                glm::vec3 near(n.x >= 0.0f ? min.x : max.x, n.y >= 0.0f ? min.y : max.y,
+                               n.z >= 0.0f ? min.z : max.z);
+                if(glm::dot(n, near) + planes[i].w < 0.0f){
+                    result = 0;
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    void MeshBvh::build(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                        size_t threads, const LoadProgress* progress){
+        clear();
+        size_t face_count = faces.size();
+        std::vector<Ref> refs(face_count);
+        ThreadPool& pool = ThreadPool::shared();
+        size_t parts = parts_for(face_count, threads, kMinParallelFaces);
+        pool.parallel_for(face_count, parts, [&](size_t begin, size_t end){
+            for(size_t f = begin; f < end; ++f){
+                bool valid = face_box(vertices, count, faces[f], refs[f].box);
+                refs[f].face = valid ? static_cast<uint32_t>(f) : kNoFace;
+            }
+        });
+        refs.erase(std::remove_if(refs.begin(), refs.end(),
+                                  [](const Ref& ref){ return ref.face == kNoFace; }),
+                   refs.end());
+        if(refs.empty() || cancelled(progress)){
+            return;
+        }
+
+        Builder builder(refs, progress);
+        Task root{0, 0, static_cast<uint32_t>(refs.size()), 0, Box(), Box()};
+        measure(refs, root);
+        // Примерно 2 * faces / kLeafSize узлов; запас не перевыделяется
+        nodes.reserve(2 * refs.size() / kLeafSize + 1);
+        nodes.resize(1);
+        if(parts == 1){
+            builder.subdivide(nodes, root, 0, nullptr);
+        } else {
+            // Верхние уровни строятся последовательно, пока участки не
+            // станут достаточно мелкими, чтобы их хватило на все потоки
+            std::vector<Task> pending;
+            builder.subdivide(nodes, root, std::max(kMinParallelFaces, refs.size() / (parts * 4)),
+                              &pending);
+            std::vector<std::vector<Node>> subtrees(pending.size());
+            pool.parallel_for(pending.size(), parts, [&](size_t begin, size_t end){
+                for(size_t i = begin; i < end; ++i){
+                    Task task = pending[i];
+                    task.node = 0;
+                    subtrees[i].reserve(2 * (task.end - task.begin) / kLeafSize + 1);
+                    subtrees[i].resize(1);
+                    builder.subdivide(subtrees[i], task, 0, nullptr);
+                }
+            });
+
+            // Корень поддерева встает на место отложенного узла, остальные
+            // узлы дописываются в конец со сдвигом индексов потомков
+            for(size_t i = 0; i < pending.size(); ++i){
+                const std::vector<Node>& subtree = subtrees[i];
+                uint32_t offset = static_cast<uint32_t>(nodes.size()) - 1;
+                auto relocate = [offset](Node node){
+                    if(node.count == 0){
+                        node.first += offset;
+                    }
+                    return node;
+                };
+                nodes[pending[i].node] = relocate(subtree[0]);
+                for(size_t j = 1; j < subtree.size(); ++j){
+                    nodes.push_back(relocate(subtree[j]));
+                }
+            }
+        }
+
+        if(cancelled(progress)){
+            nodes.clear();
+            return;
+        }
+        order.resize(refs.size());
+        for(size_t i = 0; i < refs.size(); ++i){
+            order[i] = refs[i].face;
+        }
+    }
+
+    void MeshBvh::refit(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                        size_t threads){
+        // Сначала листья (независимо друг от друга), затем внутренние узлы
+        // от конца к началу: потомки всегда стоят после родителя
+        size_t parts = parts_for(order.size(), threads, kMinParallelFaces);
+        ThreadPool::shared().parallel_for(nodes.size(), parts, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                Node& node = nodes[i];
+                if(node.count == 0){
+                    continue;
+                }
+                Box bounds;
+                for(uint32_t k = node.first; k < node.first + node.count; ++k){
+                    Box box;
+                    face_box(vertices, count, faces[order[k]], box);
+                    bounds.grow(box);
+                }
+                node.min = bounds.min;
+                node.max = bounds.max;
+            }
+        });
+        for(size_t i = nodes.size(); i-- > 0;){
+            Node& node = nodes[i];
+            if(node.count == 0){
+                const Node& left = nodes[node.first];
+                const Node& right = nodes[node.first + 1];
+                node.min = glm::min(left.min, right.min);
+                node.max = glm::max(left.max, right.max);
+            }
+        }
+    }
+
+    bool MeshBvh::ray_pick(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                           const glm::vec3& origin, const glm::vec3& direction, Hit& hit) const {
+        if(nodes.empty()){
+            return false;
+        }
+        glm::vec3 inverse = 1.0f / direction;
+        float best = std::numeric_limits<float>::infinity();
+        uint32_t best_face = 0;
+        uint32_t stack[kStackSize];
+        size_t top = 0;
+        if(enter_box(nodes[0], origin, inverse, best) != best){
+            stack[top++] = 0;
+        }
+        while(top != 0){
+            const Node& node = nodes[stack[--top]];
+            if(node.count != 0){
+                for(uint32_t k = node.first; k < node.first + node.count; ++k){
+                    FaceList::face_type face = faces[order[k]];
+                    if(face.size() < 3 || face[0] >= count){
+                        continue;
+                    }
+                    const glm::vec3& a = vertices[face[0]];
+                    for(size_t i = 1; i + 1 < face.size(); ++i){
+                        if(face[i] >= count || face[i + 1] >= count){
+                            continue;
+                        }
+                        float t;
+                        if(hit_triangle(origin, direction, a, vertices[face[i]],
+                                        vertices[face[i + 1]], t) && t < best){
+                            best = t;
+                            best_face = order[k];
+                        }
+                    }
+                }
+                continue;
+            }
+            // Ближний потомок кладется последним, чтобы быть проверенным первым
+            float left = enter_box(nodes[node.first], origin, inverse, best);
+            float right = enter_box(nodes[node.first + 1], origin, inverse, best);
+            uint32_t near = node.first;
+            uint32_t far = node.first + 1;
+            if(right < left){
+                std::swap(left, right);
+                std::swap(near, far);
+            }
+            if(right < best){
+                stack[top++] = far;
+            }
+            if(left < best){
+                stack[top++] = near;
+            }
+        }
+        if(best == std::numeric_limits<float>::infinity()){
+            return false;
+        }
+
+        hit.face = best_face;
+        hit.distance = best;
+        hit.point = origin + best * direction;
+        float nearest = std::numeric_limits<float>::max();
+        for(uint32_t index : faces[best_face]){
+            if(index < count){
+                glm::vec3 d = vertices[index] - hit.point;
+                float distance = glm::dot(d, d);
+                if(distance < nearest){
+                    nearest = distance;
+                    hit.vertex = index;
+                }
+            }
+        }
+        return true;
+    }
+
+    void MeshBvh::query(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                        const glm::vec4* planes, size_t plane_count,
+                        std::vector<uint32_t>& result) const {
+        if(nodes.empty()){
+            return;
+        }
+        uint32_t stack[kStackSize];
+        size_t top = 0;
+        stack[top++] = 0;
+        while(top != 0){
+            uint32_t entry = stack[--top];
+            bool inside = (entry & kInside) != 0;
+            const Node& node = nodes[entry & ~kInside];
+            if(!inside){
+                int side = classify(node.min, node.max, planes, plane_count);
+                if(side < 0){
+                    continue;
+                }
+                inside = side > 0;
+            }
+            if(node.count == 0){
+                uint32_t flag = inside ? kInside : 0;
+                stack[top++] = (node.first + 1) | flag;
+                stack[top++] = node.first | flag;
+                continue;
+            }
+            for(uint32_t k = node.first; k < node.first + node.count; ++k){
+                Box box;
+                if(inside || (face_box(vertices, count, faces[order[k]], box) &&
+                              classify(box.min, box.max, planes, plane_count) >= 0)){
+                    result.push_back(order[k]);
+                }
+            }
+        }
+    }
+
+    void MeshBvh::frustum_planes(const glm::mat4& clip, glm::vec4 planes[6]){
+        // Строки матрицы (glm хранит столбцы): точка внутри, если
+        // -w <= x, y, z <= w в пространстве отсечения
+        glm::vec4 rows[4];
+        for(int i = 0; i < 4; ++i){
+            rows[i] = glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+        }
+        for(int i = 0; i < 3; ++i){
+            planes[2 * i] = rows[3] + rows[i];
+            planes[2 * i + 1] = rows[3] - rows[i];
+        }
+    }
+
+    void MeshBvh::box_planes(const glm::vec3& min, const glm::vec3& max, glm::vec4 planes[6]){
+        for(int axis = 0; axis < 3; ++axis){
+            glm::vec4 normal(0.0f);
+            normal[axis] = 1.0f;
+            planes[2 * axis] = normal;
+            planes[2 * axis].w = -min[axis];
+            planes[2 * axis + 1] = -normal;
+            planes[2 * axis + 1].w = max[axis];
+        }
+    }
+} // namespace s21
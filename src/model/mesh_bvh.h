@@ -0,0 +1,164 @@
+#ifndef SRC_MODEL_MESH_BVH_H
+#define SRC_MODEL_MESH_BVH_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "face_list.h"
+#include "load_progress.h"
+
+namespace s21 {
+    /**
+     * @brief Иерархия ограничивающих объемов (BVH) над гранями модели.
+     *
+     * Каждый узел хранит параллелепипед, охватывающий все грани поддерева, а
+     * лист - непрерывный участок переставленного списка граней. Поиск
+     * грани под лучом и выбор граней в области спускаются только в узлы,
+     * которые задевает запрос, и вместо O(N) занимают примерно O(log N).
+     *
+     * Дерево строится разбиением по поверхностной эвристике (SAH) с
+     * корзинами; верхние уровни строятся последовательно, а поддеревья под
+     * ними - параллельно в общем пуле потоков. Когда вершины двигаются, а
+     * грани те же, дерево не перестраивается: refit пересчитывает только
+     * параллелепипеды узлов.
+     *
+     * Дерево не хранит геометрию: вершины и грани передаются в каждый метод
+     * и должны совпадать с теми, по которым оно построено.
+     */
+    class MeshBvh {
+        public:
+            /**
+             * @brief Узел дерева (32 байта).
+             */
+            struct Node {
+                glm::vec3 min; // Нижний угол параллелепипеда
+                uint32_t first = 0; // Лист: начало участка граней; узел: индекс левого потомка
+                glm::vec3 max; // Верхний угол параллелепипеда
+                uint32_t count = 0; // Лист: число граней; 0 у внутреннего узла
+            };
+
+            /**
+             * @brief Результат поиска грани под лучом.
+             */
+            struct Hit {
+                uint32_t face = 0; // Номер грани
+                uint32_t vertex = 0; // Ближайшая к точке попадания вершина грани (отсчет с нуля)
+                float distance = 0.0f; // Параметр луча: точка = origin + distance * direction
+                glm::vec3 point = glm::vec3(0.0f); // Точка попадания
+            };
+
+            static constexpr uint32_t kLeafSize = 4; // Граней в листе, меньше которых узел не делится
+            static constexpr size_t kMinParallelFaces = 1 << 15; // Минимум граней на поток построения
+
+            /**
+             * @brief Строит дерево заново.
+             *
+             * Грани без вершин в диапазоне [1, count] в дерево не входят.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param faces Грани с индексами вершин с нуля.
+             * @param threads Число потоков; 0 - по размеру общего пула.
+             * @param progress Запрос отмены (может отсутствовать); после
+             * отмены дерево остается пустым.
+             */
+            void build(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                       size_t threads = 0, const LoadProgress* progress = nullptr);
+
+            /**
+             * @brief Пересчитывает параллелепипеды после перемещения вершин.
+             *
+             * Структура дерева не меняется, поэтому после сильных деформаций
+             * запросы могут замедлиться; для поворотов, переносов и
+             * масштабирования качество дерева сохраняется.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param faces Грани, по которым построено дерево.
+             * @param threads Число потоков; 0 - по размеру общего пула.
+             */
+            void refit(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                       size_t threads = 0);
+
+            /**
+             * @brief Ищет ближайшую грань, которую пересекает луч.
+             *
+             * Многоугольники разбиваются на треугольники веером; отрезки и
+             * точки лучом не выбираются.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param faces Грани, по которым построено дерево.
+             * @param origin Начало луча.
+             * @param direction Направление луча (не обязательно единичное).
+             * @param hit Результат, если грань найдена.
+             * @return true, если луч пересекает хотя бы одну грань.
+             */
+            bool ray_pick(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                          const glm::vec3& origin, const glm::vec3& direction, Hit& hit) const;
+
+            /**
+             * @brief Выбирает грани в выпуклой области.
+             *
+             * Область задается плоскостями (a, b, c, d): точка внутри, если
+             * a*x + b*y + c*z + d >= 0 для каждой плоскости. Грань выбирается,
+             * если ее параллелепипед не лежит целиком снаружи одной из
+             * плоскостей, поэтому у края области могут попасть лишние грани.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param faces Грани, по которым построено дерево.
+             * @param planes Плоскости области.
+             * @param plane_count Количество плоскостей.
+             * @param result Номера выбранных граней (дописываются в конец).
+             */
+            void query(const glm::vec3* vertices, size_t count, const FaceList& faces,
+                       const glm::vec4* planes, size_t plane_count,
+                       std::vector<uint32_t>& result) const;
+
+            /**
+             * @brief Извлекает плоскости пирамиды видимости из матрицы.
+             *
+             * @param clip Произведение матриц проекции, вида и модели.
+             * @param planes Шесть плоскостей (лево, право, низ, верх, ближняя, дальняя).
+             */
+            static void frustum_planes(const glm::mat4& clip, glm::vec4 planes[6]);
+
+            /**
+             * @brief Задает параллелепипед шестью плоскостями.
+             *
+             * @param min Нижний угол.
+             * @param max Верхний угол.
+             * @param planes Шесть плоскостей граней параллелепипеда.
+             */
+            static void box_planes(const glm::vec3& min, const glm::vec3& max, glm::vec4 planes[6]);
+
+            /**
+             * @brief Проверяет, построено ли дерево.
+             *
+             * @return true, если в дереве нет ни одной грани.
+             */
+            bool empty() const { return nodes.empty(); }
+
+            /**
+             * @brief Очищает дерево.
+             */
+            void clear() {
+                nodes.clear();
+                order.clear();
+            }
+
+            /**
+             * @brief Возвращает узлы дерева; корень - первый узел.
+             *
+             * @return Узлы дерева.
+             */
+            const std::vector<Node>& get_nodes() const { return nodes; }
+
+        private:
+            std::vector<Node> nodes; // Узлы; потомки всегда идут после родителя
+            std::vector<uint32_t> order; // Номера граней в порядке листьев
+    };
+} // namespace s21
+#endif
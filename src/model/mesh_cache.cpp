@@ -0,0 +1,264 @@
+#include "mesh_cache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace s21 {
+
+    namespace {
+        constexpr char kMagic[8] = {'S', '2', '1', 'M', 'E', 'S', 'H', '\0'};
+        constexpr uint32_t kByteOrder = 0x01020304;
+        constexpr const char* kExtension = ".s21mesh";
+        // Путь дополняется нулями до кратного 8 байт, чтобы вершины и
+        // индексы в отображенном файле были выровнены и читались на месте
+        constexpr size_t kPathAlignment = 8;
+
+        size_t padded(size_t length){
+            return (length + kPathAlignment - 1) / kPathAlignment * kPathAlignment;
+        }
+
+        // FNV-1a: имя файла кэша по полному пути источника
+        uint64_t hash_path(const std::string& path){
+            uint64_t hash = 14695981039346656037ull;
+            for(unsigned char c : path){
+                hash = (hash ^ c) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        int64_t modification_time(const struct stat& info){
+#ifdef __APPLE__
+            return static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+            return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+        }
+
+        // Смещения граней не убывают и доходят до index_count, индексы
+        // меньше числа вершин: иначе ребра, куски и дерево граней читали
+        // бы за границами массивов
+        bool valid_faces(const FaceList::index_type* offsets, uint64_t face_count,
+                         const FaceList::index_type* indices, uint64_t index_count, uint64_t vertex_count){
+            if(offsets[0] != 0 || offsets[face_count] != index_count){
+                return false;
+            }
+            for(uint64_t i = 0; i < face_count; ++i){
+                if(offsets[i] > offsets[i + 1]){
+                    return false;
+                }
+            }
+            for(uint64_t i = 0; i < index_count; ++i){
+                if(indices[i] >= vertex_count){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Создает каталог вместе с недостающими родительскими
+        bool make_directories(const std::string& path){
+            for(size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)){
+                std::string part = path.substr(0, slash);
+                if(mkdir(part.c_str(), 0755) != 0 && errno != EEXIST){
+                    return false;
+                }
+                if(slash == std::string::npos){
+                    return true;
+                }
+            }
+        }
+    } // namespace
+
+    MeshCache::MeshCache(){
+        if(const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0'){
+            cache_directory = std::string(xdg) + "/3dViewer";
+        } else if(const char* home = std::getenv("HOME"); home != nullptr && *home != '\0'){
+            cache_directory = std::string(home) + "/.cache/3dViewer";
+        }
+    }
+
+    bool MeshCache::make_key(const std::string& source, Key& key){
+        char resolved[PATH_MAX];
+        struct stat info;
+        if(realpath(source.c_str(), resolved) == nullptr || stat(resolved, &info) != 0 ||
+           !S_ISREG(info.st_mode)){
+            return false;
+        }
+        key.path = resolved;
+        key.size = static_cast<uint64_t>(info.st_size);
+        key.mtime = modification_time(info);
+        return true;
+    }
+
+    std::string MeshCache::path_for(const Key& key) const {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash_path(key.path)));
+        return cache_directory + "/" + name + kExtension;
+    }
+
+    std::string MeshCache::cache_path(const std::string& source) const {
+        Key key;
+        if(cache_directory.empty() || !make_key(source, key)){
+            return std::string();
+        }
+        return path_for(key);
+    }
+
+    bool MeshCache::load(const std::string& source, Model& model) const {
+        Key key;
+        if(cache_directory.empty() || !make_key(source, key)){
+            return false;
+        }
+        MappedFile file(path_for(key).c_str());
+        if(!file.is_open() || file.size() < sizeof(Header)){
+            return false;
+        }
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(Header));
+        if(std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+           header.byte_order != kByteOrder || header.source_size != key.size ||
+           header.source_mtime != key.mtime || header.path_length != key.path.size()){
+            return false;
+        }
+        // Размеры разделов проверяются до чтения, чтобы испорченный файл не
+        // приводил к выходу за границы отображения. Счетчики сначала
+        // сравниваются с размером файла, чтобы их произведения не переполнялись
+        uint64_t available = file.size() - sizeof(Header);
+        if(header.path_length > available || header.vertex_count > available / sizeof(glm::vec3) ||
+           header.face_count >= available / sizeof(FaceList::index_type) ||
+           header.index_count > available / sizeof(FaceList::index_type)){
+            return false;
+        }
+        size_t vertex_bytes = header.vertex_count * sizeof(glm::vec3);
+        size_t offset_bytes = (header.face_count + 1) * sizeof(FaceList::index_type);
+        size_t index_bytes = header.index_count * sizeof(FaceList::index_type);
+        if(file.size() != sizeof(Header) + padded(header.path_length) + vertex_bytes + offset_bytes + index_bytes){
+            return false;
+        }
+        const char* p = file.data() + sizeof(Header);
+        if(std::memcmp(p, key.path.data(), key.path.size()) != 0){
+            return false;
+        }
+        p += padded(header.path_length);
+
+        // Разделы выровнены по 4 байта, поэтому данные копируются в модель
+        // прямо из отображения, без промежуточных буферов
+        const glm::vec3* vertices = reinterpret_cast<const glm::vec3*>(p);
+        const FaceList::index_type* offsets = reinterpret_cast<const FaceList::index_type*>(p + vertex_bytes);
+        const FaceList::index_type* indices = offsets + header.face_count + 1;
+        if(!valid_faces(offsets, header.face_count, indices, header.index_count, header.vertex_count)){
+            return false;
+        }
+        model.load_normalized(vertices, header.vertex_count, offsets, header.face_count, indices);
+        // Время изменения файла кэша - время последнего использования для evict
+        utime(path_for(key).c_str(), nullptr);
+        return true;
+    }
+
+    bool MeshCache::store(const std::string& source, const Model& model) const {
+        Key key;
+        if(cache_directory.empty() || !make_key(source, key) || !make_directories(cache_directory)){
+            return false;
+        }
+        MeshView view = model.view();
+        const FaceList& faces = *view.faces;
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.byte_order = kByteOrder;
+        header.source_size = key.size;
+        header.source_mtime = key.mtime;
+        header.path_length = key.path.size();
+        header.vertex_count = view.vertices.size();
+        header.face_count = faces.size();
+        header.index_count = faces.index_data().size();
+        uint64_t file_bytes = sizeof(header) + padded(key.path.size()) +
+                              header.vertex_count * sizeof(glm::vec3) +
+                              (header.face_count + 1 + header.index_count) * sizeof(FaceList::index_type);
+        if(file_bytes > size_limit){
+            return false;
+        }
+
+        std::string target = path_for(key);
+        std::string temporary = target + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            std::string path = key.path;
+            path.resize(padded(path.size()), '\0');
+            out.write(path.data(), static_cast<std::streamsize>(path.size()));
+            out.write(reinterpret_cast<const char*>(view.vertices.data()),
+                      static_cast<std::streamsize>(view.vertices.size() * sizeof(glm::vec3)));
+            out.write(reinterpret_cast<const char*>(faces.offset_data().data()),
+                      static_cast<std::streamsize>(faces.offset_data().size() * sizeof(FaceList::index_type)));
+            out.write(reinterpret_cast<const char*>(faces.index_data().data()),
+                      static_cast<std::streamsize>(faces.index_data().size() * sizeof(FaceList::index_type)));
+            if(!out.flush()){
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        if(std::rename(temporary.c_str(), target.c_str()) != 0){
+            std::remove(temporary.c_str());
+            return false;
+        }
+        evict(target);
+        return true;
+    }
+
+    void MeshCache::evict(const std::string& keep) const {
+        struct Entry {
+            std::string path; // Путь к файлу кэша
+            uint64_t size; // Размер файла
+            int64_t used; // Время последней загрузки, нс
+        };
+        DIR* directory = opendir(cache_directory.c_str());
+        if(directory == nullptr){
+            return;
+        }
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        const size_t extension_length = std::strlen(kExtension);
+        while(const dirent* entry = readdir(directory)){
+            std::string name = entry->d_name;
+            if(name.size() <= extension_length ||
+               name.compare(name.size() - extension_length, extension_length, kExtension) != 0){
+                continue;
+            }
+            std::string path = cache_directory + "/" + name;
+            struct stat info;
+            if(stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)){
+                continue;
+            }
+            total += static_cast<uint64_t>(info.st_size);
+            if(path != keep){
+                entries.push_back({path, static_cast<uint64_t>(info.st_size), modification_time(info)});
+            }
+        }
+        closedir(directory);
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b){ return a.used < b.used; });
+        for(const Entry& entry : entries){
+            if(total <= size_limit){
+                break;
+            }
+            if(std::remove(entry.path.c_str()) == 0){
+                total -= entry.size;
+            }
+        }
+    }
+} // namespace s21
@@ -0,0 +1,164 @@
+#ifndef SRC_MODEL_MESH_CACHE_H
+#define SRC_MODEL_MESH_CACHE_H
+#include <cstdint>
+#include <string>
+
+#include "model.h"
+
+namespace s21 {
+    /**
+     * @brief Двоичный кэш разобранных моделей.
+     *
+     * После первого разбора OBJ нормализованные вершины и грани в формате
+     * CSR сохраняются в файл каталога кэша. При повторной загрузке того же
+     * файла (тот же полный путь, размер и время изменения) кэш отображается
+     * в память и копируется в модель без разбора текста и нормализации.
+     *
+     * Общий размер файлов кэша ограничен (set_limit): после записи нового
+     * файла удаляются давно не загружавшиеся, пока кэш не уложится в
+     * предел. Время изменения файла кэша обновляется при каждой загрузке
+     * и служит временем последнего использования.
+     *
+     * Формат файла: заголовок Header, полный путь к источнику (дополненный
+     * нулями до кратного 8 байт), затем вершины (float x 3), смещения граней
+     * и индексы (uint32_t; с версии 2 - с нуля). Все числа хранятся в
+     * порядке байтов машины, записавшей кэш; файл другой версии или с
+     * другим порядком байтов считается недействительным, как и файл, чьи
+     * смещения граней убывают или индексы выходят за число вершин.
+     */
+    class MeshCache {
+        public:
+            static constexpr uint32_t kVersion = 3; // Версия формата
+            static constexpr uint64_t kDefaultLimit = 2ull << 30; // Предел размера кэша по умолчанию, байт
+
+            /**
+             * @brief Заголовок файла кэша.
+             */
+            struct Header {
+                char magic[8]; // "S21MESH" и нулевой байт
+                uint32_t version; // Версия формата
+                uint32_t byte_order; // 0x01020304 в порядке байтов записавшей машины
+                uint64_t source_size; // Размер исходного файла
+                int64_t source_mtime; // Время изменения исходного файла, нс
+                uint64_t path_length; // Длина пути к исходному файлу
+                uint64_t vertex_count; // Количество вершин
+                uint64_t face_count; // Количество граней
+                uint64_t index_count; // Количество индексов во всех гранях
+            };
+
+            /**
+             * @brief Создает кэш в каталоге по умолчанию.
+             *
+             * Каталог: $XDG_CACHE_HOME/3dViewer или ~/.cache/3dViewer.
+             */
+            MeshCache();
+
+            /**
+             * @brief Создает кэш в заданном каталоге.
+             *
+             * @param directory Каталог кэша; пустая строка отключает кэш.
+             */
+            explicit MeshCache(std::string directory) : cache_directory(std::move(directory)) {}
+
+            /**
+             * @brief Задает каталог кэша.
+             *
+             * @param directory Каталог кэша; пустая строка отключает кэш.
+             */
+            void set_directory(std::string directory) { cache_directory = std::move(directory); }
+
+            /**
+             * @brief Возвращает каталог кэша.
+             *
+             * @return Каталог кэша.
+             */
+            const std::string& directory() const { return cache_directory; }
+
+            /**
+             * @brief Задает предел общего размера файлов кэша.
+             *
+             * Модель больше предела не сохраняется; 0 - ничего не сохранять.
+             *
+             * @param bytes Предел в байтах.
+             */
+            void set_limit(uint64_t bytes) { size_limit = bytes; }
+
+            /**
+             * @brief Возвращает предел общего размера файлов кэша.
+             *
+             * @return Предел в байтах.
+             */
+            uint64_t limit() const { return size_limit; }
+
+            /**
+             * @brief Загружает модель из кэша, если он действителен.
+             *
+             * @param source Путь к исходному OBJ.
+             * @param model Модель, в которую загружаются данные.
+             * @return true, если кэш найден и совпадает с исходным файлом.
+             */
+            bool load(const std::string& source, Model& model) const;
+
+            /**
+             * @brief Сохраняет только что загруженную модель в кэш.
+             *
+             * Файл пишется во временный и затем переименовывается, поэтому
+             * читатель никогда не видит недописанный кэш. После записи
+             * удаляются давно не загружавшиеся файлы сверх предела.
+             *
+             * @param source Путь к исходному OBJ.
+             * @param model Модель сразу после Model::read_file.
+             * @return true, если кэш записан; false, если кэш отключен,
+             * модель больше предела или файл не удалось записать.
+             */
+            bool store(const std::string& source, const Model& model) const;
+
+            /**
+             * @brief Возвращает путь к файлу кэша для исходного файла.
+             *
+             * @param source Путь к исходному OBJ.
+             * @return Путь к файлу кэша или пустая строка, если кэш отключен
+             * или исходный файл недоступен.
+             */
+            std::string cache_path(const std::string& source) const;
+
+        private:
+            /**
+             * @brief Ключ исходного файла: полный путь, размер и время изменения.
+             */
+            struct Key {
+                std::string path; // Полный путь
+                uint64_t size = 0; // Размер
+                int64_t mtime = 0; // Время изменения, нс
+            };
+
+            /**
+             * @brief Вычисляет ключ исходного файла.
+             *
+             * @param source Путь к исходному файлу.
+             * @param key Куда записать ключ.
+             * @return false, если файл недоступен.
+             */
+            static bool make_key(const std::string& source, Key& key);
+
+            /**
+             * @brief Возвращает путь к файлу кэша для ключа.
+             *
+             * @param key Ключ исходного файла.
+             * @return Путь к файлу кэша.
+             */
+            std::string path_for(const Key& key) const;
+
+            /**
+             * @brief Удаляет давно не загружавшиеся файлы сверх предела.
+             *
+             * @param keep Файл, который остается в любом случае (только что
+             * записанный).
+             */
+            void evict(const std::string& keep) const;
+
+            std::string cache_directory; // Каталог кэша
+            uint64_t size_limit = kDefaultLimit; // Предел общего размера файлов, байт
+    };
+} // namespace s21
+#endif
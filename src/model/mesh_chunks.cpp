@@ -0,0 +1,209 @@
+#include "mesh_chunks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "cell_map.h"
+#include "mesh_bvh.h"
+#include "vertex_kernels.h"
+
+namespace s21 {
+
+    namespace {
+        // Предел сетки по оси: больше кусков не окупается числом вызовов
+        constexpr unsigned kMaxResolution = 256;
+
+        // Ячейки сетки над параллелепипедом модели
+        class Grid {
+            public:
+                Grid(const VertexKernels::Bounds& bounds, unsigned resolution)
+                    : origin(bounds.min), cells(resolution) {
+                    glm::vec3 range = bounds.max - bounds.min;
+                    float extent = std::max(range.x, std::max(range.y, range.z));
+                    scale = extent > 0.0f ? resolution / extent : 0.0f;
+                }
+
+                uint64_t key(const glm::vec3& point) const {
+                    glm::vec3 p = (point - origin) * scale;
+                    uint64_t x = cell(p.x);
+                    uint64_t y = cell(p.y);
+                    uint64_t z = cell(p.z);
+                    return (z * cells + y) * cells + x;
+                }
+
+            private:
+                uint32_t cell(float value) const {
+                    return std::min(static_cast<uint32_t>(std::max(value, 0.0f)), cells - 1);
+                }
+
+                glm::vec3 origin; // Нижний угол сетки
+                float scale; // Ячеек на единицу длины
+                uint32_t cells; // Ячеек по оси
+        };
+
+        // Куб с углами min и max лежит снаружи одной из плоскостей
+        bool outside(const glm::vec3& min, const glm::vec3& max, const glm::vec4* planes){
+            for(int i = 0; i < 6; ++i){
+                glm::vec3 n(planes[i]);
+                glm::vec3 far(n.x >= 0.0f ? max.x : min.x, n.y >= 0.0f ? max.y : min.y,
+                              n.z >= 0.0f ? max.z : min.z);
+                if(glm::dot(n, far) + planes[i].w < 0.0f){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Размер проекции куба на экран меньше пикселя по обеим осям
+        bool subpixel(const glm::vec3& min, const glm::vec3& max, const glm::mat4& mvp,
+                      float width, float height){
+            glm::vec3 lo(std::numeric_limits<float>::max());
+            glm::vec3 hi(-std::numeric_limits<float>::max());
+            for(int corner = 0; corner < 8; ++corner){
+                glm::vec4 clip = mvp * glm::vec4(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y,
+                                                 corner & 4 ? max.z : min.z, 1.0f);
+                if(clip.w <= 0.0f){
+                    // Куб задевает плоскость камеры: размер на экране не ограничен
+                    return false;
+                }
+                glm::vec3 ndc = glm::vec3(clip) / clip.w;
+                lo = glm::min(lo, ndc);
+                hi = glm::max(hi, ndc);
+            }
+            return (hi.x - lo.x) * width * 0.5f < 1.0f && (hi.y - lo.y) * height * 0.5f < 1.0f;
+        }
+
+        // Дописывает диапазон, сливая его с предыдущим, если они соседние
+        void append_range(std::vector<MeshChunks::Range>& ranges, uint32_t first, uint32_t count){
+            if(count == 0){
+                return;
+            }
+            if(!ranges.empty() && ranges.back().first + ranges.back().count == first){
+                ranges.back().count += count;
+            } else {
+                ranges.push_back({first, count});
+            }
+        }
+    } // namespace
+
+    void MeshChunks::build(const glm::vec3* vertices, size_t count, const std::vector<uint32_t>& source){
+        clear();
+        if(count == 0){
+            return;
+        }
+        // Поверхность занимает порядка resolution^2 ячеек сетки, поэтому
+        // разрешение подбирается по квадратному корню из числа кусков
+        size_t pairs = source.size() / 2;
+        size_t target = std::max<size_t>(1, pairs / kTargetEdges);
+        unsigned resolution = std::min<unsigned>(kMaxResolution,
+                                                 static_cast<unsigned>(std::ceil(std::sqrt(static_cast<double>(target)))));
+        Grid grid(VertexKernels::reduce(vertices, count), std::max(resolution, 1u));
+        CellMap cell_map(target * 2);
+
+        // Номер куска для каждого ребра и вершины в порядке первой встречи
+        std::vector<uint32_t> edge_chunk(pairs);
+        std::vector<uint32_t> point_chunk(count);
+        std::vector<uint32_t> edge_counts;
+        std::vector<uint32_t> point_counts;
+        auto chunk_of = [&](const glm::vec3& point){
+            uint32_t next = static_cast<uint32_t>(edge_counts.size());
+            uint32_t id = cell_map.find_or_insert(grid.key(point), next);
+            if(id == next){
+                edge_counts.push_back(0);
+                point_counts.push_back(0);
+            }
+            return id;
+        };
+        for(size_t i = 0; i < pairs; ++i){
+            glm::vec3 middle = (vertices[source[2 * i]] + vertices[source[2 * i + 1]]) * 0.5f;
+            edge_chunk[i] = chunk_of(middle);
+            edge_counts[edge_chunk[i]] += 2;
+        }
+        for(size_t v = 0; v < count; ++v){
+            point_chunk[v] = chunk_of(vertices[v]);
+            ++point_counts[point_chunk[v]];
+        }
+
+        // Сортировка подсчетом: каждый кусок получает свой участок массивов
+        chunks.resize(edge_counts.size());
+        uint32_t edge_offset = 0;
+        uint32_t point_offset = 0;
+        for(size_t c = 0; c < chunks.size(); ++c){
+            chunks[c].first_edge = edge_offset;
+            chunks[c].edge_count = edge_counts[c];
+            chunks[c].first_point = point_offset;
+            chunks[c].point_count = point_counts[c];
+            edge_offset += edge_counts[c];
+            point_offset += point_counts[c];
+            edge_counts[c] = chunks[c].first_edge;
+            point_counts[c] = chunks[c].first_point;
+        }
+        edges.resize(pairs * 2);
+        points.resize(count);
+        for(size_t i = 0; i < pairs; ++i){
+            uint32_t& slot = edge_counts[edge_chunk[i]];
+            edges[slot] = source[2 * i];
+            edges[slot + 1] = source[2 * i + 1];
+            slot += 2;
+        }
+        for(size_t v = 0; v < count; ++v){
+            points[point_counts[point_chunk[v]]++] = static_cast<uint32_t>(v);
+        }
+        refit(vertices, count);
+    }
+
+    void MeshChunks::refit(const glm::vec3* vertices, size_t count){
+        for(Chunk& chunk : chunks){
+            glm::vec3 lo(std::numeric_limits<float>::max());
+            glm::vec3 hi(-std::numeric_limits<float>::max());
+            for(uint32_t i = chunk.first_edge; i < chunk.first_edge + chunk.edge_count; ++i){
+                if(edges[i] < count){
+                    lo = glm::min(lo, vertices[edges[i]]);
+                    hi = glm::max(hi, vertices[edges[i]]);
+                }
+            }
+            for(uint32_t i = chunk.first_point; i < chunk.first_point + chunk.point_count; ++i){
+                if(points[i] < count){
+                    lo = glm::min(lo, vertices[points[i]]);
+                    hi = glm::max(hi, vertices[points[i]]);
+                }
+            }
+            chunk.min = lo;
+            chunk.max = hi;
+        }
+    }
+
+    MeshChunks::Stats MeshChunks::cull(const glm::mat4& mvp, float width, float height, bool cull_small,
+                                       std::vector<Range>& edge_ranges,
+                                       std::vector<Range>& point_ranges) const {
+        glm::vec4 planes[6];
+        MeshBvh::frustum_planes(mvp, planes);
+
+        Stats stats;
+        stats.chunks = chunks.size();
+        edge_ranges.clear();
+        point_ranges.clear();
+        for(const Chunk& chunk : chunks){
+            bool culled = true;
+            if(outside(chunk.min, chunk.max, planes)){
+                ++stats.culled_frustum;
+            } else if(cull_small && subpixel(chunk.min, chunk.max, mvp, width, height)){
+                ++stats.culled_small;
+            } else {
+                culled = false;
+            }
+            if(culled){
+                stats.edges_culled += chunk.edge_count / 2;
+                stats.points_culled += chunk.point_count;
+                continue;
+            }
+            ++stats.drawn;
+            stats.edges_drawn += chunk.edge_count / 2;
+            stats.points_drawn += chunk.point_count;
+            append_range(edge_ranges, chunk.first_edge, chunk.edge_count);
+            append_range(point_ranges, chunk.first_point, chunk.point_count);
+        }
+        return stats;
+    }
+} // namespace s21
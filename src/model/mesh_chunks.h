@@ -0,0 +1,130 @@
+#ifndef SRC_MODEL_MESH_CHUNKS_H
+#define SRC_MODEL_MESH_CHUNKS_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+namespace s21 {
+    /**
+     * @brief Разбиение каркаса модели на пространственные куски для отсечения.
+     *
+     * Пространство модели делится сеткой; ребро относится к ячейке своей
+     * середины, вершина - к своей ячейке. Ребра и вершины переставляются
+     * так, что у каждого куска они идут подряд, поэтому видимые куски
+     * рисуются диапазонами одного буфера индексов, а соседние видимые куски
+     * сливаются в один вызов отрисовки.
+     *
+     * На каждом кадре куски, чей параллелепипед лежит вне пирамиды
+     * видимости, пропускаются; по желанию пропускаются и куски, которые на
+     * экране меньше пикселя. Стоимость кадра тогда зависит от видимой части
+     * модели, а не от ее размера.
+     */
+    class MeshChunks {
+        public:
+            /**
+             * @brief Кусок модели.
+             */
+            struct Chunk {
+                glm::vec3 min; // Нижний угол параллелепипеда
+                uint32_t first_edge = 0; // Начало ребер в edge_indices() (в индексах)
+                glm::vec3 max; // Верхний угол параллелепипеда
+                uint32_t edge_count = 0; // Число индексов ребер (по два на ребро)
+                uint32_t first_point = 0; // Начало вершин в point_indices()
+                uint32_t point_count = 0; // Число вершин
+            };
+
+            /**
+             * @brief Непрерывный диапазон буфера индексов для отрисовки.
+             */
+            struct Range {
+                uint32_t first; // Первый индекс
+                uint32_t count; // Число индексов
+            };
+
+            /**
+             * @brief Итог отсечения одного кадра.
+             */
+            struct Stats {
+                size_t chunks = 0; // Всего кусков
+                size_t drawn = 0; // Нарисовано кусков
+                size_t culled_frustum = 0; // Отброшено вне пирамиды видимости
+                size_t culled_small = 0; // Отброшено как меньшие пикселя
+                size_t edges_drawn = 0; // Нарисовано ребер
+                size_t edges_culled = 0; // Отброшено ребер
+                size_t points_drawn = 0; // Нарисовано вершин
+                size_t points_culled = 0; // Отброшено вершин
+            };
+
+            static constexpr size_t kTargetEdges = 1 << 13; // Желаемое число ребер в куске
+
+            /**
+             * @brief Разбивает каркас на куски.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param edges Уникальные ребра (пары индексов с нуля).
+             */
+            void build(const glm::vec3* vertices, size_t count, const std::vector<uint32_t>& edges);
+
+            /**
+             * @brief Пересчитывает параллелепипеды кусков после перемещения вершин.
+             *
+             * Состав кусков не меняется.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             */
+            void refit(const glm::vec3* vertices, size_t count);
+
+            /**
+             * @brief Отбирает куски, видимые на кадре.
+             *
+             * @param mvp Матрица модели-вида-проекции.
+             * @param width Ширина области вывода в пикселях.
+             * @param height Высота области вывода в пикселях.
+             * @param cull_small Отбрасывать ли куски меньше пикселя.
+             * @param edge_ranges Диапазоны edge_indices() для отрисовки (заменяются).
+             * @param point_ranges Диапазоны point_indices() для отрисовки (заменяются).
+             * @return Число нарисованных и отброшенных кусков, ребер и вершин.
+             */
+            Stats cull(const glm::mat4& mvp, float width, float height, bool cull_small,
+                       std::vector<Range>& edge_ranges, std::vector<Range>& point_ranges) const;
+
+            /**
+             * @brief Возвращает куски.
+             *
+             * @return Куски модели.
+             */
+            const std::vector<Chunk>& get_chunks() const { return chunks; }
+
+            /**
+             * @brief Возвращает ребра, упорядоченные по кускам.
+             *
+             * @return Пары индексов вершин для GL_LINES.
+             */
+            const std::vector<uint32_t>& edge_indices() const { return edges; }
+
+            /**
+             * @brief Возвращает номера вершин, упорядоченные по кускам.
+             *
+             * @return Индексы вершин для GL_POINTS.
+             */
+            const std::vector<uint32_t>& point_indices() const { return points; }
+
+            /**
+             * @brief Очищает разбиение.
+             */
+            void clear() {
+                chunks.clear();
+                edges.clear();
+                points.clear();
+            }
+
+        private:
+            std::vector<Chunk> chunks; // Куски модели
+            std::vector<uint32_t> edges; // Ребра по кускам
+            std::vector<uint32_t> points; // Вершины по кускам
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,74 @@
+#ifndef SRC_MODEL_MESH_FORMAT_H
+#define SRC_MODEL_MESH_FORMAT_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace s21 {
+    /**
+     * @brief Формат файла модели.
+     */
+    enum class MeshFormat {
+        kObj,       // Текстовый Wavefront OBJ
+        kStlBinary, // Двоичный STL
+        kStlAscii,  // Текстовый STL
+        kPly        // PLY (разбирается двоичный little-endian)
+    };
+
+    /**
+     * @brief Определяет формат файла по первым байтам и размеру.
+     *
+     * PLY начинается со строки "ply". Двоичный STL узнается по размеру:
+     * 84 байта заголовка и по 50 байт на каждый из объявленных в нем
+     * треугольников; проверка идет раньше текстового STL, потому что
+     * заголовок двоичного тоже часто начинается со слова "solid". Текстовый
+     * STL начинается с "solid", за которым в начале файла идет "facet"
+     * (или "endsolid" у пустого тела).
+     *
+     * Некоторые программы дописывают байты после треугольников, поэтому
+     * файл не текстового STL длиннее объявленных треугольников тоже
+     * считается двоичным STL, если в его первой записи есть нулевой байт
+     * (в текстовых OBJ и STL их не бывает). Все остальное считается OBJ.
+     *
+     * @param data Начало файла.
+     * @param size Размер файла в байтах.
+     * @return Формат файла.
+     */
+    inline MeshFormat detect_mesh_format(const char* data, size_t size){
+        if(size >= 4 && std::memcmp(data, "ply", 3) == 0 && (data[3] == '\n' || data[3] == '\r')){
+            return MeshFormat::kPly;
+        }
+        uint64_t binary_size = ~uint64_t(0);
+        if(size >= 84){
+            uint32_t triangles;
+            std::memcpy(&triangles, data + 80, sizeof(triangles));
+            binary_size = 84 + uint64_t(50) * triangles;
+            if(size == binary_size){
+                return MeshFormat::kStlBinary;
+            }
+        }
+        size_t start = 0;
+        while(start < size && (data[start] == ' ' || data[start] == '\t' ||
+                               data[start] == '\r' || data[start] == '\n')){
+            ++start;
+        }
+        bool solid = size - start >= 5 && std::memcmp(data + start, "solid", 5) == 0;
+        if(solid){
+            // Первая грань или конец тела ищутся в начале файла: строка
+            // "solid" с именем короче этого окна
+            constexpr size_t kProbeBytes = 1024;
+            size_t probe_end = std::min(size, start + kProbeBytes);
+            for(size_t i = start + 5; i + 5 <= probe_end; ++i){
+                if(std::memcmp(data + i, "facet", 5) == 0 || std::memcmp(data + i, "endso", 5) == 0){
+                    return MeshFormat::kStlAscii;
+                }
+            }
+        }
+        if(size > binary_size && binary_size > 84 && std::memchr(data, '\0', 84 + 50) != nullptr){
+            return MeshFormat::kStlBinary;
+        }
+        return solid ? MeshFormat::kStlAscii : MeshFormat::kObj;
+    }
+} // namespace s21
+#endif
@@ -0,0 +1,156 @@
+#include "mesh_lod.h"
+
+#include <algorithm>
+
+#include "cell_map.h"
+#include "edge_list.h"
+#include "thread_pool.h"
+#include "vertex_kernels.h"
+
+namespace s21 {
+
+    namespace {
+        // Как часто (в вершинах) проверяется запрос отмены
+        constexpr size_t kCancelCheckStep = 1 << 16;
+        // Вершины делятся на части не меньше этой; число частей зависит
+        // только от числа вершин, поэтому уровень не зависит от числа ядер
+        constexpr size_t kMinPartVertices = 1 << 16;
+        constexpr size_t kMaxParts = 16;
+
+        inline bool cancelled(const LoadProgress* progress){
+            return progress != nullptr && progress->cancelled();
+        }
+
+        // Ячейки одной части вершин в порядке первой встречи
+        struct PartCells {
+            std::vector<uint64_t> keys; // Номер ячейки по местному номеру
+            std::vector<uint32_t> members; // Число вершин в ячейке
+            std::vector<double> sums; // Суммы координат (x y z по ячейке)
+            std::vector<uint32_t> global; // Общий номер ячейки по местному
+        };
+    } // namespace
+
+    LodLevel MeshLod::cluster(const glm::vec3* vertices, size_t count,
+                              const std::vector<uint32_t>& edges, unsigned resolution,
+                              const LoadProgress* progress){
+        LodLevel level;
+        level.resolution = resolution;
+        if(count == 0 || resolution == 0){
+            return level;
+        }
+        VertexKernels::Bounds bounds = VertexKernels::reduce(vertices, count);
+        glm::vec3 range = bounds.max - bounds.min;
+        float extent = std::max(range.x, std::max(range.y, range.z));
+        float scale = extent > 0.0f ? resolution / extent : 0.0f;
+        uint64_t cells = resolution;
+        uint32_t last = resolution - 1;
+        // Оценка числа занятых ячеек: поверхность сетки, но не больше вершин
+        size_t expected = std::min<size_t>(count, 8 * cells * cells);
+
+        // Каждая часть вершин собирает свои ячейки и суммы; map временно
+        // хранит местные номера ячеек
+        size_t parts = std::min(kMaxParts, std::max<size_t>(1, count / kMinPartVertices));
+        size_t part_size = (count + parts - 1) / parts;
+        std::vector<PartCells> part_cells(parts);
+        std::vector<uint32_t> map(count);
+        ThreadPool& pool = ThreadPool::shared();
+        pool.parallel_for(parts, parts, [&](size_t first, size_t last_part){
+            for(size_t part = first; part < last_part; ++part){
+                size_t begin = part * part_size;
+                size_t end = std::min(count, begin + part_size);
+                PartCells& local = part_cells[part];
+                CellMap cell_map(std::min(end - begin, expected));
+                for(size_t i = begin; i < end; ++i){
+                    if((i - begin) % kCancelCheckStep == 0 && cancelled(progress)){
+                        return;
+                    }
+                    glm::vec3 p = (vertices[i] - bounds.min) * scale;
+                    uint64_t x = std::min(static_cast<uint32_t>(std::max(p.x, 0.0f)), last);
+                    uint64_t y = std::min(static_cast<uint32_t>(std::max(p.y, 0.0f)), last);
+                    uint64_t z = std::min(static_cast<uint32_t>(std::max(p.z, 0.0f)), last);
+                    uint64_t key = (z * cells + y) * cells + x;
+                    uint32_t next = static_cast<uint32_t>(local.members.size());
+                    uint32_t id = cell_map.find_or_insert(key, next);
+                    if(id == next){
+                        local.keys.push_back(key);
+                        local.members.push_back(0);
+                        local.sums.resize(local.sums.size() + 3, 0.0);
+                    }
+                    map[i] = id;
+                    ++local.members[id];
+                    for(int k = 0; k < 3; ++k){
+                        local.sums[3 * id + k] += vertices[i][k];
+                    }
+                }
+            }
+        });
+        if(cancelled(progress)){
+            return LodLevel();
+        }
+
+        // Части сливаются по порядку, поэтому общие номера идут в порядке
+        // первой встречи ячейки в модели, как при проходе подряд. Ячеек в
+        // частях много меньше, чем вершин
+        CellMap cell_map(expected);
+        std::vector<uint32_t> members;
+        std::vector<double> sums;
+        for(PartCells& local : part_cells){
+            local.global.resize(local.keys.size());
+            for(size_t id = 0; id < local.keys.size(); ++id){
+                uint32_t next = static_cast<uint32_t>(members.size());
+                uint32_t global = cell_map.find_or_insert(local.keys[id], next);
+                if(global == next){
+                    members.push_back(0);
+                    sums.resize(sums.size() + 3, 0.0);
+                }
+                local.global[id] = global;
+                members[global] += local.members[id];
+                for(int k = 0; k < 3; ++k){
+                    sums[3 * global + k] += local.sums[3 * id + k];
+                }
+            }
+        }
+        if(parts > 1){
+            pool.parallel_for(parts, parts, [&](size_t first, size_t last_part){
+                for(size_t part = first; part < last_part; ++part){
+                    const std::vector<uint32_t>& global = part_cells[part].global;
+                    size_t end = std::min(count, (part + 1) * part_size);
+                    for(size_t i = part * part_size; i < end; ++i){
+                        map[i] = global[map[i]];
+                    }
+                }
+            });
+        }
+
+        // Вершина кластера - среднее его вершин
+        level.vertices.resize(members.size());
+        for(size_t id = 0; id < members.size(); ++id){
+            for(int k = 0; k < 3; ++k){
+                level.vertices[id][k] = static_cast<float>(sums[3 * id + k] / members[id]);
+            }
+        }
+        if(cancelled(progress)){
+            return LodLevel();
+        }
+        level.edges = EdgeList::remap(edges, map);
+        return level;
+    }
+
+    std::vector<LodLevel> MeshLod::build(const glm::vec3* vertices, size_t count,
+                                         const std::vector<uint32_t>& edges,
+                                         const Settings& settings,
+                                         const LoadProgress* progress){
+        std::vector<unsigned> resolutions = settings.resolutions;
+        std::sort(resolutions.begin(), resolutions.end());
+        // Уровни строятся по очереди: каждый сам делит вершины между
+        // потоками пула, а задачи пула не могут вызывать parallel_for
+        std::vector<LodLevel> levels(resolutions.size());
+        for(size_t i = 0; i < levels.size() && !cancelled(progress); ++i){
+            levels[i] = cluster(vertices, count, edges, resolutions[i], progress);
+        }
+        if(cancelled(progress)){
+            levels.clear();
+        }
+        return levels;
+    }
+} // namespace s21
@@ -0,0 +1,83 @@
+#ifndef SRC_MODEL_MESH_LOD_H
+#define SRC_MODEL_MESH_LOD_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "load_progress.h"
+
+namespace s21 {
+    /**
+     * @brief Один уровень детализации: упрощенный каркас модели.
+     */
+    struct LodLevel {
+        unsigned resolution = 0; // Число ячеек сетки по длинной оси
+        std::vector<glm::vec3> vertices; // Вершины (по одной на ячейку)
+        std::vector<uint32_t> edges; // Пары индексов вершин для GL_LINES
+        uint64_t generation = 0; // Номер сборки уровня (для загрузки в видеопамять)
+    };
+
+    /**
+     * @brief Построение уровней детализации кластеризацией вершин.
+     *
+     * Ограничивающий параллелепипед модели делится на кубические ячейки;
+     * все вершины ячейки заменяются их средним, а ребра переводятся на новые
+     * вершины (вырожденные и повторные ребра удаляются). Чем мельче сетка,
+     * тем ближе уровень к исходной модели и тем дольше он строится.
+     * Кластеризация не сохраняет топологию, но работает за линейное время и
+     * подходит для показа модели во время вращения и перемещения.
+     */
+    class MeshLod {
+        public:
+            /**
+             * @brief Настройки построения уровней.
+             */
+            struct Settings {
+                // Разрешения сеток от грубого к точному; пустой список
+                // отключает уровни детализации
+                std::vector<unsigned> resolutions = {64, 128, 256};
+                // Модели с меньшим числом граней рисуются целиком всегда
+                size_t min_faces = size_t(1) << 18;
+            };
+
+            /**
+             * @brief Строит один уровень детализации.
+             *
+             * Вершины делятся на части (не больше 16, от 65536 вершин в
+             * части), каждая часть считает ячейки и суммы координат в своем
+             * потоке общего пула, затем части сливаются по порядку. Число
+             * частей зависит только от числа вершин, поэтому результат не
+             * зависит от числа ядер. Вызывать не из задачи того же пула.
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param edges Уникальные ребра модели (пары индексов с нуля).
+             * @param resolution Число ячеек по длинной оси параллелепипеда.
+             * @param progress Запрос отмены (может отсутствовать).
+             * @return Уровень детализации; пустой, если построение отменено.
+             */
+            static LodLevel cluster(const glm::vec3* vertices, size_t count,
+                                    const std::vector<uint32_t>& edges, unsigned resolution,
+                                    const LoadProgress* progress = nullptr);
+
+            /**
+             * @brief Строит уровни для всех разрешений из настроек.
+             *
+             * Уровни строятся по очереди, каждый параллельно (см. cluster).
+             *
+             * @param vertices Вершины модели.
+             * @param count Количество вершин.
+             * @param edges Уникальные ребра модели (пары индексов с нуля).
+             * @param settings Настройки построения.
+             * @param progress Запрос отмены (может отсутствовать).
+             * @return Уровни от грубого к точному; пустой список, если
+             * построение отменено.
+             */
+            static std::vector<LodLevel> build(const glm::vec3* vertices, size_t count,
+                                               const std::vector<uint32_t>& edges,
+                                               const Settings& settings,
+                                               const LoadProgress* progress = nullptr);
+    };
+} // namespace s21
+#endif
@@ -0,0 +1,189 @@
+#include "mesh_reorder.h"
+
+namespace s21 {
+
+    namespace {
+        constexpr uint32_t kNone = ~uint32_t(0);
+    } // namespace
+
+    MeshReorder::Stats MeshReorder::optimize(std::vector<glm::vec3>& vertices, FaceList& faces,
+                                             unsigned cache_size){
+        Stats stats;
+        stats.acmr_before = acmr(faces, vertices.size(), cache_size);
+        // Предварительная нумерация по первому использованию: обход вееров
+        // читает данные вершин соседних граней, и на разбросанном файле
+        // без нее почти каждое обращение - промах кэша процессора
+        order_vertices(vertices, faces);
+        std::vector<uint32_t> order = face_order(faces, vertices.size(), cache_size);
+        FaceList reordered;
+        reordered.reserve(faces.size(), faces.index_data().size());
+        for(uint32_t f : order){
+            FaceList::face_type face = faces[f];
+            reordered.push_face(face.begin(), face.size());
+        }
+        faces = std::move(reordered);
+        order_vertices(vertices, faces);
+        stats.acmr_after = acmr(faces, vertices.size(), cache_size);
+        return stats;
+    }
+
+    std::vector<uint32_t> MeshReorder::face_order(const FaceList& faces, size_t vertex_count,
+                                                  unsigned cache_size){
+        size_t face_count = faces.size();
+        // Грани каждой вершины (CSR); live - сколько их еще не выдано
+        std::vector<uint32_t> live(vertex_count, 0);
+        for(const auto face : faces){
+            for(uint32_t v : face){
+                if(v < vertex_count){
+                    ++live[v];
+                }
+            }
+        }
+        std::vector<uint32_t> start(vertex_count + 1, 0);
+        for(size_t v = 0; v < vertex_count; ++v){
+            start[v + 1] = start[v] + live[v];
+        }
+        std::vector<uint32_t> adjacency(start[vertex_count]);
+        {
+            std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+            for(size_t f = 0; f < face_count; ++f){
+                for(uint32_t v : faces[f]){
+                    if(v < vertex_count){
+                        adjacency[cursor[v]++] = static_cast<uint32_t>(f);
+                    }
+                }
+            }
+        }
+
+        // Вершина в кэше, если с ее попадания туда прошло не больше
+        // cache_size промахов
+        std::vector<uint32_t> cache_time(vertex_count, 0);
+        uint32_t time = cache_size + 1;
+        std::vector<uint8_t> emitted(face_count, 0);
+        std::vector<uint32_t> order;
+        order.reserve(face_count);
+        std::vector<uint32_t> dead_end; // Вершины выданных граней, последние сверху
+        std::vector<uint32_t> candidates; // Вершины граней последнего веера
+        size_t input = 0; // Следующая вершина для поиска по порядку файла
+
+        uint32_t fan = kNone;
+        while(input < vertex_count && live[input] == 0){
+            ++input;
+        }
+        if(input < vertex_count){
+            fan = static_cast<uint32_t>(input);
+        }
+        while(fan != kNone){
+            // Все еще не выданные грани вокруг вершины
+            candidates.clear();
+            for(uint32_t a = start[fan]; a < start[fan + 1]; ++a){
+                uint32_t f = adjacency[a];
+                if(emitted[f]){
+                    continue;
+                }
+                emitted[f] = 1;
+                order.push_back(f);
+                for(uint32_t v : faces[f]){
+                    if(v >= vertex_count){
+                        continue;
+                    }
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if(time - cache_time[v] > cache_size){
+                        cache_time[v] = time;
+                        ++time;
+                    }
+                }
+            }
+
+            // Следующий веер - вокруг вершины, которая останется в кэше и
+            // после своих граней (на грань приходится около двух новых вершин)
+            fan = kNone;
+            long best = -1;
+            for(uint32_t v : candidates){
+                if(live[v] == 0){
+                    continue;
+                }
+                long priority = 0;
+                if(time - cache_time[v] + 2 * live[v] <= cache_size){
+                    priority = time - cache_time[v];
+                }
+                if(priority > best){
+                    best = priority;
+                    fan = v;
+                }
+            }
+            if(fan != kNone){
+                continue;
+            }
+            // Тупик: сначала недавно использованные вершины, потом по файлу
+            while(!dead_end.empty()){
+                uint32_t v = dead_end.back();
+                dead_end.pop_back();
+                if(live[v] != 0){
+                    fan = v;
+                    break;
+                }
+            }
+            if(fan == kNone){
+                while(input < vertex_count && live[input] == 0){
+                    ++input;
+                }
+                if(input < vertex_count){
+                    fan = static_cast<uint32_t>(input);
+                }
+            }
+        }
+        for(size_t f = 0; f < face_count; ++f){
+            if(!emitted[f]){
+                order.push_back(static_cast<uint32_t>(f));
+            }
+        }
+        return order;
+    }
+
+    void MeshReorder::order_vertices(std::vector<glm::vec3>& vertices, FaceList& faces){
+        size_t count = vertices.size();
+        std::vector<uint32_t> map(count, kNone);
+        uint32_t next = 0;
+        for(uint32_t v : faces.indices){
+            if(v < count && map[v] == kNone){
+                map[v] = next++;
+            }
+        }
+        for(size_t v = 0; v < count; ++v){
+            if(map[v] == kNone){
+                map[v] = next++;
+            }
+        }
+        for(uint32_t& v : faces.indices){
+            if(v < count){
+                v = map[v];
+            }
+        }
+        std::vector<glm::vec3> result(count);
+        for(size_t v = 0; v < count; ++v){
+            result[map[v]] = vertices[v];
+        }
+        vertices.swap(result);
+    }
+
+    double MeshReorder::acmr(const FaceList& faces, size_t vertex_count, unsigned cache_size){
+        std::vector<uint32_t> cache_time(vertex_count, 0);
+        uint32_t time = cache_size + 1;
+        size_t misses = 0;
+        size_t triangles = 0;
+        for(const auto face : faces){
+            triangles += face.size() > 2 ? face.size() - 2 : 0;
+            for(uint32_t v : face){
+                if(v < vertex_count && time - cache_time[v] > cache_size){
+                    cache_time[v] = time;
+                    ++time;
+                    ++misses;
+                }
+            }
+        }
+        return triangles != 0 ? static_cast<double>(misses) / triangles : 0.0;
+    }
+} // namespace s21
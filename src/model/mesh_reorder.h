@@ -0,0 +1,90 @@
+#ifndef SRC_MODEL_MESH_REORDER_H
+#define SRC_MODEL_MESH_REORDER_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "face_list.h"
+
+namespace s21 {
+    /**
+     * @brief Переупорядочивание граней и вершин для локальности обращений.
+     *
+     * В выгрузках сканеров грани и вершины часто идут вразброс: соседние
+     * в файле грани далеки на поверхности, а их вершины разбросаны по
+     * массиву. Тогда кэш вершин видеокарты после преобразования почти не
+     * попадает, а проходы по граням (ребра, дерево граней, куски) читают
+     * вершины из случайных мест памяти.
+     *
+     * Грани переставляются алгоритмом Tipsify (Sander, Nehab, Barczak,
+     * 2007): грани обходятся веерами вокруг вершин, и следующей выбирается
+     * вершина, которая еще в модельном кэше FIFO и у которой остались
+     * необойденные грани. Время линейное, многоугольники обходятся целиком.
+     * Затем вершины нумеруются в порядке первого использования гранями, и
+     * соседние на поверхности вершины оказываются рядом в памяти. Такая же
+     * нумерация делается и до обхода: на разбросанном файле она втрое
+     * ускоряет сам обход. Вершины без граней уходят в конец в прежнем
+     * порядке; состав граней и вершин не меняется.
+     */
+    class MeshReorder {
+        public:
+            /**
+             * @brief Итог прохода.
+             */
+            struct Stats {
+                double acmr_before = 0.0; // Промахов кэша вершин на треугольник до прохода
+                double acmr_after = 0.0; // Промахов кэша вершин на треугольник после прохода
+            };
+
+            static constexpr unsigned kCacheSize = 16; // Размер модельного кэша вершин
+
+            /**
+             * @brief Переставляет грани и вершины модели.
+             *
+             * @param vertices Вершины; переставляются в порядке первого использования.
+             * @param faces Грани; переставляются и переводятся на новые номера вершин.
+             * @param cache_size Размер модельного кэша вершин.
+             * @return Промахи кэша до и после прохода.
+             */
+            static Stats optimize(std::vector<glm::vec3>& vertices, FaceList& faces,
+                                  unsigned cache_size = kCacheSize);
+
+            /**
+             * @brief Находит порядок граней для кэша вершин (Tipsify).
+             *
+             * Индексы вне [0, vertex_count) пропускаются; грани без
+             * допустимых индексов идут в конце в прежнем порядке.
+             *
+             * @param faces Грани.
+             * @param vertex_count Количество вершин.
+             * @param cache_size Размер модельного кэша вершин.
+             * @return Номера граней в новом порядке.
+             */
+            static std::vector<uint32_t> face_order(const FaceList& faces, size_t vertex_count,
+                                                    unsigned cache_size = kCacheSize);
+
+            /**
+             * @brief Нумерует вершины в порядке первого использования гранями.
+             *
+             * @param vertices Вершины; переставляются.
+             * @param faces Грани; индексы переводятся на новые номера.
+             */
+            static void order_vertices(std::vector<glm::vec3>& vertices, FaceList& faces);
+
+            /**
+             * @brief Считает промахи модельного кэша FIFO на треугольник.
+             *
+             * Многоугольник из n вершин считается за n - 2 треугольника.
+             * Около 0.5 - хороший порядок треугольной сетки, 3 - худший.
+             *
+             * @param faces Грани.
+             * @param vertex_count Количество вершин.
+             * @param cache_size Размер модельного кэша вершин.
+             * @return Среднее число промахов на треугольник (0 без граней).
+             */
+            static double acmr(const FaceList& faces, size_t vertex_count,
+                               unsigned cache_size = kCacheSize);
+    };
+} // namespace s21
+#endif
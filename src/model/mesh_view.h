@@ -0,0 +1,71 @@
+#ifndef SRC_MODEL_MESH_VIEW_H
+#define SRC_MODEL_MESH_VIEW_H
+#include <cstddef>
+#include <cstdint>
+#include <glm/ext.hpp>
+
+#include "face_list.h"
+
+namespace s21 {
+    /**
+     * @brief Представление геометрии модели только для чтения.
+     *
+     * MeshView не владеет данными: он указывает прямо на хранилище Model и
+     * остается валидным до следующего изменения модели. Поколения позволяют
+     * потребителю (например, отрисовщику) понять, изменились ли вершины или
+     * топология с прошлого обращения, не сравнивая сами данные. Матрица
+     * модели применяется при отрисовке и не меняет поколение вершин.
+     */
+    struct MeshView {
+        Span<const glm::vec3> vertices; // Вершины модели
+        const FaceList* faces = nullptr; // Грани модели
+        uint64_t geometry_generation = 0; // Поколение координат вершин
+        uint64_t topology_generation = 0; // Поколение состава вершин и граней
+        glm::mat4 model_matrix = glm::mat4(1.0f); // Еще не примененные к вершинам преобразования
+    };
+
+    /**
+     * @brief Отслеживает изменения модели между кадрами.
+     *
+     * Хранит поколения, для которых данные уже были обработаны (например,
+     * загружены в видеопамять), и сообщает, что нужно обновить. Не выделяет
+     * память.
+     */
+    class MeshViewTracker {
+        public:
+            /**
+             * @brief Что изменилось с прошлой синхронизации.
+             */
+            struct Changes {
+                bool vertices = false; // Изменились координаты вершин
+                bool topology = false; // Изменились грани или число вершин
+            };
+
+            /**
+             * @brief Сравнивает представление с уже обработанным состоянием.
+             *
+             * @param view Текущее представление модели.
+             * @return Список изменений; после вызова состояние считается обработанным.
+             */
+            Changes sync(const MeshView& view) {
+                Changes changes;
+                changes.vertices = !valid || view.geometry_generation != geometry_generation;
+                changes.topology = !valid || view.topology_generation != topology_generation;
+                geometry_generation = view.geometry_generation;
+                topology_generation = view.topology_generation;
+                valid = true;
+                return changes;
+            }
+
+            /**
+             * @brief Сбрасывает состояние, например после потери контекста OpenGL.
+             */
+            void invalidate() { valid = false; }
+
+        private:
+            uint64_t geometry_generation = 0; // Обработанное поколение вершин
+            uint64_t topology_generation = 0; // Обработанное поколение топологии
+            bool valid = false; // Было ли что-то обработано
+    };
+} // namespace s21
+#endif
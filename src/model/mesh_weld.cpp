@@ -0,0 +1,165 @@
+#include "mesh_weld.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "cell_map.h"
+#include "thread_pool.h"
+#include "vertex_kernels.h"
+
+namespace s21 {
+
+    namespace {
+        constexpr uint32_t kNone = ~uint32_t(0);
+        constexpr unsigned kCellBits = 21; // Бит на номер ячейки по оси
+        constexpr uint32_t kMaxCell = (1u << kCellBits) - 2; // С запасом под соседа справа
+
+        // Флаги соседних ячеек, до которых от вершины ближе epsilon
+        constexpr uint8_t kLower = 1;
+        constexpr uint8_t kUpper = 2;
+
+        inline uint64_t pack(const uint32_t cell[3]){
+            return uint64_t(cell[0]) | uint64_t(cell[1]) << kCellBits | uint64_t(cell[2]) << (2 * kCellBits);
+        }
+    } // namespace
+
+    MeshWeld::Stats MeshWeld::compact(std::vector<glm::vec3>& vertices, FaceList& faces,
+                                      float epsilon, size_t threads){
+        Stats stats;
+        size_t count = vertices.size();
+        stats.vertices_before = count;
+        ThreadPool& pool = ThreadPool::shared();
+        size_t parts = std::max<size_t>(1, std::min(threads != 0 ? threads : pool.size(),
+                                                    count / kMinParallelVertices));
+        std::vector<FaceList::index_type>& indices = faces.indices;
+
+        // Вершины, на которые ссылается хотя бы одна грань
+        std::vector<std::atomic<uint8_t>> referenced(count);
+        pool.parallel_for(indices.size(), parts, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                if(indices[i] < count){
+                    referenced[indices[i]].store(1, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        // Ячейка каждой вершины: не меньше 8 epsilon, чтобы соседние ячейки
+        // приходилось смотреть редко (промах в таблице - основная цена
+        // прохода), и не больше 2^20 ячеек по оси
+        epsilon = std::max(epsilon, 0.0f);
+        VertexKernels::Bounds bounds = VertexKernels::reduce(vertices.data(), count);
+        glm::vec3 range = bounds.max - bounds.min;
+        float extent = std::max(range.x, std::max(range.y, range.z));
+        float size = std::max(8.0f * epsilon, extent / float(1u << 20));
+        float inverse = size > 0.0f ? 1.0f / size : 1.0f;
+        float margin = epsilon * inverse;
+        std::vector<uint64_t> keys(count);
+        std::vector<uint8_t> near(count);
+        pool.parallel_for(count, parts, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                uint32_t cell[3];
+                uint8_t flags = 0;
+                for(int k = 0; k < 3; ++k){
+                    float t = std::min(std::max(0.0f, (vertices[i][k] - bounds.min[k]) * inverse),
+                                       float(kMaxCell - 1));
+                    float floor = std::floor(t);
+                    cell[k] = static_cast<uint32_t>(floor) + 1;
+                    // За границами модели ячеек нет (плоская модель лежит
+                    // на границе своей ячейки по третьей оси)
+                    float last = (bounds.max[k] - bounds.min[k]) * inverse;
+                    if(t - floor <= margin && t > 0.0f){
+                        flags |= kLower << (2 * k);
+                    }
+                    if(floor + 1.0f - t <= margin && floor + 1.0f <= last){
+                        flags |= kUpper << (2 * k);
+                    }
+                }
+                keys[i] = pack(cell);
+                near[i] = flags;
+            }
+        });
+
+        // Сварка: вершина ищет уже оставленную вершину не дальше epsilon в
+        // своей и соседних ячейках; ячейка хранит список своих вершин.
+        // Своя ячейка заводится сразу, чтобы поиск и вставка шли одной
+        // пробой таблицы
+        float epsilon2 = epsilon * epsilon;
+        CellMap cells(count);
+        std::vector<uint32_t> head; // Последняя оставленная вершина ячейки
+        std::vector<uint32_t> next; // Предыдущая оставленная вершина той же ячейки
+        std::vector<uint32_t> kept; // Старый номер каждой оставленной вершины
+        std::vector<uint32_t> map(count, kNone);
+        head.reserve(count);
+        next.reserve(count);
+        kept.reserve(count);
+        size_t used = 0;
+        auto search = [&](uint32_t id, const glm::vec3& vertex){
+            for(uint32_t r = head[id]; r != kNone; r = next[r]){
+                glm::vec3 d = vertices[kept[r]] - vertex;
+                if(glm::dot(d, d) <= epsilon2){
+                    return r;
+                }
+            }
+            return kNone;
+        };
+        for(size_t i = 0; i < count; ++i){
+            if(referenced[i].load(std::memory_order_relaxed) == 0){
+                continue;
+            }
+            ++used;
+            const glm::vec3 vertex = vertices[i];
+            uint32_t own = cells.find_or_insert(keys[i], static_cast<uint32_t>(head.size()));
+            if(own == head.size()){
+                head.push_back(kNone);
+            }
+            uint32_t found = search(own, vertex);
+            if(found == kNone && near[i] != 0){
+                int from[3], to[3];
+                for(int k = 0; k < 3; ++k){
+                    from[k] = near[i] & (kLower << (2 * k)) ? -1 : 0;
+                    to[k] = near[i] & (kUpper << (2 * k)) ? 1 : 0;
+                }
+                for(int dz = from[2]; dz <= to[2] && found == kNone; ++dz){
+                    for(int dy = from[1]; dy <= to[1] && found == kNone; ++dy){
+                        for(int dx = from[0]; dx <= to[0] && found == kNone; ++dx){
+                            if(dx == 0 && dy == 0 && dz == 0){
+                                continue;
+                            }
+                            // Номера ячеек не меньше 1, поэтому сдвиг не заденет соседнее поле
+                            uint32_t id = cells.find(keys[i] + int64_t(dx) + (int64_t(dy) << kCellBits) +
+                                                     (int64_t(dz) << (2 * kCellBits)));
+                            if(id != CellMap::kMissing){
+                                found = search(id, vertex);
+                            }
+                        }
+                    }
+                }
+            }
+            if(found == kNone){
+                found = static_cast<uint32_t>(kept.size());
+                kept.push_back(static_cast<uint32_t>(i));
+                next.push_back(head[own]);
+                head[own] = found;
+            }
+            map[i] = found;
+        }
+        stats.vertices_after = kept.size();
+        stats.unreferenced = count - used;
+        stats.welded = used - kept.size();
+
+        pool.parallel_for(indices.size(), parts, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                indices[i] = indices[i] < count ? map[indices[i]] : kNone;
+            }
+        });
+        std::vector<glm::vec3> result(kept.size());
+        pool.parallel_for(kept.size(), parts, [&](size_t begin, size_t end){
+            for(size_t i = begin; i < end; ++i){
+                result[i] = vertices[kept[i]];
+            }
+        });
+        vertices.swap(result);
+        return stats;
+    }
+} // namespace s21
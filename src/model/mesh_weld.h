@@ -0,0 +1,61 @@
+#ifndef SRC_MODEL_MESH_WELD_H
+#define SRC_MODEL_MESH_WELD_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "face_list.h"
+
+namespace s21 {
+    /**
+     * @brief Сварка близких вершин и удаление вершин без граней.
+     *
+     * Экспортеры часто пишут общую вершину соседних граней несколько раз, а
+     * вершины, на которые не ссылается ни одна грань, оставляют в файле;
+     * модель хранит, преобразует и рисует их все. Проход оставляет по одной
+     * вершине на группу вершин, лежащих не дальше epsilon друг от друга,
+     * выбрасывает вершины без граней и переводит индексы граней на новые
+     * номера. Вершины сохраняют порядок первой встречи в файле.
+     *
+     * Поиск соседей идет по пространственной хеш-сетке (CellMap) с ячейкой
+     * не меньше 8 epsilon: вершина сравнивается с вершинами своей ячейки и
+     * только тех соседних, до границы с которыми ближе epsilon. Сама сварка
+     * последовательна и поэтому не зависит от числа потоков; пометка
+     * используемых вершин, расчет ячеек, перевод индексов и сборка новых
+     * вершин для больших моделей идут параллельно.
+     */
+    class MeshWeld {
+        public:
+            /**
+             * @brief Итог прохода.
+             */
+            struct Stats {
+                size_t vertices_before = 0; // Вершин до прохода
+                size_t vertices_after = 0; // Вершин после прохода
+                size_t welded = 0; // Вершин, слитых с более ранними
+                size_t unreferenced = 0; // Вершин без граней (удалены)
+            };
+
+            static constexpr size_t kMinParallelVertices = 1 << 16; // Минимум вершин на поток
+
+            /**
+             * @brief Сваривает вершины и удаляет неиспользуемые.
+             *
+             * Индексы граней вне [0, vertices.size()) остаются недопустимыми
+             * (становятся ~0). Вершина группы - первая по порядку в файле;
+             * группы не объединяются цепочкой: вершина, далекая от первой,
+             * начинает свою группу.
+             *
+             * @param vertices Вершины; заменяются уцелевшими.
+             * @param faces Грани; индексы переводятся на новые вершины.
+             * @param epsilon Наибольшее расстояние между свариваемыми
+             * вершинами; 0 сваривает только точно совпадающие.
+             * @param threads Число потоков; 0 означает число ядер процессора.
+             * @return Число вершин до и после прохода.
+             */
+            static Stats compact(std::vector<glm::vec3>& vertices, FaceList& faces,
+                                 float epsilon, size_t threads = 0);
+    };
+} // namespace s21
+#endif
@@ -1,75 +1,398 @@
 #include "model.h"
 
+#include <atomic>
+#include <utility>
+
+#include "mapped_file.h"
+#include "obj_parser.h"
+#include "ply_parser.h"
+#include "stl_parser.h"
+#include "thread_pool.h"
+#include "vertex_kernels.h"
+
 namespace s21 {
 
-    void Model::read_file(const char* filename){
-        std::ifstream file(filename);
-        if(file.is_open()){
+    bool Model::read_file(const char* filename, LoadProgress* progress, LoadStream* stream, MeshFormat format){
+        MappedFile file(filename);
+        if(!file.is_open()){
+            return false;
+        }
+        clear_data();
+        if(progress != nullptr){
+            progress->set_total_bytes(file.size());
+        }
+        const char* begin = file.data();
+        const char* end = file.data() + file.size();
+        bool ok = false;
+        if(format == MeshFormat::kStlBinary || format == MeshFormat::kStlAscii){
+            StlParser parser;
+            parser.set_progress(progress);
+            ok = format == MeshFormat::kStlBinary ? parser.parse_binary(begin, end, vertices, faces)
+                                                  : parser.parse_ascii(begin, end, vertices, faces);
+        } else if(format == MeshFormat::kPly){
+            PlyParser parser;
+            parser.set_progress(progress);
+            ok = parser.parse(begin, end, vertices, faces);
+        } else {
+            ObjParser parser;
+            parser.set_threads(load_threads);
+            parser.set_progress(progress);
+            parser.set_stream(stream);
+            parser.set_scratch(parse_scratch);
+            ok = parser.parse(begin, end, vertices, faces);
+        }
+        if(!ok){
             clear_data();
-            std::string line;
-            
-            while(getline(file, line)){
-                if(line.empty()){
-                    continue;
-                }
-                if (line[0] == 'v' && line[1] == ' '){
-                    line = line.substr(2);
-                    std::stringstream ss(line);
-                    float x, y, z;
-                    ss >> x >> y >> z;
-                    vertices.emplace_back(x, y, z);
-                } else if (line[0] == 'f'){
-                    std::vector<size_t> cur_vec;
-                    char* pars_str = strtok((char*)line.c_str(), "f ");
-                    while(pars_str != nullptr){
-                        int cur;
-                        sscanf(pars_str, "%d", &cur);
-                        cur_vec.push_back(cur);
-                        pars_str = strtok(nullptr, " ");
-                    }
-                    faces.push_back(cur_vec);
-                } 
-            }
-            normalization();
-            center = calculate_center(vertices);
-            modelMatrix = glm::mat4(1.0f);
-            current_rotation = glm::vec3(0.0f);
-            file.close();
+            return false;
+        }
+        if(vertex_layout == VertexLayout::kSoA){
+            soa.assign(vertices.data(), vertices.size());
+            vertices.clear();
+            vertices.shrink_to_fit();
+        }
+        normalization();
+        modelMatrix = glm::mat4(1.0f);
+        current_rotation = glm::vec3(0.0f);
+        topology_changed();
+        return true;
+    }
+
+    Model Model::empty_copy() const {
+        Model copy;
+        copy.load_threads = load_threads;
+        copy.transform_threads = transform_threads;
+        copy.vertex_layout = vertex_layout;
+        copy.transform_mode = transform_mode;
+        copy.lod_settings = lod_settings;
+        return copy;
+    }
+
+    void Model::recycle(Model& retired){
+        clear_data();
+        retired.clear_data();
+        edges.clear();
+        retired.edges.clear();
+        std::swap(vertices, retired.vertices);
+        std::swap(soa, retired.soa);
+        std::swap(faces, retired.faces);
+        std::swap(edges, retired.edges);
+        std::swap(chunks, retired.chunks);
+        std::swap(bvh, retired.bvh);
+    }
+
+    uint64_t Model::next_generation(){
+        static std::atomic<uint64_t> generation{0};
+        return ++generation;
+    }
+
+    void Model::load_normalized(const glm::vec3* source, size_t count, const FaceList& source_faces){
+        load_normalized(source, count, source_faces.offset_data().data(), source_faces.size(),
+                        source_faces.index_data().data());
+    }
+
+    void Model::load_normalized(const glm::vec3* source, size_t count, const FaceList::index_type* offsets,
+                                size_t face_count, const FaceList::index_type* indices){
+        clear_data();
+        if(vertex_layout == VertexLayout::kSoA){
+            soa.assign(source, count);
+        } else {
+            vertices.assign(source, source + count);
         }
+        faces.assign(offsets, face_count, indices);
+        center = glm::vec3(0.0f);
+        modelMatrix = glm::mat4(1.0f);
+        current_rotation = glm::vec3(0.0f);
+        topology_changed();
+    }
+
+    const MeshWeld::Stats& Model::weld_vertices(float epsilon){
+        // Сварка идет по массиву glm::vec3: в режиме kSoA это кэш view()
+        interleaved_vertices();
+        weld_stats = MeshWeld::compact(vertices, faces, epsilon, load_threads);
+        if(weld_stats.vertices_after == weld_stats.vertices_before){
+            // Вершины и их порядок прежние, индексы граней не изменились
+            return weld_stats;
+        }
+        lods.clear();
+        topology_changed();
+        if(vertex_layout == VertexLayout::kSoA){
+            soa.assign(vertices.data(), vertices.size());
+            derived_generation = geometry_generation;
+            derived_valid = true;
+        }
+        return weld_stats;
+    }
+
+    MeshReorder::Stats Model::optimize_locality(){
+        interleaved_vertices();
+        MeshReorder::Stats stats = MeshReorder::optimize(vertices, faces);
+        lods.clear();
+        topology_changed();
+        if(vertex_layout == VertexLayout::kSoA){
+            soa.assign(vertices.data(), vertices.size());
+            derived_generation = geometry_generation;
+            derived_valid = true;
+        }
+        return stats;
     }
 
     void Model::clear_data(){
+        weld_stats = MeshWeld::Stats();
         vertices.clear();
+        soa.clear();
+        quantized.clear();
         faces.clear();
+        lods.clear();
+        bvh.clear();
+        chunks.clear();
+        derived_valid = false;
+        topology_changed();
     }
 
-    void Model::normalization(){
-        glm::vec3 min_values = glm::vec3(std::numeric_limits<float>::max());
-        glm::vec3 max_values = glm::vec3(std::numeric_limits<float>::min());
-        for(const glm::vec3& vertex : vertices){
-            min_values = glm::min(min_values, vertex);
-            max_values = glm::max(max_values, vertex);
+    void Model::set_vertex_layout(VertexLayout layout){
+        if(layout == vertex_layout){
+            return;
         }
-        glm::vec3 range = max_values - min_values;
-        float scale = 2.0 / std::max(range.x, glm::max(range.y, range.z));
+        if(layout == VertexLayout::kSoA){
+            soa.assign(vertices.data(), vertices.size());
+        } else {
+            interleaved_vertices();
+        }
+        // Оба хранилища сейчас совпадают, бывшее основное становится кэшем
+        vertex_layout = layout;
+        derived_generation = geometry_generation;
+        derived_valid = true;
+    }
 
-        for (auto& vertex : vertices) {
-            vertex = (vertex - min_values) * scale - glm::vec3(1.0f);
+    const std::vector<uint32_t>& Model::get_edges() const {
+        if(edges_generation != topology_generation){
+            EdgeList::build(faces, vertices_size(), edges);
+            edges_generation = topology_generation;
         }
+        return edges;
+    }
 
-        glm::vec3 center = calculate_center(vertices);
-        for(glm::vec3& vertex : vertices){
-            vertex -= center;
+    const MeshChunks& Model::get_chunks() const {
+        if(chunks_topology == topology_generation && chunks_geometry == geometry_generation){
+            return chunks;
+        }
+        const std::vector<glm::vec3>& source = interleaved_vertices();
+        if(chunks_topology != topology_generation){
+            chunks.build(source.data(), source.size(), get_edges());
+        } else {
+            chunks.refit(source.data(), source.size());
         }
-        center = calculate_center(vertices);
+        chunks_topology = topology_generation;
+        chunks_geometry = geometry_generation;
+        return chunks;
+    }
+
+    const MeshBvh& Model::get_bvh() const {
+        if(bvh_topology == topology_generation && bvh_geometry == geometry_generation){
+            return bvh;
+        }
+        const std::vector<glm::vec3>& source = interleaved_vertices();
+        if(bvh_topology != topology_generation){
+            bvh.build(source.data(), source.size(), faces, load_threads);
+        } else {
+            bvh.refit(source.data(), source.size(), faces, transform_threads);
+        }
+        bvh_topology = topology_generation;
+        bvh_geometry = geometry_generation;
+        return bvh;
+    }
+
+    bool Model::set_bvh(MeshBvh tree, uint64_t topology, uint64_t geometry){
+        if(topology != topology_generation){
+            return false;
+        }
+        bvh = std::move(tree);
+        bvh_topology = topology;
+        bvh_geometry = geometry;
+        return true;
+    }
+
+    bool Model::ray_pick(const glm::vec3& origin, const glm::vec3& direction, MeshBvh::Hit& hit) const {
+        // Луч переводится в координаты вершин; параметр вдоль луча при
+        // аффинном преобразовании не меняется
+        glm::vec3 local_origin = origin;
+        glm::vec3 local_direction = direction;
+        bool identity = modelMatrix == glm::mat4(1.0f);
+        if(!identity){
+            glm::mat4 inverse = glm::inverse(modelMatrix);
+            local_origin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+            local_direction = glm::vec3(inverse * glm::vec4(direction, 0.0f));
+        }
+        const MeshBvh& tree = get_bvh();
+        const std::vector<glm::vec3>& source = interleaved_vertices();
+        if(!tree.ray_pick(source.data(), source.size(), faces, local_origin, local_direction, hit)){
+            return false;
+        }
+        if(!identity){
+            hit.point = glm::vec3(modelMatrix * glm::vec4(hit.point, 1.0f));
+        }
+        return true;
+    }
+
+    void Model::query_region(const glm::vec4* planes, size_t plane_count,
+                             std::vector<uint32_t>& result) const {
+        // Плоскость p переходит в координаты вершин как transpose(M) * p
+        std::vector<glm::vec4> local(planes, planes + plane_count);
+        if(modelMatrix != glm::mat4(1.0f)){
+            glm::mat4 transposed = glm::transpose(modelMatrix);
+            for(glm::vec4& plane : local){
+                plane = transposed * plane;
+            }
+        }
+        const MeshBvh& tree = get_bvh();
+        const std::vector<glm::vec3>& source = interleaved_vertices();
+        tree.query(source.data(), source.size(), faces, local.data(), local.size(), result);
+    }
+
+    bool Model::build_lods(){
+        lods.clear();
+        if(faces.size() < lod_settings.min_faces || lod_settings.resolutions.empty()){
+            return false;
+        }
+        const std::vector<glm::vec3>& source = interleaved_vertices();
+        return set_lods(MeshLod::build(source.data(), source.size(), get_edges(), lod_settings),
+                        geometry_generation);
+    }
+
+    bool Model::set_lods(std::vector<LodLevel> levels, uint64_t generation){
+        if(generation != geometry_generation || levels.empty()){
+            return false;
+        }
+        lods = std::move(levels);
+        for(LodLevel& level : lods){
+            level.generation = next_generation();
+        }
+        lod_generation = generation;
+        return true;
+    }
+
+    const LodLevel* Model::get_lod(size_t max_edges) const {
+        if(lods.empty() || lod_generation != geometry_generation ||
+           get_edges().size() / 2 <= max_edges){
+            return nullptr;
+        }
+        const LodLevel* chosen = &lods.front();
+        for(const LodLevel& level : lods){
+            if(level.edges.size() / 2 <= max_edges){
+                chosen = &level;
+            }
+        }
+        return chosen;
+    }
+
+    const SoaVertices& Model::soa_vertices() const {
+        if(vertex_layout == VertexLayout::kAoS &&
+           (!derived_valid || derived_generation != geometry_generation)){
+            soa.assign(vertices.data(), vertices.size());
+            derived_generation = geometry_generation;
+            derived_valid = true;
+        }
+        return soa;
+    }
+
+    const QuantizedVertices& Model::quantized_vertices() const {
+        if(quantized_generation != geometry_generation){
+            const std::vector<glm::vec3>& source = interleaved_vertices();
+            quantized.assign(source.data(), source.size());
+            quantized_generation = geometry_generation;
+        }
+        return quantized;
+    }
+
+    const std::vector<glm::vec3>& Model::interleaved_vertices() const {
+        if(vertex_layout == VertexLayout::kSoA &&
+           (!derived_valid || derived_generation != geometry_generation)){
+            vertices.resize(soa.size());
+            soa.export_interleaved(vertices.data());
+            derived_generation = geometry_generation;
+            derived_valid = true;
+        }
+        return vertices;
+    }
+
+    void Model::transform_vertices(const glm::mat4& matrix){
+        // Каждая вершина считается независимо и одинаково, поэтому деление
+        // на части не меняет результат
+        ThreadPool& pool = ThreadPool::shared();
+        size_t count = vertices_size();
+        size_t threads = transform_threads != 0 ? transform_threads : pool.size();
+        size_t parts = std::min(threads, count / kMinParallelVertices);
+        if(vertex_layout == VertexLayout::kSoA){
+            if(parts > 1){
+                pool.parallel_for(count, parts, [&](size_t begin, size_t end){
+                    soa.transform(matrix, begin, end);
+                });
+            } else {
+                soa.transform(matrix);
+            }
+        } else {
+            if(parts > 1){
+                pool.parallel_for(count, parts, [&](size_t begin, size_t end){
+                    VertexKernels::transform(vertices.data() + begin, end - begin, matrix);
+                });
+            } else {
+                VertexKernels::transform(vertices.data(), vertices.size(), matrix);
+            }
+        }
+    }
+
+    VertexKernels::Bounds Model::vertex_bounds() const {
+        if(vertex_layout == VertexLayout::kSoA){
+            return soa.bounds();
+        }
+        return VertexKernels::reduce(vertices.data(), vertices.size());
+    }
+
+    void Model::set_transform_mode(TransformMode mode){
+        if(mode == TransformMode::kVertices){
+            bake();
+        }
+        transform_mode = mode;
+    }
+
+    void Model::bake(){
+        if(modelMatrix == glm::mat4(1.0f)){
+            return;
+        }
+        transform_vertices(modelMatrix);
+        modelMatrix = glm::mat4(1.0f);
+        geometry_changed();
+    }
+
+    void Model::normalization(){
+        bake();
+        if(vertices_size() == 0){
+            return;
+        }
+        // Один проход для границ и центра и один для преобразования: модель
+        // вписывается в куб [-1, 1] и ее центр переносится в начало координат
+        transform_vertices(normalization_matrix(vertex_bounds()));
+        center = glm::vec3(0.0f);
+        geometry_changed();
+    }
+
+    glm::mat4 Model::normalization_matrix(const VertexKernels::Bounds& bounds){
+        glm::vec3 range = bounds.max - bounds.min;
+        float extent = std::max(range.x, std::max(range.y, range.z));
+        float scale = extent > 0.0f ? 2.0f / extent : 1.0f;
+        return glm::scale(glm::mat4(1.0f), glm::vec3(scale)) *
+               glm::translate(glm::mat4(1.0f), -bounds.centroid);
     }
 
     void Model::setPossition(const glm::vec3 &newPossition){
         glm::vec3 delta = newPossition - center;
-        for(auto& vertex: vertices){
-            vertex += delta;
-        }
         center = newPossition;
+        if(transform_mode == TransformMode::kMatrix){
+            modelMatrix = glm::translate(glm::mat4(1.0f), delta) * modelMatrix;
+            return;
+        }
+        transform_vertices(glm::translate(glm::mat4(1.0f), delta));
+        geometry_changed();
     }
 
     void Model::rotate(float angle, glm::vec3 axis){
@@ -78,38 +401,70 @@ namespace s21 {
         glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(diff), axis);
         current_rotation += diff * axis;
 
-        modelMatrix *= rotationMatrix;
-
-        for(auto &vertex : vertices){
-            vertex -= center;
-        }
-
-        for(auto &vertex : vertices){
-            vertex = rotationMatrix * glm::vec4(vertex, 1.0f);
-        }
-
-        for(auto &vertex : vertices){
-            vertex += center;
+        // Поворот вокруг центра модели одной матрицей и за один проход
+        glm::mat4 matrix = glm::translate(glm::mat4(1.0f), center) * rotationMatrix *
+                           glm::translate(glm::mat4(1.0f), -center);
+        if(transform_mode == TransformMode::kMatrix){
+            modelMatrix = matrix * modelMatrix;
+            return;
         }
+        transform_vertices(matrix);
+        geometry_changed();
     }
 
-    glm::vec3 Model::calculate_center(const std::vector<glm::vec3>& vertices){
-        glm::vec3 center(0.0f);
-        for(const glm::vec3& vertex : vertices){
-            center += vertex;
+    void Model::scale(float scale_factor){
+        if(transform_mode == TransformMode::kMatrix){
+            modelMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_factor)) * modelMatrix;
+            return;
         }
-        return center / static_cast<float>(vertices.size());
+        transform_vertices(glm::scale(glm::mat4(1.0f), glm::vec3(scale_factor)));
+        geometry_changed();
     }
 
-    void Model::scale(float scale_factor){
-        for(glm::vec3& vertex : vertices){
-            vertex *= scale_factor;
+    bool Model::apply(const TransformUpdate& update){
+        // Те же шаги, что у rotate, scale и setPossition, но в одной матрице
+        glm::mat4 matrix(1.0f);
+        bool changed = false;
+        for(int k = 0; k < 3; ++k){
+            if(!update.has_angle[k] || update.angles[k] == current_rotation[k]){
+                continue;
+            }
+            glm::vec3 axis(0.0f);
+            axis[k] = 1.0f;
+            glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(update.angles[k] - current_rotation[k]),
+                                             axis);
+            matrix = glm::translate(glm::mat4(1.0f), center) * rotation *
+                     glm::translate(glm::mat4(1.0f), -center) * matrix;
+            current_rotation[k] = update.angles[k];
+            changed = true;
+        }
+        if(update.scale != 1.0f){
+            matrix = glm::scale(glm::mat4(1.0f), glm::vec3(update.scale)) * matrix;
+            changed = true;
+        }
+        if(update.has_position && update.position != center){
+            matrix = glm::translate(glm::mat4(1.0f), update.position - center) * matrix;
+            center = update.position;
+            changed = true;
+        }
+        if(!changed){
+            return false;
+        }
+        if(transform_mode == TransformMode::kMatrix){
+            modelMatrix = matrix * modelMatrix;
+            return true;
         }
+        transform_vertices(matrix);
+        geometry_changed();
+        return true;
     }
 
     void Model::translate(const glm::vec3& translation){
-        for(glm::vec3& vertex : vertices){
-            vertex += translation;
+        if(transform_mode == TransformMode::kMatrix){
+            modelMatrix = glm::translate(glm::mat4(1.0f), translation) * modelMatrix;
+            return;
         }
+        transform_vertices(glm::translate(glm::mat4(1.0f), translation));
+        geometry_changed();
     }
 }
@@ -6,7 +6,39 @@
 #include <regex>
 #include <glm/ext.hpp>
 
+#include "edge_list.h"
+#include "face_list.h"
+#include "load_progress.h"
+#include "load_stream.h"
+#include "mesh_bvh.h"
+#include "mesh_chunks.h"
+#include "mesh_format.h"
+#include "mesh_lod.h"
+#include "mesh_reorder.h"
+#include "mesh_view.h"
+#include "mesh_weld.h"
+#include "obj_parser.h"
+#include "quantized_vertices.h"
+#include "soa_vertices.h"
+#include "transform_queue.h"
+
 namespace s21 {
+    /**
+     * @brief Способ применения преобразований модели.
+     */
+    enum class TransformMode {
+        kVertices, // Преобразования сразу переписывают все вершины (O(N))
+        kMatrix    // Преобразования копятся в матрице модели (O(1)), вершины не меняются
+    };
+
+    /**
+     * @brief Способ хранения вершин модели.
+     */
+    enum class VertexLayout {
+        kAoS, // Массив glm::vec3 (x y z x y z ...)
+        kSoA  // Три выровненных массива координат (x x ..., y y ..., z z ...)
+    };
+
     /**
      * @brief Класс для представления и обработки 3D модели.
      *
@@ -15,6 +47,8 @@ namespace s21 {
      */
     class Model {
         public:
+            static constexpr size_t kMinParallelVertices = 1 << 16; // Минимум вершин на поток преобразования
+
             /**
              * @brief Конструктор по умолчанию.
              *
@@ -29,6 +63,22 @@ namespace s21 {
              */
             ~Model() = default;
 
+            /**
+             * @brief Копирует модель вместе со всеми массивами.
+             */
+            Model(const Model&) = default;
+            Model& operator=(const Model&) = default;
+
+            /**
+             * @brief Перемещает модель без копирования массивов.
+             *
+             * Объявлены явно: из-за объявленного деструктора компилятор не
+             * создал бы их сам, и обмен моделей (Controller::swapModel)
+             * копировал бы все вершины и грани.
+             */
+            Model(Model&&) = default;
+            Model& operator=(Model&&) = default;
+
             /**
              * @brief Очищает данные модели.
              *
@@ -40,10 +90,268 @@ namespace s21 {
              * @brief Загружает модель из файла.
              *
              * Читает данные о вершинах и гранях из указанного файла и заполняет ими модель.
+             * Файл отображается в память и разбирается на месте (см. ObjParser,
+             * StlParser, PlyParser).
              *
              * @param filename Путь к файлу с моделью.
+             * @param progress Ход загрузки и запрос отмены (может отсутствовать).
+             * @param stream Куда публиковать вершины и грани по мере разбора,
+             * до нормализации (может отсутствовать; используется только для OBJ).
+             * @param format Формат файла (см. detect_mesh_format).
+             * @return true, если файл прочитан; false, если его не удалось
+             * открыть (модель не меняется), загрузка отменена или формат не
+             * поддерживается (модель остается пустой).
+             */
+            bool read_file(const char* filename, LoadProgress* progress = nullptr,
+                           LoadStream* stream = nullptr, MeshFormat format = MeshFormat::kObj);
+
+            /**
+             * @brief Создает пустую модель с теми же настройками.
+             *
+             * Копируются число потоков, способ хранения вершин и способ
+             * применения преобразований. Нужна, чтобы загрузить файл в
+             * отдельную модель в другом потоке и потом подменить текущую.
+             *
+             * @return Пустая модель.
+             */
+            Model empty_copy() const;
+
+            /**
+             * @brief Забирает память другой модели под свои данные.
+             *
+             * Обе модели очищаются, после чего массивы вершин, граней, ребер,
+             * кусков и дерева граней меняются местами: следующая загрузка в
+             * эту модель пишет в уже выделенную память, а не растит массивы
+             * заново. Настройки моделей не меняются.
+             *
+             * @param retired Модель, которая больше не нужна; остается пустой
+             * с прежней памятью этой модели.
+             */
+            void recycle(Model& retired);
+
+            /**
+             * @brief Задает буферы фрагментов для параллельного разбора OBJ.
+             *
+             * Буферы не принадлежат модели и не копируются в empty_copy();
+             * пока они заданы, ими не должна пользоваться другая загрузка.
+             *
+             * @param scratch Буферы, переживающие загрузку, или nullptr.
+             */
+            void set_parse_scratch(ObjParser::Scratch* scratch) { parse_scratch = scratch; }
+
+            /**
+             * @brief Загружает уже нормализованную геометрию.
+             *
+             * Используется, когда вершины и грани получены не разбором OBJ
+             * (например, из кэша MeshCache): нормализация не выполняется.
+             *
+             * @param vertices Нормализованные вершины.
+             * @param count Количество вершин.
+             * @param faces Грани модели.
+             */
+            void load_normalized(const glm::vec3* vertices, size_t count, const FaceList& faces);
+
+            /**
+             * @brief Загружает уже нормализованную геометрию из массивов CSR.
+             *
+             * Вершины и грани копируются в память, которая уже есть у модели
+             * (см. recycle), например прямо из отображенного файла кэша.
+             *
+             * @param vertices Нормализованные вершины.
+             * @param count Количество вершин.
+             * @param offsets Начала граней (face_count + 1 элементов, первый - 0).
+             * @param face_count Количество граней.
+             * @param indices Индексы вершин всех граней подряд.
+             */
+            void load_normalized(const glm::vec3* vertices, size_t count, const FaceList::index_type* offsets,
+                                 size_t face_count, const FaceList::index_type* indices);
+
+            /**
+             * @brief Сваривает близкие вершины и удаляет вершины без граней.
+             *
+             * Необязательный проход после загрузки (см. MeshWeld). Вершины
+             * не сдвигаются, поэтому после удаления лишних вершин модель
+             * может понадобиться нормализовать заново. Если число вершин не
+             * изменилось, поколения модели не меняются и построенные по ней
+             * ребра, куски и дерево остаются в силе.
+             *
+             * @param epsilon Наибольшее расстояние между свариваемыми
+             * вершинами в координатах модели; 0 - только точные совпадения.
+             * @return Число вершин до и после прохода.
+             */
+            const MeshWeld::Stats& weld_vertices(float epsilon);
+
+            /**
+             * @brief Возвращает итог последней сварки вершин.
+             *
+             * @return Число вершин до и после; нули, если с загрузки сварки
+             * не было.
+             */
+            const MeshWeld::Stats& get_weld_stats() const { return weld_stats; }
+
+            /**
+             * @brief Переставляет грани и вершины для локальности обращений.
+             *
+             * Необязательный проход после загрузки (см. MeshReorder): грани
+             * идут в порядке, удобном кэшу вершин видеокарты, а вершины - в
+             * порядке первого использования гранями. Геометрия не меняется,
+             * но номера граней и вершин становятся другими.
+             *
+             * @return Промахи модельного кэша вершин до и после прохода.
+             */
+            MeshReorder::Stats optimize_locality();
+
+            /**
+             * @brief Задает число потоков для загрузки модели.
+             *
+             * Большие файлы разбираются параллельно фрагментами; результат не
+             * зависит от числа потоков.
+             *
+             * @param threads Число потоков; 0 означает число ядер процессора.
+             */
+            void set_load_threads(size_t threads) { load_threads = threads; }
+
+            /**
+             * @brief Задает число потоков для преобразования вершин.
+             *
+             * Модели меньше kMinParallelVertices вершин на поток
+             * преобразуются в вызывающем потоке. Результат побитово
+             * совпадает с последовательным при любом числе потоков.
+             *
+             * @param threads Число потоков; 0 означает число ядер процессора.
+             */
+            void set_transform_threads(size_t threads) { transform_threads = threads; }
+
+            /**
+             * @brief Задает способ хранения вершин.
+             *
+             * Преобразования и свертки выполняются над основным хранилищем.
+             * Представление в другом формате (view() для AoS, soa_vertices()
+             * для SoA) собирается по запросу и кэшируется до следующего
+             * изменения вершин.
+             *
+             * @param layout Способ хранения.
+             */
+            void set_vertex_layout(VertexLayout layout);
+
+            /**
+             * @brief Возвращает способ хранения вершин.
+             *
+             * @return Текущий способ хранения.
+             */
+            VertexLayout get_vertex_layout() const { return vertex_layout; }
+
+            /**
+             * @brief Возвращает вершины в раздельном хранении.
+             *
+             * В режиме VertexLayout::kAoS массивы собираются из основного
+             * хранилища при первом обращении после изменения вершин.
+             *
+             * @return Вершины по осям.
+             */
+            const SoaVertices& soa_vertices() const;
+
+            /**
+             * @brief Возвращает вершины, сжатые до 16-битных кодов.
+             *
+             * Коды нужны для загрузки в видеопамять (см. QuantizedVertices)
+             * и собираются заново, только когда изменились вершины; в режиме
+             * TransformMode::kMatrix повороты их не трогают. Основное
+             * хранилище остается float, поэтому пока коды собраны, модель
+             * занимает на 6 байт на вершину больше.
+             *
+             * @return Сжатые вершины.
+             */
+            const QuantizedVertices& quantized_vertices() const;
+
+            /**
+             * @brief Задает способ применения преобразований.
+             *
+             * В режиме TransformMode::kMatrix вершины после загрузки не меняются,
+             * а вращение, масштаб и перемещение лишь обновляют матрицу модели,
+             * которую применяет отрисовщик. При переходе в режим
+             * TransformMode::kVertices накопленная матрица применяется к вершинам.
+             *
+             * @param mode Способ применения преобразований.
+             */
+            void set_transform_mode(TransformMode mode);
+
+            /**
+             * @brief Возвращает способ применения преобразований.
+             *
+             * @return Текущий режим.
+             */
+            TransformMode get_transform_mode() const { return transform_mode; }
+
+            /**
+             * @brief Задает настройки уровней детализации.
+             *
+             * Уже построенные уровни не меняются до следующего build_lods.
+             *
+             * @param settings Разрешения сеток и минимальный размер модели.
+             */
+            void set_lod_settings(const MeshLod::Settings& settings) { lod_settings = settings; }
+
+            /**
+             * @brief Возвращает настройки уровней детализации.
+             *
+             * @return Текущие настройки.
+             */
+            const MeshLod::Settings& get_lod_settings() const { return lod_settings; }
+
+            /**
+             * @brief Строит уровни детализации по текущим вершинам.
+             *
+             * Уровни строятся параллельно (см. MeshLod) и остаются верны,
+             * пока не изменятся вершины: в режиме TransformMode::kMatrix
+             * повороты и перемещения их не трогают.
+             *
+             * @return true, если уровни построены; false, если модель меньше
+             * порога из настроек или список разрешений пуст.
+             */
+            bool build_lods();
+
+            /**
+             * @brief Принимает уровни детализации, построенные вне модели.
+             *
+             * Так уровни строятся с отменой и ходом загрузки (см.
+             * MeshLod::build) в потоке, который загружает модель. Уровни
+             * принимаются, только если вершины с тех пор не менялись.
+             *
+             * @param levels Уровни от грубого к точному (см. MeshLod::build).
+             * @param generation Поколение вершин, по которому они построены.
+             * @return true, если уровни приняты.
+             */
+            bool set_lods(std::vector<LodLevel> levels, uint64_t generation);
+
+            /**
+             * @brief Выбирает уровень детализации для интерактивного показа.
+             *
+             * @param max_edges Сколько ребер можно рисовать за кадр.
+             * @return Самый точный уровень, уложившийся в max_edges (или
+             * самый грубый, если не уложился ни один); nullptr, если модель
+             * целиком укладывается в max_edges или уровни не построены или
+             * устарели.
+             */
+            const LodLevel* get_lod(size_t max_edges) const;
+
+            /**
+             * @brief Возвращает матрицу модели.
+             *
+             * Матрица содержит преобразования, еще не примененные к вершинам
+             * (в режиме TransformMode::kVertices она единичная).
+             *
+             * @return Матрица модели.
              */
-            void read_file(const char* filename);
+            const glm::mat4& get_model_matrix() const { return modelMatrix; }
+
+            /**
+             * @brief Применяет матрицу модели к вершинам.
+             *
+             * Используется для экспорта преобразованной геометрии. После вызова
+             * матрица модели становится единичной.
+             */
+            void bake();
 
             /**
              * @brief Вращает модель вокруг заданной оси на указанный угол.
@@ -69,6 +377,18 @@ namespace s21 {
              */
             void translate(const glm::vec3& translation);
 
+            /**
+             * @brief Применяет накопленное изменение преобразования одной матрицей.
+             *
+             * Равносильно поворотам вокруг осей x, y, z (rotate), затем
+             * масштабу (scale) и переносу центра (setPossition), но вершины
+             * переписываются один раз, а поколение вершин растет на единицу.
+             *
+             * @param update Изменение из TransformQueue.
+             * @return true, если модель изменилась.
+             */
+            bool apply(const TransformUpdate& update);
+
             /**
              * @brief Нормализует модель.
              *
@@ -76,6 +396,18 @@ namespace s21 {
              */
             void normalization();
 
+            /**
+             * @brief Возвращает матрицу нормализации для заданной свертки вершин.
+             *
+             * Матрица переносит центр в начало координат и вписывает модель
+             * в куб [-1, 1]. По ней же предварительно нормализуется
+             * потоковая загрузка, пока границы известны не полностью.
+             *
+             * @param bounds Границы и центр вершин.
+             * @return Матрица нормализации.
+             */
+            static glm::mat4 normalization_matrix(const VertexKernels::Bounds& bounds);
+
             /**
              * @brief Устанавливает позицию центра модели.
              *
@@ -88,25 +420,29 @@ namespace s21 {
              *
              * @return Итератор на начало списка вершин.
              */
-            auto vertices_begin() const {return vertices.begin(); }
+            auto vertices_begin() const {return interleaved_vertices().begin(); }
 
             /**
              * @brief Возвращает итератор на конец списка вершин.
              *
              * @return Итератор на конец списка вершин.
              */
-            auto vertices_end() const {return vertices.end(); }
+            auto vertices_end() const {return interleaved_vertices().end(); }
 
             /**
              * @brief Возвращает количество вершин в модели.
              *
              * @return Количество вершин.
              */
-            size_t vertices_size() const { return vertices.size(); }
+            size_t vertices_size() const {
+                return vertex_layout == VertexLayout::kSoA ? soa.size() : vertices.size();
+            }
 
             /**
              * @brief Возвращает итератор на начало списка граней.
              *
+             * Разыменование итератора дает Span с индексами вершин грани.
+             *
              * @return Итератор на начало списка граней.
              */
             auto faces_begin() const {return faces.begin(); }
@@ -125,20 +461,192 @@ namespace s21 {
              */
             size_t faces_size() const { return faces.size(); }
 
+            /**
+             * @brief Возвращает плоский список граней.
+             *
+             * @return Список граней в формате CSR.
+             */
+            const FaceList& get_faces() const { return faces; }
+
+            /**
+             * @brief Возвращает список уникальных ребер каркаса.
+             *
+             * Строится один раз после каждой загрузки (см. EdgeList) и
+             * хранится вместе с моделью до следующего изменения граней.
+             *
+             * @return Пары индексов вершин (отсчет с нуля) для GL_LINES.
+             */
+            const std::vector<uint32_t>& get_edges() const;
+
+            /**
+             * @brief Возвращает разбиение каркаса на куски для отсечения.
+             *
+             * Куски строятся после каждого изменения граней; если менялись
+             * только координаты вершин, пересчитываются их параллелепипеды.
+             *
+             * @return Куски с ребрами и вершинами, упорядоченными по кускам.
+             */
+            const MeshChunks& get_chunks() const;
+
+            /**
+             * @brief Возвращает иерархию ограничивающих объемов над гранями.
+             *
+             * Строится после загрузки и при изменении граней; если менялись
+             * только координаты вершин (TransformMode::kVertices), дерево не
+             * перестраивается, а пересчитываются его параллелепипеды. В
+             * режиме TransformMode::kMatrix вершины не меняются и дерево
+             * остается прежним.
+             *
+             * @return Дерево в координатах вершин модели (без матрицы модели).
+             */
+            const MeshBvh& get_bvh() const;
+
+            /**
+             * @brief Принимает дерево, построенное вне модели.
+             *
+             * Так дерево строится с отменой и ходом загрузки (см.
+             * MeshBvh::build) в потоке, который загружает модель.
+             *
+             * @param tree Дерево по вершинам и граням модели.
+             * @param topology Поколение топологии, по которому оно построено.
+             * @param geometry Поколение вершин, по которому оно построено.
+             * @return true, если грани с тех пор не менялись и дерево принято
+             * (изменившиеся вершины будут учтены пересчетом объемов).
+             */
+            bool set_bvh(MeshBvh tree, uint64_t topology, uint64_t geometry);
+
+            /**
+             * @brief Ищет ближайшую грань под лучом.
+             *
+             * Луч задается в мировых координатах, то есть с учетом матрицы
+             * модели; расстояние в результате - параметр этого же луча.
+             *
+             * @param origin Начало луча.
+             * @param direction Направление луча.
+             * @param hit Грань, ближайшая к ней вершина и точка попадания.
+             * @return true, если луч пересекает модель.
+             */
+            bool ray_pick(const glm::vec3& origin, const glm::vec3& direction, MeshBvh::Hit& hit) const;
+
+            /**
+             * @brief Выбирает грани в выпуклой области мировых координат.
+             *
+             * @param planes Плоскости области (см. MeshBvh::query).
+             * @param plane_count Количество плоскостей.
+             * @param result Номера выбранных граней (дописываются в конец).
+             */
+            void query_region(const glm::vec4* planes, size_t plane_count,
+                              std::vector<uint32_t>& result) const;
+
+            /**
+             * @brief Возвращает представление геометрии только для чтения.
+             *
+             * Представление указывает на внутреннее хранилище модели и не
+             * копирует данные. В режиме VertexLayout::kSoA вершины
+             * собираются в массив glm::vec3 один раз после каждого изменения.
+             *
+             * @return Представление вершин и граней с номерами поколений.
+             */
+            MeshView view() const {
+                const std::vector<glm::vec3>& aos = interleaved_vertices();
+                return {{aos.data(), aos.size()}, &faces, geometry_generation, topology_generation, modelMatrix};
+            }
+
+            /**
+             * @brief Возвращает поколение координат вершин.
+             *
+             * Увеличивается при каждом изменении вершин (загрузка, преобразования).
+             *
+             * @return Номер поколения.
+             */
+            uint64_t get_geometry_generation() const { return geometry_generation; }
+
+            /**
+             * @brief Возвращает поколение топологии (состава вершин и граней).
+             *
+             * @return Номер поколения.
+             */
+            uint64_t get_topology_generation() const { return topology_generation; }
+
         private:
             /**
-             * @brief Вычисляет центр модели.
+             * @brief Возвращает новый номер поколения.
+             *
+             * Номера общие для всех моделей, поэтому после подмены одной
+             * модели другой поколения не совпадут случайно.
+             *
+             * @return Номер, больший всех выданных ранее.
+             */
+            static uint64_t next_generation();
+
+            /**
+             * @brief Отмечает изменение координат вершин.
+             */
+            void geometry_changed() { geometry_generation = next_generation(); }
+
+            /**
+             * @brief Отмечает изменение состава вершин и граней.
+             */
+            void topology_changed() {
+                topology_generation = next_generation();
+                geometry_generation = next_generation();
+            }
+
+            /**
+             * @brief Возвращает вершины в виде массива glm::vec3.
+             *
+             * В режиме VertexLayout::kSoA пересобирает кэш, если вершины
+             * изменились.
+             *
+             * @return Вершины модели.
+             */
+            const std::vector<glm::vec3>& interleaved_vertices() const;
+
+            /**
+             * @brief Применяет преобразование к основному хранилищу вершин.
+             *
+             * @param matrix Матрица преобразования.
+             */
+            void transform_vertices(const glm::mat4& matrix);
+
+            /**
+             * @brief Находит границы и центр вершин по основному хранилищу.
              *
-             * @param vertices Список вершин модели.
-             * @return Координаты центра модели.
+             * @return Минимум, максимум и центр.
              */
-            glm::vec3 calculate_center(const std::vector<glm::vec3>& vertices);
+            VertexKernels::Bounds vertex_bounds() const;
 
             glm::vec3 center; // Центр модели
             glm::vec3 current_rotation; // Текущий угол вращения
-            glm::mat4 modelMatrix; // Матрица модели
-            std::vector<glm::vec3> vertices; // Векторы вершин
-            std::vector<std::vector<size_t>> faces; // Индексы вершин в гранях
+            glm::mat4 modelMatrix = glm::mat4(1.0f); // Матрица модели (еще не примененные преобразования)
+            // Основное хранилище в режиме kAoS, кэш для view() в режиме kSoA
+            mutable std::vector<glm::vec3> vertices; // Векторы вершин
+            // Основное хранилище в режиме kSoA, кэш для soa_vertices() в режиме kAoS
+            mutable SoaVertices soa; // Вершины по осям
+            mutable uint64_t derived_generation = 0; // Поколение вершин в кэше
+            mutable bool derived_valid = false; // Собран ли кэш
+            mutable QuantizedVertices quantized; // Сжатые вершины для видеопамяти
+            mutable uint64_t quantized_generation = 0; // Поколение вершин в сжатых кодах
+            mutable std::vector<uint32_t> edges; // Уникальные ребра каркаса
+            mutable uint64_t edges_generation = 0; // Поколение топологии, для которого построены ребра
+            mutable MeshChunks chunks; // Куски каркаса для отсечения
+            mutable uint64_t chunks_topology = 0; // Поколение топологии, по которому построены куски
+            mutable uint64_t chunks_geometry = 0; // Поколение вершин, по которому пересчитаны куски
+            mutable MeshBvh bvh; // Иерархия объемов над гранями
+            mutable uint64_t bvh_topology = 0; // Поколение топологии, по которому построено дерево
+            mutable uint64_t bvh_geometry = 0; // Поколение вершин, по которому пересчитано дерево
+            std::vector<LodLevel> lods; // Уровни детализации от грубого к точному
+            uint64_t lod_generation = 0; // Поколение вершин, по которому построены уровни
+            MeshLod::Settings lod_settings; // Настройки уровней детализации
+            MeshWeld::Stats weld_stats; // Итог последней сварки вершин
+            VertexLayout vertex_layout = VertexLayout::kAoS; // Способ хранения вершин
+            FaceList faces; // Индексы вершин в гранях
+            size_t load_threads = 0; // Число потоков загрузки (0 - по числу ядер)
+            ObjParser::Scratch* parse_scratch = nullptr; // Буферы параллельного разбора (могут отсутствовать)
+            size_t transform_threads = 0; // Число потоков преобразования (0 - по числу ядер)
+            TransformMode transform_mode = TransformMode::kVertices; // Способ применения преобразований
+            uint64_t geometry_generation = 0; // Поколение координат вершин
+            uint64_t topology_generation = 0; // Поколение состава вершин и граней
     };
 } // namespace s21
 #endif
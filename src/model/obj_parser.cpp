@@ -0,0 +1,387 @@
+#include "obj_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "mapped_file.h"
+
+namespace s21 {
+
+    namespace {
+        // Степени десяти, точно представимые во float
+        constexpr float kPow10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                    1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        constexpr int kMaxExactPow10 = 10;
+        constexpr uint64_t kMaxExactMantissa = uint64_t(1) << 24;
+        constexpr int kMaxMantissaDigits = 19;
+        // Минимальный размер фрагмента, ради которого стоит заводить поток
+        constexpr size_t kMinChunkSize = 4 << 20;
+        // Как часто (в байтах) разбор сообщает о ходе и проверяет отмену
+        constexpr size_t kProgressStep = 1 << 20;
+
+        inline const char* next_report(const char* p, const char* end){
+            return static_cast<size_t>(end - p) > kProgressStep ? p + kProgressStep : end;
+        }
+
+        inline bool is_blank(char c){
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline bool is_digit(char c){
+            return static_cast<unsigned char>(c - '0') < 10;
+        }
+
+        // Медленный, но точный путь для чисел, не попадающих в быстрый
+        const char* parse_float_slow(const char* begin, const char* end, float& value){
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            std::from_chars(begin, end, value, std::chars_format::general);
+#else
+            thread_local std::istringstream stream = [] {
+                std::istringstream s;
+                s.imbue(std::locale::classic());
+                return s;
+            }();
+            stream.clear();
+            stream.str(std::string(begin, end));
+            stream >> value;
+#endif
+            return end;
+        }
+    } // namespace
+
+    bool ObjParser::parse_file(const char* filename,
+                               std::vector<glm::vec3>& vertices,
+                               FaceList& faces){
+        MappedFile file(filename);
+        if(!file.is_open()){
+            return false;
+        }
+        if(progress != nullptr){
+            progress->set_total_bytes(file.size());
+        }
+        return parse(file.data(), file.data() + file.size(), vertices, faces);
+    }
+
+    size_t ObjParser::thread_count() const {
+        size_t count = threads != 0 ? threads : std::thread::hardware_concurrency();
+        return count != 0 ? count : 1;
+    }
+
+    bool ObjParser::parse(const char* begin, const char* end,
+                          std::vector<glm::vec3>& vertices,
+                          FaceList& faces){
+        size_t workers = std::min(thread_count(), static_cast<size_t>(end - begin) / kMinChunkSize);
+        if(workers > 1){
+            return parse_parallel(begin, end, workers, vertices, faces);
+        }
+        return parse_chunk(begin, end, vertices, faces, stream, nullptr);
+    }
+
+    bool ObjParser::parse_parallel(const char* begin, const char* end, size_t workers,
+                                   std::vector<glm::vec3>& vertices,
+                                   FaceList& faces){
+        // Границы фрагментов сдвигаются к началу следующей строки
+        std::vector<const char*> bounds(workers + 1, end);
+        bounds[0] = begin;
+        size_t step = static_cast<size_t>(end - begin) / workers;
+        for(size_t i = 1; i < workers; ++i){
+            const char* p = std::max(bounds[i - 1], begin + i * step);
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            bounds[i] = eol != nullptr ? eol + 1 : end;
+        }
+
+        using Chunk = Scratch::Chunk;
+        Scratch local;
+        std::vector<Chunk>& chunks = (scratch != nullptr ? *scratch : local).chunks;
+        if(chunks.size() < workers){
+            chunks.resize(workers);
+        }
+        for(size_t i = 0; i < workers; ++i){
+            chunks[i].vertices.clear();
+            chunks[i].faces.clear();
+            chunks[i].relative.clear();
+        }
+        std::vector<char> completed(workers, 0);
+        // Отрицательные индексы фрагмент разрешает относительно своей первой
+        // вершины; число вершин перед ним известно, только когда готовы все
+        // предыдущие фрагменты
+        auto resolve = [](Chunk& chunk, size_t base){
+            for(size_t position : chunk.relative){
+                chunk.faces.indices[position] += static_cast<FaceList::index_type>(base);
+            }
+            chunk.relative.clear();
+        };
+        // Первый фрагмент публикуется по ходу разбора, остальные - целиком,
+        // когда готовы все предыдущие (индексы в гранях абсолютные, поэтому
+        // вершины должны приходить в порядке файла)
+        std::mutex publish_mutex;
+        size_t next_publish = 0;
+        size_t published_vertices = 0;
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for(size_t i = 0; i < workers; ++i){
+            pool.emplace_back([&, i] {
+                bool ok = parse_chunk(bounds[i], bounds[i + 1], chunks[i].vertices, chunks[i].faces,
+                                      i == 0 ? stream : nullptr, &chunks[i].relative);
+                std::lock_guard<std::mutex> lock(publish_mutex);
+                completed[i] = ok;
+                if(stream == nullptr || !ok){
+                    return;
+                }
+                if(i == 0){
+                    next_publish = 1;
+                    published_vertices = chunks[0].vertices.size();
+                }
+                while(next_publish != 0 && next_publish < workers && completed[next_publish]){
+                    Chunk& chunk = chunks[next_publish++];
+                    resolve(chunk, published_vertices);
+                    published_vertices += chunk.vertices.size();
+                    stream->publish(chunk.vertices.data(), chunk.vertices.size(), chunk.faces, 0);
+                }
+            });
+        }
+        for(auto& thread : pool){
+            thread.join();
+        }
+        pool.clear();
+        if(std::find(completed.begin(), completed.end(), 0) != completed.end()){
+            return false;
+        }
+
+        // Индексы в гранях абсолютные, поэтому склейка - это конкатенация
+        // с пересчетом смещений граней
+        size_t vertex_base = vertices.size();
+        size_t face_base = faces.size();
+        size_t index_base = faces.indices.size();
+        std::vector<size_t> vertex_offsets(workers), face_offsets(workers), index_offsets(workers);
+        for(size_t i = 0; i < workers; ++i){
+            vertex_offsets[i] = vertex_base;
+            face_offsets[i] = face_base;
+            index_offsets[i] = index_base;
+            vertex_base += chunks[i].vertices.size();
+            face_base += chunks[i].faces.size();
+            index_base += chunks[i].faces.indices.size();
+        }
+        vertices.resize(vertex_base);
+        faces.indices.resize(index_base);
+        faces.offsets.resize(face_base + 1);
+        for(size_t i = 0; i < workers; ++i){
+            pool.emplace_back([&, i] {
+                Chunk& chunk = chunks[i];
+                resolve(chunk, vertex_offsets[i] - vertex_offsets[0]);
+                std::copy(chunk.vertices.begin(), chunk.vertices.end(),
+                          vertices.begin() + vertex_offsets[i]);
+                std::copy(chunk.faces.indices.begin(), chunk.faces.indices.end(),
+                          faces.indices.begin() + index_offsets[i]);
+                FaceList::index_type shift = static_cast<FaceList::index_type>(index_offsets[i]);
+                for(size_t f = 1; f < chunk.faces.offsets.size(); ++f){
+                    faces.offsets[face_offsets[i] + f] = chunk.faces.offsets[f] + shift;
+                }
+            });
+        }
+        for(auto& thread : pool){
+            thread.join();
+        }
+        return true;
+    }
+
+    bool ObjParser::parse_chunk(const char* begin, const char* end,
+                                std::vector<glm::vec3>& vertices,
+                                FaceList& faces, LoadStream* stream,
+                                std::vector<size_t>* relative){
+        const char* p = begin;
+        size_t first_vertex = vertices.size();
+        // Граница следующего отчета и счетчики на момент прошлого отчета
+        const char* report_at = progress != nullptr || stream != nullptr ? next_report(p, end) : end;
+        const char* reported = p;
+        size_t reported_vertices = vertices.size();
+        size_t reported_faces = faces.size();
+        while(p < end){
+            if(p >= report_at){
+                if(stream != nullptr){
+                    stream->publish(vertices.data() + reported_vertices,
+                                    vertices.size() - reported_vertices, faces, reported_faces);
+                }
+                if(progress != nullptr){
+                    progress->advance(p - reported, vertices.size() - reported_vertices,
+                                      faces.size() - reported_faces);
+                    if(progress->cancelled()){
+                        return false;
+                    }
+                }
+                reported = p;
+                reported_vertices = vertices.size();
+                reported_faces = faces.size();
+                report_at = next_report(p, end);
+            }
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if(eol == nullptr){
+                eol = end;
+            }
+            if(eol - p >= 2 && p[0] == 'v' && p[1] == ' '){
+                parse_vertex(p + 2, eol, vertices);
+            } else if(p < eol && p[0] == 'f'){
+                parse_face(p + 1, eol, vertices.size() - first_vertex, faces, relative);
+            }
+            p = eol + 1;
+        }
+        if(stream != nullptr){
+            stream->publish(vertices.data() + reported_vertices,
+                            vertices.size() - reported_vertices, faces, reported_faces);
+        }
+        if(progress != nullptr){
+            progress->advance(end - reported, vertices.size() - reported_vertices,
+                              faces.size() - reported_faces);
+            return !progress->cancelled();
+        }
+        return true;
+    }
+
+    void ObjParser::parse_vertex(const char* p, const char* end,
+                                 std::vector<glm::vec3>& vertices){
+        float xyz[3] = {0.0f, 0.0f, 0.0f};
+        for(float& coord : xyz){
+            p = parse_float(p, end, coord);
+            if(p == nullptr){
+                break;
+            }
+        }
+        vertices.emplace_back(xyz[0], xyz[1], xyz[2]);
+    }
+
+    void ObjParser::parse_face(const char* p, const char* end, size_t vertex_count,
+                               FaceList& faces, std::vector<size_t>* relative){
+        while(true){
+            while(p < end && is_blank(*p)){
+                ++p;
+            }
+            if(p == end){
+                break;
+            }
+            // Запись "v", "v/vt", "v//vn" или "v/vt/vn": нужна только v
+            bool negative = *p == '-';
+            p += negative || *p == '+';
+            const char* digits = p;
+            uint64_t value = 0;
+            for(; p < end && is_digit(*p); ++p){
+                value = value * 10 + static_cast<unsigned>(*p - '0');
+            }
+            if(p != digits){
+                // Индекс с единицы или отрицательный (от последней
+                // прочитанной вершины) переводится в индекс с нуля;
+                // несуществующий (0, вне файла) становится не меньше числа
+                // вершин и пропускается потребителями
+                uint64_t index = negative ? vertex_count - value : value - 1;
+                if(negative && relative != nullptr){
+                    relative->push_back(faces.index_data().size());
+                }
+                faces.push_index(static_cast<FaceList::index_type>(index));
+            }
+            while(p < end && !is_blank(*p)){
+                ++p;
+            }
+        }
+        faces.close_face();
+    }
+
+    const char* ObjParser::parse_float(const char* p, const char* end, float& value){
+        while(p < end && is_blank(*p)){
+            ++p;
+        }
+        bool negative = false;
+        if(p < end && (*p == '-' || *p == '+')){
+            negative = *p == '-';
+            ++p;
+        }
+        const char* digits_begin = p;
+        uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool exact = true;
+        bool any = false;
+
+        for(; p < end && is_digit(*p); ++p){
+            any = true;
+            if(digits < kMaxMantissaDigits){
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                digits += mantissa != 0;
+            } else {
+                exact = false;
+            }
+        }
+        if(p < end && *p == '.'){
+            for(++p; p < end && is_digit(*p); ++p){
+                any = true;
+                if(digits < kMaxMantissaDigits){
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                    digits += mantissa != 0;
+                    --exponent;
+                } else {
+                    exact = false;
+                }
+            }
+        }
+        if(!any){
+            return nullptr;
+        }
+        if(p < end && (*p == 'e' || *p == 'E')){
+            const char* q = p + 1;
+            bool exp_negative = false;
+            if(q < end && (*q == '-' || *q == '+')){
+                exp_negative = *q == '-';
+                ++q;
+            }
+            if(q < end && is_digit(*q)){
+                int exp_value = 0;
+                for(; q < end && is_digit(*q); ++q){
+                    if(exp_value < 100000){
+                        exp_value = exp_value * 10 + (*q - '0');
+                    }
+                }
+                exponent += exp_negative ? -exp_value : exp_value;
+                p = q;
+            }
+        }
+
+        if(exact && mantissa <= kMaxExactMantissa &&
+           exponent >= -kMaxExactPow10 && exponent <= kMaxExactPow10){
+            // Мантисса и степень десяти точны во float, поэтому одно умножение
+            // или деление дает корректно округленный результат
+            float result = static_cast<float>(mantissa);
+            result = exponent < 0 ? result / kPow10[-exponent] : result * kPow10[exponent];
+            value = negative ? -result : result;
+            return p;
+        }
+        parse_float_slow(digits_begin, p, value);
+        if(negative){
+            value = -value;
+        }
+        return p;
+    }
+
+    const char* ObjParser::parse_int(const char* p, const char* end, long long& value){
+        while(p < end && is_blank(*p)){
+            ++p;
+        }
+        bool negative = false;
+        if(p < end && (*p == '-' || *p == '+')){
+            negative = *p == '-';
+            ++p;
+        }
+        if(p == end || !is_digit(*p)){
+            return nullptr;
+        }
+        long long result = 0;
+        for(; p < end && is_digit(*p); ++p){
+            result = result * 10 + (*p - '0');
+        }
+        value = negative ? -result : result;
+        return p;
+    }
+} // namespace s21
@@ -0,0 +1,197 @@
+#ifndef SRC_MODEL_OBJ_PARSER_H
+#define SRC_MODEL_OBJ_PARSER_H
+#include <cstddef>
+#include <glm/ext.hpp>
+#include <vector>
+
+#include "face_list.h"
+#include "load_progress.h"
+#include "load_stream.h"
+
+namespace s21 {
+    /**
+     * @brief Разборщик файлов формата .obj.
+     *
+     * Класс ObjParser разбирает текст .obj прямо в отображенном в память буфере:
+     * строки не копируются, числа читаются собственным токенизатором, а
+     * индексы граней пишутся сразу в плоский список FaceList.
+     * Поддерживаются записи вершин ("v x y z") и граней ("f i j k ...").
+     * Вершина грани записывается как "v", "v/vt", "v//vn" или "v/vt/vn";
+     * из нее берется только индекс позиции. Индексы, в том числе
+     * отрицательные (отсчет от последней прочитанной вершины), при разборе
+     * переводятся в индексы с нуля от начала файла.
+     *
+     * Большие файлы разбиваются на фрагменты по границам строк, которые
+     * разбираются параллельно в локальные буферы потоков и затем склеиваются в
+     * исходном порядке, так что результат не зависит от числа потоков.
+     */
+    class ObjParser {
+        public:
+            /**
+             * @brief Буферы фрагментов параллельного разбора.
+             *
+             * Перед разбором буферы очищаются, но память остается за ними,
+             * поэтому повторный разбор файла не больше прежнего не выделяет
+             * память под фрагменты.
+             */
+            struct Scratch {
+                /**
+                 * @brief Результат разбора одного фрагмента.
+                 */
+                struct Chunk {
+                    std::vector<glm::vec3> vertices; // Вершины фрагмента
+                    FaceList faces; // Грани фрагмента
+                    std::vector<size_t> relative; // Позиции индексов, отсчитанных от начала фрагмента
+                };
+
+                std::vector<Chunk> chunks; // Фрагменты в порядке файла
+            };
+
+            /**
+             * @brief Конструктор по умолчанию.
+             */
+            ObjParser() = default;
+
+            /**
+             * @brief Задает число потоков для разбора.
+             *
+             * @param count Число потоков; 0 означает число ядер процессора.
+             */
+            void set_threads(size_t count) { threads = count; }
+
+            /**
+             * @brief Возвращает фактическое число потоков для разбора.
+             *
+             * @return Число потоков (не меньше одного).
+             */
+            size_t thread_count() const;
+
+            /**
+             * @brief Задает объект для отчета о ходе разбора и его отмены.
+             *
+             * Разборщик примерно каждый мегабайт добавляет в него разобранные
+             * байты, вершины и грани и прекращает работу, если запрошена отмена.
+             *
+             * @param progress Ход загрузки или nullptr.
+             */
+            void set_progress(LoadProgress* progress) { this->progress = progress; }
+
+            /**
+             * @brief Задает очередь для публикации модели по мере разбора.
+             *
+             * Последовательный разбор публикует новые вершины и грани примерно
+             * каждый мегабайт. При параллельном разборе так публикуется первый
+             * фрагмент, а остальные - целиком по готовности, в порядке файла.
+             *
+             * @param stream Очередь публикации или nullptr.
+             */
+            void set_stream(LoadStream* stream) { this->stream = stream; }
+
+            /**
+             * @brief Задает буферы фрагментов для параллельного разбора.
+             *
+             * Без них фрагменты разбираются во временные буферы, которые
+             * освобождаются после склейки.
+             *
+             * @param scratch Буферы, переживающие разбор, или nullptr.
+             */
+            void set_scratch(Scratch* scratch) { this->scratch = scratch; }
+
+            /**
+             * @brief Загружает вершины и грани из файла.
+             *
+             * Файл отображается в память и разбирается на месте. Результат
+             * дописывается в конец переданных контейнеров.
+             *
+             * @param filename Путь к файлу с моделью.
+             * @param vertices Контейнер для вершин.
+             * @param faces Контейнер для граней.
+             * @return true, если файл удалось открыть и разбор не был отменен.
+             */
+            bool parse_file(const char* filename,
+                            std::vector<glm::vec3>& vertices,
+                            FaceList& faces);
+
+            /**
+             * @brief Разбирает текст .obj из буфера.
+             *
+             * @param begin Начало буфера.
+             * @param end Конец буфера.
+             * @param vertices Контейнер для вершин.
+             * @param faces Контейнер для граней.
+             * @return false, если разбор был отменен (содержимое контейнеров
+             * тогда не определено).
+             */
+            bool parse(const char* begin, const char* end,
+                       std::vector<glm::vec3>& vertices,
+                       FaceList& faces);
+
+            /**
+             * @brief Читает число с плавающей точкой.
+             *
+             * Пропускает ведущие пробелы. Результат совпадает с чтением через
+             * std::stringstream (корректное округление).
+             *
+             * @param p Текущая позиция.
+             * @param end Конец буфера.
+             * @param value Прочитанное значение.
+             * @return Позиция после числа или nullptr, если числа нет.
+             */
+            static const char* parse_float(const char* p, const char* end, float& value);
+
+            /**
+             * @brief Читает целое число со знаком.
+             *
+             * @param p Текущая позиция.
+             * @param end Конец буфера.
+             * @param value Прочитанное значение.
+             * @return Позиция после числа или nullptr, если числа нет.
+             */
+            static const char* parse_int(const char* p, const char* end, long long& value);
+
+        private:
+            /**
+             * @brief Последовательно разбирает фрагмент буфера.
+             *
+             * @param stream Очередь, в которую публикуется фрагмент (или nullptr).
+             * @param relative Куда записать позиции отрицательных индексов,
+             * разрешенных от начала фрагмента (nullptr - фрагмент с начала файла).
+             * @return false, если разбор был отменен.
+             */
+            bool parse_chunk(const char* begin, const char* end,
+                             std::vector<glm::vec3>& vertices,
+                             FaceList& faces, LoadStream* stream,
+                             std::vector<size_t>* relative);
+
+            /**
+             * @brief Разбирает буфер параллельно фрагментами по строкам.
+             *
+             * @return false, если разбор был отменен.
+             */
+            bool parse_parallel(const char* begin, const char* end, size_t workers,
+                                std::vector<glm::vec3>& vertices,
+                                FaceList& faces);
+
+            /**
+             * @brief Разбирает запись вершины (после префикса "v ").
+             */
+            static void parse_vertex(const char* p, const char* end,
+                                     std::vector<glm::vec3>& vertices);
+
+            /**
+             * @brief Разбирает запись грани (после префикса "f").
+             *
+             * @param vertex_count Сколько вершин фрагмента прочитано до грани.
+             * @param relative Куда записать позиции отрицательных индексов
+             * (или nullptr).
+             */
+            static void parse_face(const char* p, const char* end, size_t vertex_count,
+                                   FaceList& faces, std::vector<size_t>* relative);
+
+            size_t threads = 0; // Число потоков (0 - по числу ядер)
+            LoadProgress* progress = nullptr; // Ход загрузки (может отсутствовать)
+            LoadStream* stream = nullptr; // Очередь публикации (может отсутствовать)
+            Scratch* scratch = nullptr; // Буферы фрагментов (могут отсутствовать)
+    };
+} // namespace s21
+#endif
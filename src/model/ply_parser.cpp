@@ -0,0 +1,314 @@
+#include "ply_parser.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace s21 {
+
+    namespace {
+        // Как часто разбор граней сообщает о ходе и проверяет отмену
+        constexpr size_t kProgressFaces = 1 << 16;
+
+        // Числовые типы свойств PLY
+        enum class Type { kInt8, kUint8, kInt16, kUint16, kInt32, kUint32, kFloat32, kFloat64, kInvalid };
+
+        struct Property {
+            std::string name; // Имя свойства
+            Type type = Type::kInvalid; // Тип значения (для списка - тип элементов)
+            bool list = false; // Свойство - список
+            Type count_type = Type::kInvalid; // Тип длины списка
+        };
+
+        struct Element {
+            std::string name; // Имя элемента
+            size_t count = 0; // Число записей
+            std::vector<Property> properties; // Свойства в порядке файла
+        };
+
+        Type parse_type(const std::string& name){
+            static const struct { const char* name; Type type; } kTypes[] = {
+                {"char", Type::kInt8}, {"int8", Type::kInt8}, {"uchar", Type::kUint8}, {"uint8", Type::kUint8},
+                {"short", Type::kInt16}, {"int16", Type::kInt16}, {"ushort", Type::kUint16},
+                {"uint16", Type::kUint16}, {"int", Type::kInt32}, {"int32", Type::kInt32},
+                {"uint", Type::kUint32}, {"uint32", Type::kUint32}, {"float", Type::kFloat32},
+                {"float32", Type::kFloat32}, {"double", Type::kFloat64}, {"float64", Type::kFloat64}};
+            for(const auto& entry : kTypes){
+                if(name == entry.name){
+                    return entry.type;
+                }
+            }
+            return Type::kInvalid;
+        }
+
+        size_t type_size(Type type){
+            switch(type){
+                case Type::kInt8: case Type::kUint8: return 1;
+                case Type::kInt16: case Type::kUint16: return 2;
+                case Type::kInt32: case Type::kUint32: case Type::kFloat32: return 4;
+                case Type::kFloat64: return 8;
+                default: return 0;
+            }
+        }
+
+        template <typename T>
+        T load(const char* p){
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        double read_number(const char* p, Type type){
+            switch(type){
+                case Type::kInt8: return load<int8_t>(p);
+                case Type::kUint8: return load<uint8_t>(p);
+                case Type::kInt16: return load<int16_t>(p);
+                case Type::kUint16: return load<uint16_t>(p);
+                case Type::kInt32: return load<int32_t>(p);
+                case Type::kUint32: return load<uint32_t>(p);
+                case Type::kFloat32: return load<float>(p);
+                case Type::kFloat64: return load<double>(p);
+                default: return 0.0;
+            }
+        }
+
+        int64_t read_integer(const char* p, Type type){
+            switch(type){
+                case Type::kInt8: return load<int8_t>(p);
+                case Type::kUint8: return load<uint8_t>(p);
+                case Type::kInt16: return load<int16_t>(p);
+                case Type::kUint16: return load<uint16_t>(p);
+                case Type::kInt32: return load<int32_t>(p);
+                case Type::kUint32: return load<uint32_t>(p);
+                default: return static_cast<int64_t>(read_number(p, type));
+            }
+        }
+
+        // Читает заголовок; возвращает начало тела или nullptr
+        const char* parse_header(const char* p, const char* end, std::vector<Element>& elements){
+            bool binary = false;
+            bool first = true;
+            while(p < end){
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if(eol == nullptr){
+                    return nullptr;
+                }
+                const char* line_end = eol > p && eol[-1] == '\r' ? eol - 1 : eol;
+                std::vector<std::string> words;
+                for(const char* q = p; q < line_end;){
+                    while(q < line_end && (*q == ' ' || *q == '\t')){
+                        ++q;
+                    }
+                    const char* word = q;
+                    while(q < line_end && *q != ' ' && *q != '\t'){
+                        ++q;
+                    }
+                    if(q != word){
+                        words.emplace_back(word, q);
+                    }
+                }
+                p = eol + 1;
+                if(first){
+                    if(words.size() != 1 || words[0] != "ply"){
+                        return nullptr;
+                    }
+                    first = false;
+                } else if(words.empty() || words[0] == "comment" || words[0] == "obj_info"){
+                    continue;
+                } else if(words[0] == "format"){
+                    binary = words.size() >= 2 && words[1] == "binary_little_endian";
+                } else if(words[0] == "element" && words.size() == 3){
+                    Element element;
+                    element.name = words[1];
+                    element.count = std::strtoull(words[2].c_str(), nullptr, 10);
+                    elements.push_back(std::move(element));
+                } else if(words[0] == "property" && !elements.empty()){
+                    Property property;
+                    if(words.size() == 5 && words[1] == "list"){
+                        property.list = true;
+                        property.count_type = parse_type(words[2]);
+                        property.type = parse_type(words[3]);
+                        property.name = words[4];
+                        if(property.count_type == Type::kInvalid || property.count_type == Type::kFloat32 ||
+                           property.count_type == Type::kFloat64){
+                            return nullptr;
+                        }
+                    } else if(words.size() == 3){
+                        property.type = parse_type(words[1]);
+                        property.name = words[2];
+                    }
+                    if(property.type == Type::kInvalid){
+                        return nullptr;
+                    }
+                    elements.back().properties.push_back(std::move(property));
+                } else if(words[0] == "end_header"){
+                    return binary ? p : nullptr;
+                }
+            }
+            return nullptr;
+        }
+
+        // Размер записи без списков; 0, если в элементе есть списки
+        size_t fixed_stride(const Element& element){
+            size_t stride = 0;
+            for(const Property& property : element.properties){
+                if(property.list){
+                    return 0;
+                }
+                stride += type_size(property.type);
+            }
+            return stride;
+        }
+
+        // Наименьший размер записи: поля без списков и счетчики списков
+        size_t min_record_size(const Element& element){
+            size_t size = 0;
+            for(const Property& property : element.properties){
+                size += type_size(property.list ? property.count_type : property.type);
+            }
+            return size;
+        }
+    } // namespace
+
+    bool PlyParser::parse(const char* begin, const char* end,
+                          std::vector<glm::vec3>& vertices, FaceList& faces){
+        std::vector<Element> elements;
+        const char* p = parse_header(begin, end, elements);
+        if(p == nullptr){
+            return false;
+        }
+        if(progress != nullptr){
+            progress->advance(p - begin, 0, 0);
+        }
+        for(const Element& element : elements){
+            const char* start = p;
+            size_t stride = fixed_stride(element);
+            bool is_vertex = element.name == "vertex";
+            bool is_face = element.name == "face";
+            // Положение нужных свойств в записи (для записей без списков)
+            int axis_property[3] = {-1, -1, -1};
+            int index_property = -1;
+            for(size_t k = 0; k < element.properties.size(); ++k){
+                const Property& property = element.properties[k];
+                for(int axis = 0; axis < 3; ++axis){
+                    if(is_vertex && !property.list && property.name == std::string(1, char('x' + axis))){
+                        axis_property[axis] = static_cast<int>(k);
+                    }
+                }
+                if(is_face && property.list && (property.name == "vertex_indices" || property.name == "vertex_index")){
+                    index_property = static_cast<int>(k);
+                }
+            }
+
+            // Число записей из заголовка сверяется с остатком файла до
+            // выделения памяти: иначе строка "element face 4000000000000"
+            // в маленьком файле выделяла бы терабайты. Записи без полей не
+            // бывают у вершин и граней, остальные такие элементы пропускаются
+            size_t min_size = min_record_size(element);
+            if(min_size == 0){
+                if(element.count != 0 && (is_vertex || is_face)){
+                    return false;
+                }
+                continue;
+            }
+            if(static_cast<size_t>(end - p) / min_size < element.count){
+                return false;
+            }
+            if(is_vertex && stride == 12 && axis_property[0] == 0 && axis_property[1] == 1 &&
+               axis_property[2] == 2 && element.properties[0].type == Type::kFloat32 &&
+               element.properties[1].type == Type::kFloat32 && element.properties[2].type == Type::kFloat32){
+                // Вершины лежат в файле так же, как glm::vec3 в памяти
+                size_t base = vertices.size();
+                vertices.resize(base + element.count);
+                std::memcpy(vertices.data() + base, p, element.count * sizeof(glm::vec3));
+                p += element.count * stride;
+            } else if(stride != 0 && !is_vertex){
+                p += element.count * stride;
+            } else {
+                if(is_vertex){
+                    vertices.reserve(vertices.size() + element.count);
+                }
+                if(is_face){
+                    // Индексов не больше, чем их помещается в остаток файла
+                    size_t indices = 3 * element.count;
+                    if(index_property >= 0){
+                        indices = std::min(indices, static_cast<size_t>(end - p) /
+                                                        type_size(element.properties[index_property].type));
+                    }
+                    faces.reserve(faces.size() + element.count, faces.indices.size() + indices);
+                }
+                size_t reported_faces = 0;
+                for(size_t i = 0; i < element.count; ++i){
+                    float xyz[3] = {0.0f, 0.0f, 0.0f};
+                    for(size_t k = 0; k < element.properties.size(); ++k){
+                        const Property& property = element.properties[k];
+                        if(!property.list){
+                            size_t size = type_size(property.type);
+                            if(static_cast<size_t>(end - p) < size){
+                                return false;
+                            }
+                            for(int axis = 0; axis < 3; ++axis){
+                                if(axis_property[axis] == static_cast<int>(k)){
+                                    xyz[axis] = static_cast<float>(read_number(p, property.type));
+                                }
+                            }
+                            p += size;
+                            continue;
+                        }
+                        size_t count_size = type_size(property.count_type);
+                        size_t item_size = type_size(property.type);
+                        if(static_cast<size_t>(end - p) < count_size){
+                            return false;
+                        }
+                        int64_t count = read_integer(p, property.count_type);
+                        p += count_size;
+                        if(count < 0 || static_cast<uint64_t>(end - p) / item_size < static_cast<uint64_t>(count)){
+                            return false;
+                        }
+                        if(static_cast<int>(k) == index_property){
+                            size_t at = faces.indices.size();
+                            faces.indices.resize(at + count);
+                            if(property.type == Type::kInt32 || property.type == Type::kUint32){
+                                // int и uint: отрицательные индексы становятся
+                                // больше числа вершин и пропускаются; float
+                                // того же размера идет через преобразование
+                                std::memcpy(faces.indices.data() + at, p, count * item_size);
+                            } else {
+                                for(int64_t j = 0; j < count; ++j){
+                                    faces.indices[at + j] = static_cast<FaceList::index_type>(
+                                        read_integer(p + j * item_size, property.type));
+                                }
+                            }
+                            faces.close_face();
+                        }
+                        p += count * item_size;
+                    }
+                    if(is_vertex){
+                        vertices.emplace_back(xyz[0], xyz[1], xyz[2]);
+                    }
+                    if(is_face && progress != nullptr && (i + 1) % kProgressFaces == 0){
+                        progress->advance(p - start, 0, kProgressFaces);
+                        start = p;
+                        reported_faces = i + 1;
+                        if(progress->cancelled()){
+                            return false;
+                        }
+                    }
+                }
+                if(is_face && progress != nullptr){
+                    progress->advance(p - start, 0, element.count - reported_faces);
+                    start = p;
+                }
+            }
+            if(progress != nullptr){
+                progress->advance(p - start, is_vertex ? element.count : 0, 0);
+                if(progress->cancelled()){
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+} // namespace s21
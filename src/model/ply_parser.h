@@ -0,0 +1,52 @@
+#ifndef SRC_MODEL_PLY_PARSER_H
+#define SRC_MODEL_PLY_PARSER_H
+#include <cstddef>
+#include <glm/ext.hpp>
+#include <vector>
+
+#include "face_list.h"
+#include "load_progress.h"
+
+namespace s21 {
+    /**
+     * @brief Разборщик двоичных файлов формата .ply (little-endian).
+     *
+     * Текстовый заголовок описывает элементы файла и их свойства; тело
+     * читается прямо из отображенного в память файла. Из элемента "vertex"
+     * берутся свойства x, y, z (любого числового типа), из элемента "face" -
+     * список "vertex_indices" (или "vertex_index"); остальные элементы и
+     * свойства пропускаются. Если вершины - это ровно три float x, y, z,
+     * они копируются в модель одним memcpy; индексы граней типа int или
+     * uint копируются memcpy по грани. Индексы в PLY уже с нуля.
+     *
+     * Текстовый PLY и big-endian не поддерживаются: разбор возвращает false.
+     */
+    class PlyParser {
+        public:
+            /**
+             * @brief Задает объект для отчета о ходе разбора и его отмены.
+             *
+             * @param progress Ход загрузки или nullptr.
+             */
+            void set_progress(LoadProgress* progress) { this->progress = progress; }
+
+            /**
+             * @brief Разбирает PLY из буфера.
+             *
+             * Результат дописывается в конец контейнеров.
+             *
+             * @param begin Начало буфера.
+             * @param end Конец буфера.
+             * @param vertices Контейнер для вершин.
+             * @param faces Контейнер для граней.
+             * @return false, если формат не поддерживается, файл поврежден
+             * (короче заголовка) или разбор был отменен.
+             */
+            bool parse(const char* begin, const char* end,
+                       std::vector<glm::vec3>& vertices, FaceList& faces);
+
+        private:
+            LoadProgress* progress = nullptr; // Ход загрузки (может отсутствовать)
+    };
+} // namespace s21
+#endif
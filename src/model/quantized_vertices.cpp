@@ -0,0 +1,60 @@
+#include "quantized_vertices.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "thread_pool.h"
+#include "vertex_kernels.h"
+
+namespace s21 {
+
+    namespace {
+        // Сжимает вершины [begin, end) по готовым границам
+        void encode(const glm::vec3* vertices, size_t begin, size_t end, const glm::vec3& origin,
+                    const glm::vec3& inverse, uint16_t* codes){
+            for(size_t i = begin; i < end; ++i){
+                glm::vec3 code = (vertices[i] - origin) * inverse;
+                for(int k = 0; k < 3; ++k){
+                    float rounded = std::round(std::min(std::max(code[k], 0.0f),
+                                                        static_cast<float>(QuantizedVertices::kSteps)));
+                    codes[i * 3 + k] = static_cast<uint16_t>(rounded);
+                }
+            }
+        }
+    } // namespace
+
+    void QuantizedVertices::assign(const glm::vec3* vertices, size_t count){
+        VertexKernels::Bounds bounds = VertexKernels::reduce(vertices, count);
+        origin = bounds.min;
+        extent = bounds.max - bounds.min;
+        // Ось без размаха кодируется нулями
+        glm::vec3 inverse(0.0f);
+        for(int k = 0; k < 3; ++k){
+            if(extent[k] > 0.0f){
+                inverse[k] = static_cast<float>(kSteps) / extent[k];
+            }
+        }
+        codes.resize(count * 3);
+        ThreadPool& pool = ThreadPool::shared();
+        size_t parts = std::min(pool.size(), count / kMinParallelVertices);
+        if(parts > 1){
+            pool.parallel_for(count, parts, [&](size_t begin, size_t end){
+                encode(vertices, begin, end, origin, inverse, codes.data());
+            });
+        } else {
+            encode(vertices, 0, count, origin, inverse, codes.data());
+        }
+    }
+
+    void QuantizedVertices::clear(){
+        std::vector<uint16_t>().swap(codes);
+        origin = glm::vec3(0.0f);
+        extent = glm::vec3(0.0f);
+    }
+
+    void QuantizedVertices::decode(glm::vec3* vertices) const {
+        for(size_t i = 0; i < size(); ++i){
+            vertices[i] = (*this)[i];
+        }
+    }
+} // namespace s21
@@ -0,0 +1,121 @@
+#ifndef SRC_MODEL_QUANTIZED_VERTICES_H
+#define SRC_MODEL_QUANTIZED_VERTICES_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/ext.hpp>
+
+namespace s21 {
+    /**
+     * @brief Вершины, сжатые до 16-битных целых по каждой оси.
+     *
+     * Координата хранится как номер ступени сетки из 65536 значений между
+     * минимумом и максимумом вершин по этой оси: 6 байт на вершину вместо
+     * 12. Раскодирование - аффинное преобразование min + code / 65535 *
+     * (max - min), поэтому оно сворачивается в матрицу (см.
+     * dequantization_matrix) и выполняется в вершинном шейдере вместе с
+     * матрицей модели-вида-проекции.
+     *
+     * Коды - дополнительная копия для видеопамяти: Model продолжает
+     * хранить и преобразовывать вершины в float.
+     *
+     * Погрешность: каждая координата округляется к ближайшей ступени, то
+     * есть отличается от исходной не больше чем на полступени
+     * (max - min) / 131070 (error_bound), плюс ошибка округления float
+     * при раскодировании. После нормализации модель вписана в [-1, 1],
+     * ступень не больше 2 / 65535, и ошибка не превышает 1.6 * 10^-5
+     * половины размера модели - сотые доли пикселя даже на экране 4K.
+     */
+    class QuantizedVertices {
+        public:
+            static constexpr uint32_t kSteps = 65535; // Наибольший код по оси
+            static constexpr size_t kMinParallelVertices = 1 << 16; // Минимум вершин на поток сжатия
+
+            /**
+             * @brief Сжимает вершины.
+             *
+             * Границы находятся по самим вершинам; большие массивы сжимаются
+             * параллельно в общем пуле потоков.
+             *
+             * @param vertices Исходные вершины.
+             * @param count Количество вершин.
+             */
+            void assign(const glm::vec3* vertices, size_t count);
+
+            /**
+             * @brief Удаляет все вершины и освобождает память.
+             */
+            void clear();
+
+            /**
+             * @brief Возвращает количество вершин.
+             *
+             * @return Количество вершин.
+             */
+            size_t size() const { return codes.size() / 3; }
+
+            /**
+             * @brief Проверяет, нет ли вершин.
+             *
+             * @return true, если вершин нет.
+             */
+            bool empty() const { return codes.empty(); }
+
+            /**
+             * @brief Возвращает коды вершин (x y z x y z ...) для загрузки в VBO.
+             *
+             * @return Указатель на 3 * size() кодов.
+             */
+            const uint16_t* data() const { return codes.data(); }
+
+            /**
+             * @brief Раскодирует вершину.
+             *
+             * @param index Индекс вершины.
+             * @return Координаты вершины.
+             */
+            glm::vec3 operator[](size_t index) const {
+                const uint16_t* code = codes.data() + index * 3;
+                return origin + glm::vec3(code[0], code[1], code[2]) / static_cast<float>(kSteps) * extent;
+            }
+
+            /**
+             * @brief Раскодирует вершины в массив glm::vec3.
+             *
+             * @param vertices Куда записать вершины; размер не меньше size().
+             */
+            void decode(glm::vec3* vertices) const;
+
+            /**
+             * @brief Возвращает матрицу раскодирования.
+             *
+             * Переводит коды, нормализованные в [0, 1] (атрибут
+             * GL_UNSIGNED_SHORT с normalized = GL_TRUE), в координаты вершин.
+             *
+             * @return Матрица раскодирования.
+             */
+            glm::mat4 dequantization_matrix() const {
+                return glm::translate(glm::mat4(1.0f), origin) * glm::scale(glm::mat4(1.0f), extent);
+            }
+
+            /**
+             * @brief Возвращает наибольшую ошибку сжатия по каждой оси.
+             *
+             * @return Половина ступени сетки по осям (без ошибки округления float).
+             */
+            glm::vec3 error_bound() const { return extent / (2.0f * kSteps); }
+
+            /**
+             * @brief Возвращает объем памяти под коды.
+             *
+             * @return Размер в байтах.
+             */
+            size_t memory_bytes() const { return codes.capacity() * sizeof(uint16_t); }
+
+        private:
+            std::vector<uint16_t> codes; // Коды вершин по осям
+            glm::vec3 origin = glm::vec3(0.0f); // Минимум вершин (код 0)
+            glm::vec3 extent = glm::vec3(0.0f); // Размах вершин (код kSteps)
+    };
+} // namespace s21
+#endif
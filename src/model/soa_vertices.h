@@ -0,0 +1,166 @@
+#ifndef SRC_MODEL_SOA_VERTICES_H
+#define SRC_MODEL_SOA_VERTICES_H
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <glm/ext.hpp>
+
+#include "vertex_kernels.h"
+
+namespace s21 {
+    /**
+     * @brief Аллокатор с выравниванием по Alignment байт.
+     *
+     * Нужен, чтобы массивы координат начинались на границе регистра AVX.
+     */
+    template<typename T, size_t Alignment>
+    class AlignedAllocator {
+        public:
+            using value_type = T;
+
+            template<typename U>
+            struct rebind {
+                using other = AlignedAllocator<U, Alignment>;
+            };
+
+            AlignedAllocator() = default;
+
+            template<typename U>
+            AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+            T* allocate(size_t count){
+                // aligned_alloc требует размер, кратный выравниванию
+                size_t bytes = (count * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+                void* ptr = std::aligned_alloc(Alignment, bytes != 0 ? bytes : Alignment);
+                if(ptr == nullptr){
+                    throw std::bad_alloc();
+                }
+                return static_cast<T*>(ptr);
+            }
+
+            void deallocate(T* ptr, size_t) { std::free(ptr); }
+
+            template<typename U>
+            bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+
+            template<typename U>
+            bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+    };
+
+    /**
+     * @brief Вершины в раздельном хранении (structure of arrays).
+     *
+     * Координаты x, y и z лежат в трех отдельных массивах, выровненных по
+     * 32 байтам. В таком виде векторные ядра читают координаты без
+     * перестановок, а свертки (границы, центр) идут по непрерывной памяти.
+     * Для загрузки в видеопамять вершины собираются обратно в glm::vec3
+     * методом export_interleaved.
+     */
+    class SoaVertices {
+        public:
+            static constexpr size_t kAlignment = 32; // Выравнивание массивов (регистр AVX)
+
+            using Array = std::vector<float, AlignedAllocator<float, kAlignment>>;
+
+            /**
+             * @brief Возвращает количество вершин.
+             *
+             * @return Количество вершин.
+             */
+            size_t size() const { return xs.size(); }
+
+            /**
+             * @brief Проверяет, нет ли вершин.
+             *
+             * @return true, если вершин нет.
+             */
+            bool empty() const { return xs.empty(); }
+
+            /**
+             * @brief Удаляет все вершины.
+             */
+            void clear(){
+                xs.clear();
+                ys.clear();
+                zs.clear();
+            }
+
+            /**
+             * @brief Заменяет содержимое вершинами из массива glm::vec3.
+             *
+             * @param vertices Исходные вершины.
+             * @param count Количество вершин.
+             */
+            void assign(const glm::vec3* vertices, size_t count){
+                xs.resize(count);
+                ys.resize(count);
+                zs.resize(count);
+                VertexKernels::deinterleave(vertices, count, xs.data(), ys.data(), zs.data());
+            }
+
+            /**
+             * @brief Собирает вершины в массив glm::vec3 (например, для загрузки в VBO).
+             *
+             * @param vertices Куда записать вершины; размер не меньше size().
+             */
+            void export_interleaved(glm::vec3* vertices) const {
+                VertexKernels::interleave(xs.data(), ys.data(), zs.data(), size(), vertices);
+            }
+
+            /**
+             * @brief Применяет аффинное преобразование ко всем вершинам.
+             *
+             * @param matrix Матрица преобразования.
+             */
+            void transform(const glm::mat4& matrix){
+                transform(matrix, 0, size());
+            }
+
+            /**
+             * @brief Применяет аффинное преобразование к вершинам [begin, end).
+             *
+             * @param matrix Матрица преобразования.
+             * @param begin Индекс первой вершины.
+             * @param end Индекс за последней вершиной.
+             */
+            void transform(const glm::mat4& matrix, size_t begin, size_t end){
+                VertexKernels::transform(xs.data() + begin, ys.data() + begin, zs.data() + begin,
+                                         end - begin, matrix);
+            }
+
+            /**
+             * @brief Находит ограничивающий параллелепипед и центр вершин.
+             *
+             * @return Минимум, максимум и центр.
+             */
+            VertexKernels::Bounds bounds() const {
+                return VertexKernels::reduce(xs.data(), ys.data(), zs.data(), size());
+            }
+
+            /**
+             * @brief Возвращает вершину по индексу.
+             *
+             * @param index Индекс вершины.
+             * @return Координаты вершины.
+             */
+            glm::vec3 operator[](size_t index) const { return glm::vec3(xs[index], ys[index], zs[index]); }
+
+            const float* x() const { return xs.data(); } // Координаты x
+            const float* y() const { return ys.data(); } // Координаты y
+            const float* z() const { return zs.data(); } // Координаты z
+
+            /**
+             * @brief Возвращает объем памяти под координаты.
+             *
+             * @return Размер в байтах.
+             */
+            size_t memory_bytes() const { return (xs.capacity() + ys.capacity() + zs.capacity()) * sizeof(float); }
+
+        private:
+            Array xs; // Координаты x
+            Array ys; // Координаты y
+            Array zs; // Координаты z
+    };
+} // namespace s21
+#endif
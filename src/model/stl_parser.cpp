@@ -0,0 +1,191 @@
+#include "stl_parser.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "obj_parser.h"
+
+namespace s21 {
+
+    namespace {
+        // Как часто разбор сообщает о ходе и проверяет отмену
+        constexpr size_t kProgressTriangles = 1 << 16;
+        constexpr size_t kProgressStep = 1 << 20;
+
+        inline bool is_blank(char c){
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        // Слияние одинаковых вершин: хеш-таблица с открытой адресацией,
+        // слоты хранят номера вершин, а ключом служат сами координаты
+        class VertexWelder {
+            public:
+                VertexWelder(std::vector<glm::vec3>& vertices, size_t expected)
+                    : vertices(vertices), base(vertices.size()){
+                    size_t capacity = 16;
+                    while(capacity < expected * 2){
+                        capacity *= 2;
+                    }
+                    slots.assign(capacity, kEmpty);
+                    vertices.reserve(base + expected);
+                }
+
+                // Индекс вершины от первой вершины разбора; новая вершина
+                // дописывается в конец
+                FaceList::index_type add(glm::vec3 vertex){
+                    // -0 + 0 = +0: обе записи нуля дают один ключ
+                    vertex += glm::vec3(0.0f);
+                    if((count + 1) * 2 > slots.size()){
+                        grow();
+                    }
+                    size_t mask = slots.size() - 1;
+                    for(size_t slot = slot_of(vertex, mask); ; slot = (slot + 1) & mask){
+                        uint32_t id = slots[slot];
+                        if(id == kEmpty){
+                            id = static_cast<uint32_t>(vertices.size() - base);
+                            slots[slot] = id;
+                            vertices.push_back(vertex);
+                            ++count;
+                            return id;
+                        }
+                        if(std::memcmp(&vertices[base + id], &vertex, sizeof(glm::vec3)) == 0){
+                            return id;
+                        }
+                    }
+                }
+
+            private:
+                static constexpr uint32_t kEmpty = ~uint32_t(0);
+
+                static size_t slot_of(const glm::vec3& vertex, size_t mask){
+                    uint32_t bits[3];
+                    std::memcpy(bits, &vertex, sizeof(bits));
+                    uint64_t key = (uint64_t(bits[0]) | uint64_t(bits[1]) << 32) * 0x9E3779B97F4A7C15ull ^
+                                   uint64_t(bits[2]) * 0xC2B2AE3D27D4EB4Full;
+                    return static_cast<size_t>(key >> 32 ^ key) & mask;
+                }
+
+                void grow(){
+                    std::vector<uint32_t> old(slots.size() * 2, kEmpty);
+                    old.swap(slots);
+                    size_t mask = slots.size() - 1;
+                    for(uint32_t id : old){
+                        if(id == kEmpty){
+                            continue;
+                        }
+                        size_t slot = slot_of(vertices[base + id], mask);
+                        while(slots[slot] != kEmpty){
+                            slot = (slot + 1) & mask;
+                        }
+                        slots[slot] = id;
+                    }
+                }
+
+                std::vector<glm::vec3>& vertices; // Вершины модели
+                size_t base; // Первая вершина разбора
+                std::vector<uint32_t> slots; // Номера вершин или kEmpty
+                size_t count = 0; // Число занятых слотов
+        };
+
+        // Проверяет, начинается ли строка [p, end) со слова word
+        inline bool starts_with(const char* p, const char* end, const char* word, size_t length){
+            return static_cast<size_t>(end - p) >= length && std::memcmp(p, word, length) == 0 &&
+                   (static_cast<size_t>(end - p) == length || is_blank(p[length]));
+        }
+    } // namespace
+
+    bool StlParser::parse_binary(const char* begin, const char* end,
+                                 std::vector<glm::vec3>& vertices, FaceList& faces){
+        constexpr size_t kHeader = 84;
+        constexpr size_t kRecord = 50; // Нормаль, три вершины, атрибут
+        if(end - begin < static_cast<std::ptrdiff_t>(kHeader)){
+            return false;
+        }
+        uint32_t triangles;
+        std::memcpy(&triangles, begin + 80, sizeof(triangles));
+        if(static_cast<size_t>(end - begin - kHeader) / kRecord < triangles){
+            return false;
+        }
+        // В замкнутой треугольной сетке вершин примерно вдвое меньше граней
+        VertexWelder welder(vertices, triangles / 2 + 3);
+        faces.reserve(faces.size() + triangles, faces.index_data().size() + size_t(3) * triangles);
+        size_t reported_vertices = vertices.size();
+        const char* record = begin + kHeader;
+        for(size_t i = 0; i < triangles; ++i, record += kRecord){
+            glm::vec3 corners[3];
+            std::memcpy(corners, record + 12, sizeof(corners));
+            FaceList::index_type face[3] = {welder.add(corners[0]), welder.add(corners[1]),
+                                            welder.add(corners[2])};
+            faces.push_face(face, 3);
+            if(progress != nullptr && (i + 1) % kProgressTriangles == 0){
+                progress->advance(kProgressTriangles * kRecord, vertices.size() - reported_vertices,
+                                  kProgressTriangles);
+                reported_vertices = vertices.size();
+                if(progress->cancelled()){
+                    return false;
+                }
+            }
+        }
+        if(progress != nullptr){
+            size_t rest = triangles % kProgressTriangles;
+            progress->advance(rest * kRecord + kHeader, vertices.size() - reported_vertices, rest);
+        }
+        return true;
+    }
+
+    bool StlParser::parse_ascii(const char* begin, const char* end,
+                                std::vector<glm::vec3>& vertices, FaceList& faces){
+        // Оценка по размеру: около 250 байт текста на треугольник
+        VertexWelder welder(vertices, static_cast<size_t>(end - begin) / 500 + 3);
+        const char* p = begin;
+        const char* reported = p;
+        size_t reported_vertices = vertices.size();
+        size_t reported_faces = faces.size();
+        bool open = false;
+        while(p < end){
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if(eol == nullptr){
+                eol = end;
+            }
+            while(p < eol && is_blank(*p)){
+                ++p;
+            }
+            if(starts_with(p, eol, "vertex", 6)){
+                float xyz[3] = {0.0f, 0.0f, 0.0f};
+                const char* q = p + 6;
+                for(float& coord : xyz){
+                    q = ObjParser::parse_float(q, eol, coord);
+                    if(q == nullptr){
+                        // Испорченная вершина дала бы неверную геометрию
+                        return false;
+                    }
+                }
+                faces.push_index(welder.add(glm::vec3(xyz[0], xyz[1], xyz[2])));
+                open = true;
+            } else if(open && starts_with(p, eol, "endloop", 7)){
+                faces.close_face();
+                open = false;
+            }
+            p = eol < end ? eol + 1 : end;
+            if(progress != nullptr && p - reported >= static_cast<std::ptrdiff_t>(kProgressStep)){
+                progress->advance(p - reported, vertices.size() - reported_vertices,
+                                  faces.size() - reported_faces);
+                reported = p;
+                reported_vertices = vertices.size();
+                reported_faces = faces.size();
+                if(progress->cancelled()){
+                    return false;
+                }
+            }
+        }
+        if(open){
+            faces.close_face();
+        }
+        if(progress != nullptr){
+            progress->advance(end - reported, vertices.size() - reported_vertices,
+                              faces.size() - reported_faces);
+            return !progress->cancelled();
+        }
+        return true;
+    }
+} // namespace s21
@@ -0,0 +1,69 @@
+#ifndef SRC_MODEL_STL_PARSER_H
+#define SRC_MODEL_STL_PARSER_H
+#include <cstddef>
+#include <glm/ext.hpp>
+#include <vector>
+
+#include "face_list.h"
+#include "load_progress.h"
+
+namespace s21 {
+    /**
+     * @brief Разборщик файлов формата .stl (двоичного и текстового).
+     *
+     * В STL каждый треугольник хранит свои три вершины целиком, поэтому
+     * общие вершины повторяются в среднем шесть раз. При разборе они
+     * сливаются хеш-таблицей по точному значению координат (-0 и +0
+     * считаются одной координатой), и модель получает обычный список
+     * вершин и граней с индексами с нуля. Нормали граней не читаются.
+     *
+     * Двоичный STL читается прямо из отображенного в память файла: вершины
+     * треугольника копируются одним memcpy. Числа в файле - little-endian,
+     * как и на поддерживаемых машинах (x86, ARM).
+     */
+    class StlParser {
+        public:
+            /**
+             * @brief Задает объект для отчета о ходе разбора и его отмены.
+             *
+             * @param progress Ход загрузки или nullptr.
+             */
+            void set_progress(LoadProgress* progress) { this->progress = progress; }
+
+            /**
+             * @brief Разбирает двоичный STL из буфера.
+             *
+             * Результат дописывается в конец контейнеров; индексы отсчитываются
+             * от первой дописанной вершины.
+             *
+             * @param begin Начало буфера.
+             * @param end Конец буфера.
+             * @param vertices Контейнер для вершин.
+             * @param faces Контейнер для граней.
+             * @return false, если файл короче объявленного числа треугольников
+             * или разбор был отменен.
+             */
+            bool parse_binary(const char* begin, const char* end,
+                              std::vector<glm::vec3>& vertices, FaceList& faces);
+
+            /**
+             * @brief Разбирает текстовый STL из буфера.
+             *
+             * Каждая пара "outer loop" ... "endloop" дает одну грань из
+             * вершин "vertex x y z" между ними.
+             *
+             * @param begin Начало буфера.
+             * @param end Конец буфера.
+             * @param vertices Контейнер для вершин.
+             * @param faces Контейнер для граней.
+             * @return false, если у вершины не читаются три координаты или разбор
+             * был отменен.
+             */
+            bool parse_ascii(const char* begin, const char* end,
+                             std::vector<glm::vec3>& vertices, FaceList& faces);
+
+        private:
+            LoadProgress* progress = nullptr; // Ход загрузки (может отсутствовать)
+    };
+} // namespace s21
+#endif
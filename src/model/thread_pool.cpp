@@ -0,0 +1,84 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+    ThreadPool::ThreadPool(size_t threads){
+        if(threads == 0){
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers.reserve(threads - 1);
+        for(size_t i = 1; i < threads; ++i){
+            workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool(){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for(auto& worker : workers){
+            worker.join();
+        }
+    }
+
+    ThreadPool& ThreadPool::shared(){
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::worker_loop(){
+        for(;;){
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if(tasks.empty()){
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    void ThreadPool::parallel_for(size_t count, size_t parts,
+                                  const std::function<void(size_t, size_t)>& body){
+        parts = std::min({parts, size(), count});
+        if(parts <= 1){
+            if(count != 0){
+                body(0, count);
+            }
+            return;
+        }
+
+        size_t step = (count + parts - 1) / parts;
+        std::mutex done_mutex;
+        std::condition_variable done;
+        // Части, кроме первой, уходят в очередь; из-за округления шага их
+        // может оказаться меньше parts - 1
+        size_t remaining = (count - 1) / step;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for(size_t begin = step; begin < count; begin += step){
+                size_t end = std::min(begin + step, count);
+                tasks.emplace_back([&, begin, end] {
+                    body(begin, end);
+                    std::lock_guard<std::mutex> done_lock(done_mutex);
+                    if(--remaining == 0){
+                        done.notify_one();
+                    }
+                });
+            }
+        }
+        ready.notify_all();
+
+        body(0, std::min(step, count));
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+} // namespace s21
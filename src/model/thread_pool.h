@@ -0,0 +1,77 @@
+#ifndef SRC_MODEL_THREAD_POOL_H
+#define SRC_MODEL_THREAD_POOL_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+    /**
+     * @brief Небольшой пул потоков для параллельной обработки массивов.
+     *
+     * Потоки создаются один раз и ждут задач, поэтому параллельный проход по
+     * вершинам не платит за создание потоков на каждом преобразовании.
+     * Задачи пула не должны сами вызывать parallel_for того же пула.
+     */
+    class ThreadPool {
+        public:
+            /**
+             * @brief Создает пул.
+             *
+             * @param threads Общее число потоков вместе с вызывающим; 0 - по числу ядер.
+             */
+            explicit ThreadPool(size_t threads = 0);
+
+            /**
+             * @brief Дожидается текущих задач и останавливает потоки.
+             */
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            /**
+             * @brief Возвращает число потоков вместе с вызывающим.
+             *
+             * @return Число потоков.
+             */
+            size_t size() const { return workers.size() + 1; }
+
+            /**
+             * @brief Делит диапазон [0, count) на части и обрабатывает их параллельно.
+             *
+             * Диапазон делится на parts непрерывных частей (но не больше size()).
+             * Одну часть выполняет вызывающий поток; метод возвращается, когда
+             * обработаны все части.
+             *
+             * @param count Размер диапазона.
+             * @param parts Желаемое число частей.
+             * @param body Обработчик части: body(begin, end).
+             */
+            void parallel_for(size_t count, size_t parts,
+                              const std::function<void(size_t, size_t)>& body);
+
+            /**
+             * @brief Возвращает общий пул программы (по числу ядер).
+             *
+             * @return Общий пул.
+             */
+            static ThreadPool& shared();
+
+        private:
+            /**
+             * @brief Цикл рабочего потока: берет задачи из очереди.
+             */
+            void worker_loop();
+
+            std::vector<std::thread> workers; // Рабочие потоки
+            std::deque<std::function<void()>> tasks; // Очередь задач
+            std::mutex mutex; // Защищает tasks и stopping
+            std::condition_variable ready; // Появилась задача или пул останавливается
+            bool stopping = false; // Признак остановки пула
+    };
+} // namespace s21
+#endif
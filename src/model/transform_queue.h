@@ -0,0 +1,98 @@
+#ifndef SRC_MODEL_TRANSFORM_QUEUE_H
+#define SRC_MODEL_TRANSFORM_QUEUE_H
+#include <cmath>
+#include <glm/ext.hpp>
+
+namespace s21 {
+    /**
+     * @brief Накопленные изменения положения, поворота и масштаба модели.
+     *
+     * Положение и углы поворота - целевые значения (последнее побеждает),
+     * масштаб - произведение всех запрошенных коэффициентов.
+     */
+    struct TransformUpdate {
+        bool has_position = false; // Задано ли новое положение центра
+        glm::vec3 position; // Новое положение центра
+        bool has_angle[3] = {false, false, false}; // Заданы ли углы по осям x, y, z
+        glm::vec3 angles; // Новые углы поворота по осям, градусы
+        float scale = 1.0f; // Общий коэффициент масштаба
+
+        /**
+         * @brief Проверяет, есть ли изменения.
+         *
+         * @return true, если ничего не запрошено.
+         */
+        bool empty() const {
+            return !has_position && !has_angle[0] && !has_angle[1] && !has_angle[2] && scale == 1.0f;
+        }
+    };
+
+    /**
+     * @brief Очередь изменений преобразования модели.
+     *
+     * Запросы из полей ввода не применяются сразу, а сливаются в одно
+     * изменение: промежуточные значения ("1", "12" на пути к "120")
+     * заменяются последним, коэффициенты масштаба перемножаются. Очередь
+     * разбирается один раз за кадр (Model::apply), поэтому сколько бы
+     * запросов ни пришло между кадрами, вершины переписываются не больше
+     * одного раза.
+     */
+    class TransformQueue {
+        public:
+            /**
+             * @brief Запрашивает новое положение центра модели.
+             *
+             * @param position Положение центра.
+             */
+            void set_position(const glm::vec3& position){
+                pending.has_position = true;
+                pending.position = position;
+            }
+
+            /**
+             * @brief Запрашивает новый угол поворота вокруг оси координат.
+             *
+             * @param angle Угол, градусы.
+             * @param axis Ось координат (берется наибольшая по модулю компонента).
+             */
+            void set_rotation(float angle, const glm::vec3& axis){
+                int index = 0;
+                for(int k = 1; k < 3; ++k){
+                    if(std::fabs(axis[k]) > std::fabs(axis[index])){
+                        index = k;
+                    }
+                }
+                pending.has_angle[index] = true;
+                pending.angles[index] = axis[index] < 0.0f ? -angle : angle;
+            }
+
+            /**
+             * @brief Запрашивает масштабирование.
+             *
+             * @param factor Коэффициент масштаба.
+             */
+            void scale(float factor){ pending.scale *= factor; }
+
+            /**
+             * @brief Проверяет, есть ли неразобранные запросы.
+             *
+             * @return true, если очередь не пуста.
+             */
+            bool has_pending() const { return !pending.empty(); }
+
+            /**
+             * @brief Забирает накопленное изменение и очищает очередь.
+             *
+             * @return Слитое изменение.
+             */
+            TransformUpdate take(){
+                TransformUpdate result = pending;
+                pending = TransformUpdate();
+                return result;
+            }
+
+        private:
+            TransformUpdate pending; // Накопленное изменение
+    };
+} // namespace s21
+#endif
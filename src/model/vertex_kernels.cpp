@@ -0,0 +1,615 @@
+#include "vertex_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#define S21_X86_KERNELS 1
+#endif
+
+namespace s21 {
+
+    namespace {
+        // Вершин в блоке, сумма которого копится во float перед переносом в double
+        constexpr size_t kSumBlock = 1024;
+
+        using Isa = VertexKernels::Isa;
+
+        // Матрица хранится по столбцам: m[column * 4 + row]
+        inline void transform_vertex(float* v, const float* m){
+            float x = v[0], y = v[1], z = v[2];
+            v[0] = m[0] * x + m[4] * y + m[8] * z + m[12];
+            v[1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+            v[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+        }
+
+        void transform_scalar(float* p, size_t count, const float* m){
+            for(size_t i = 0; i < count; ++i, p += 3){
+                transform_vertex(p, m);
+            }
+        }
+
+        // Частичный результат свертки; суммы блоков добавляются в sum
+        struct Accumulator {
+            float min[3] = {std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::max()};
+            float max[3] = {std::numeric_limits<float>::lowest(),
+                            std::numeric_limits<float>::lowest(),
+                            std::numeric_limits<float>::lowest()};
+            double sum[3] = {0.0, 0.0, 0.0};
+        };
+
+        void reduce_scalar(const float* p, size_t count, Accumulator& acc){
+            while(count != 0){
+                size_t block = std::min(count, kSumBlock);
+                float sum[3] = {0.0f, 0.0f, 0.0f};
+                for(size_t i = 0; i < block; ++i, p += 3){
+                    for(int k = 0; k < 3; ++k){
+                        acc.min[k] = std::min(acc.min[k], p[k]);
+                        acc.max[k] = std::max(acc.max[k], p[k]);
+                        sum[k] += p[k];
+                    }
+                }
+                for(int k = 0; k < 3; ++k){
+                    acc.sum[k] += sum[k];
+                }
+                count -= block;
+            }
+        }
+
+        void transform_soa_scalar(float* x, float* y, float* z, size_t count, const float* m){
+            for(size_t i = 0; i < count; ++i){
+                float v[3] = {x[i], y[i], z[i]};
+                transform_vertex(v, m);
+                x[i] = v[0];
+                y[i] = v[1];
+                z[i] = v[2];
+            }
+        }
+
+        // Свертка одной оси раздельного хранения (k - номер оси в acc)
+        void reduce_axis_scalar(const float* p, size_t count, Accumulator& acc, int k){
+            while(count != 0){
+                size_t block = std::min(count, kSumBlock);
+                float sum = 0.0f;
+                for(size_t i = 0; i < block; ++i){
+                    acc.min[k] = std::min(acc.min[k], p[i]);
+                    acc.max[k] = std::max(acc.max[k], p[i]);
+                    sum += p[i];
+                }
+                acc.sum[k] += sum;
+                p += block;
+                count -= block;
+            }
+        }
+
+        void deinterleave_scalar(const float* p, size_t count, float* x, float* y, float* z){
+            for(size_t i = 0; i < count; ++i, p += 3){
+                x[i] = p[0];
+                y[i] = p[1];
+                z[i] = p[2];
+            }
+        }
+
+        void interleave_scalar(const float* x, const float* y, const float* z, size_t count, float* p){
+            for(size_t i = 0; i < count; ++i, p += 3){
+                p[0] = x[i];
+                p[1] = y[i];
+                p[2] = z[i];
+            }
+        }
+
+#ifdef S21_X86_KERNELS
+        // Перестановка элементов: (a[e0], a[e1], b[e2], b[e3]) в каждой 128-битной половине
+#define S21_SHUF(shuffle, a, b, e0, e1, e2, e3) shuffle(a, b, _MM_SHUFFLE(e3, e2, e1, e0))
+
+        // Четыре вершины в трех регистрах (a = x0 y0 z0 x1, b = y1 z1 x2 y2,
+        // c = z2 x3 y3 z3) раскладываются в регистры x, y, z и обратно
+#define S21_DEINTERLEAVE(shuffle, a, b, c, x, y, z)                                        \
+        x = S21_SHUF(shuffle, S21_SHUF(shuffle, a, a, 0, 0, 3, 3),                         \
+                     S21_SHUF(shuffle, b, c, 2, 2, 1, 1), 0, 2, 0, 2);                     \
+        y = S21_SHUF(shuffle, S21_SHUF(shuffle, a, b, 1, 1, 0, 0),                         \
+                     S21_SHUF(shuffle, b, c, 3, 3, 2, 2), 0, 2, 0, 2);                     \
+        z = S21_SHUF(shuffle, S21_SHUF(shuffle, a, b, 2, 2, 1, 1),                         \
+                     S21_SHUF(shuffle, c, c, 0, 0, 3, 3), 0, 2, 0, 2)
+
+#define S21_INTERLEAVE(shuffle, x, y, z, a, b, c)                                          \
+        a = S21_SHUF(shuffle, S21_SHUF(shuffle, x, y, 0, 0, 0, 0),                         \
+                     S21_SHUF(shuffle, z, x, 0, 0, 1, 1), 0, 2, 0, 2);                     \
+        b = S21_SHUF(shuffle, S21_SHUF(shuffle, y, z, 1, 1, 1, 1),                         \
+                     S21_SHUF(shuffle, x, y, 2, 2, 2, 2), 0, 2, 0, 2);                     \
+        c = S21_SHUF(shuffle, S21_SHUF(shuffle, z, x, 2, 2, 3, 3),                         \
+                     S21_SHUF(shuffle, y, z, 3, 3, 3, 3), 0, 2, 0, 2)
+
+        // Строка матрицы, примененная к регистрам x, y, z в порядке transform_vertex
+#define S21_AFFINE(add, mul, m0, m1, m2, m3, x, y, z)                                      \
+        add(add(add(mul(m0, x), mul(m1, y)), mul(m2, z)), m3)
+
+        __attribute__((target("sse2")))
+        void transform_sse(float* p, size_t count, const float* m){
+            __m128 c[12];
+            for(int k = 0; k < 12; ++k){
+                c[k] = _mm_set1_ps(m[(k / 3) * 4 + k % 3]);
+            }
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4, p += 12){
+                __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), d = _mm_loadu_ps(p + 8);
+                __m128 x, y, z;
+                S21_DEINTERLEAVE(_mm_shuffle_ps, a, b, d, x, y, z);
+                __m128 rx = S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[0], c[3], c[6], c[9], x, y, z);
+                __m128 ry = S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[1], c[4], c[7], c[10], x, y, z);
+                __m128 rz = S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[2], c[5], c[8], c[11], x, y, z);
+                S21_INTERLEAVE(_mm_shuffle_ps, rx, ry, rz, a, b, d);
+                _mm_storeu_ps(p, a);
+                _mm_storeu_ps(p + 4, b);
+                _mm_storeu_ps(p + 8, d);
+            }
+            transform_scalar(p, count - i, m);
+        }
+
+        __attribute__((target("sse2")))
+        void reduce_sse(const float* p, size_t count, Accumulator& acc){
+            __m128 min[3], max[3];
+            for(int k = 0; k < 3; ++k){
+                min[k] = _mm_set1_ps(acc.min[k]);
+                max[k] = _mm_set1_ps(acc.max[k]);
+            }
+            size_t vectorized = count - count % 4;
+            for(size_t done = 0; done < vectorized; ){
+                size_t block = std::min(vectorized - done, kSumBlock);
+                __m128 sum[3] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+                for(size_t i = 0; i < block; i += 4, p += 12){
+                    __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), d = _mm_loadu_ps(p + 8);
+                    __m128 xyz[3];
+                    S21_DEINTERLEAVE(_mm_shuffle_ps, a, b, d, xyz[0], xyz[1], xyz[2]);
+                    for(int k = 0; k < 3; ++k){
+                        min[k] = _mm_min_ps(min[k], xyz[k]);
+                        max[k] = _mm_max_ps(max[k], xyz[k]);
+                        sum[k] = _mm_add_ps(sum[k], xyz[k]);
+                    }
+                }
+                for(int k = 0; k < 3; ++k){
+                    alignas(16) float lanes[4];
+                    _mm_store_ps(lanes, sum[k]);
+                    acc.sum[k] += static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+                }
+                done += block;
+            }
+            for(int k = 0; k < 3; ++k){
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, min[k]);
+                acc.min[k] = *std::min_element(lanes, lanes + 4);
+                _mm_store_ps(lanes, max[k]);
+                acc.max[k] = *std::max_element(lanes, lanes + 4);
+            }
+            reduce_scalar(p, count - vectorized, acc);
+        }
+
+        __attribute__((target("sse2")))
+        void transform_soa_sse(float* x, float* y, float* z, size_t count, const float* m){
+            __m128 c[12];
+            for(int k = 0; k < 12; ++k){
+                c[k] = _mm_set1_ps(m[(k / 3) * 4 + k % 3]);
+            }
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4){
+                __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+                _mm_storeu_ps(x + i, S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[0], c[3], c[6], c[9], vx, vy, vz));
+                _mm_storeu_ps(y + i, S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[1], c[4], c[7], c[10], vx, vy, vz));
+                _mm_storeu_ps(z + i, S21_AFFINE(_mm_add_ps, _mm_mul_ps, c[2], c[5], c[8], c[11], vx, vy, vz));
+            }
+            transform_soa_scalar(x + i, y + i, z + i, count - i, m);
+        }
+
+        __attribute__((target("sse2")))
+        void reduce_axis_sse(const float* p, size_t count, Accumulator& acc, int k){
+            __m128 min = _mm_set1_ps(acc.min[k]), max = _mm_set1_ps(acc.max[k]);
+            size_t vectorized = count - count % 4;
+            for(size_t done = 0; done < vectorized; ){
+                size_t block = std::min(vectorized - done, kSumBlock);
+                __m128 sum = _mm_setzero_ps();
+                for(size_t i = 0; i < block; i += 4, p += 4){
+                    __m128 v = _mm_loadu_ps(p);
+                    min = _mm_min_ps(min, v);
+                    max = _mm_max_ps(max, v);
+                    sum = _mm_add_ps(sum, v);
+                }
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, sum);
+                acc.sum[k] += static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+                done += block;
+            }
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, min);
+            acc.min[k] = *std::min_element(lanes, lanes + 4);
+            _mm_store_ps(lanes, max);
+            acc.max[k] = *std::max_element(lanes, lanes + 4);
+            reduce_axis_scalar(p, count - vectorized, acc, k);
+        }
+
+        __attribute__((target("sse2")))
+        void deinterleave_sse(const float* p, size_t count, float* x, float* y, float* z){
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4, p += 12){
+                __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), d = _mm_loadu_ps(p + 8);
+                __m128 vx, vy, vz;
+                S21_DEINTERLEAVE(_mm_shuffle_ps, a, b, d, vx, vy, vz);
+                _mm_storeu_ps(x + i, vx);
+                _mm_storeu_ps(y + i, vy);
+                _mm_storeu_ps(z + i, vz);
+            }
+            deinterleave_scalar(p, count - i, x + i, y + i, z + i);
+        }
+
+        __attribute__((target("sse2")))
+        void interleave_sse(const float* x, const float* y, const float* z, size_t count, float* p){
+            size_t i = 0;
+            for(; i + 4 <= count; i += 4, p += 12){
+                __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+                __m128 a, b, d;
+                S21_INTERLEAVE(_mm_shuffle_ps, vx, vy, vz, a, b, d);
+                _mm_storeu_ps(p, a);
+                _mm_storeu_ps(p + 4, b);
+                _mm_storeu_ps(p + 8, d);
+            }
+            interleave_scalar(x + i, y + i, z + i, count - i, p);
+        }
+
+        // Восемь вершин: младшие половины регистров - вершины 0-3, старшие - 4-7
+        __attribute__((target("avx")))
+        inline __m256 load_avx(const float* p){
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+        }
+
+        __attribute__((target("avx")))
+        inline void store_avx(float* p, __m256 v){
+            _mm_storeu_ps(p, _mm256_castps256_ps128(v));
+            _mm_storeu_ps(p + 12, _mm256_extractf128_ps(v, 1));
+        }
+
+        __attribute__((target("avx")))
+        void transform_avx(float* p, size_t count, const float* m){
+            __m256 c[12];
+            for(int k = 0; k < 12; ++k){
+                c[k] = _mm256_set1_ps(m[(k / 3) * 4 + k % 3]);
+            }
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8, p += 24){
+                __m256 a = load_avx(p), b = load_avx(p + 4), d = load_avx(p + 8);
+                __m256 x, y, z;
+                S21_DEINTERLEAVE(_mm256_shuffle_ps, a, b, d, x, y, z);
+                __m256 rx = S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[0], c[3], c[6], c[9], x, y, z);
+                __m256 ry = S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[1], c[4], c[7], c[10], x, y, z);
+                __m256 rz = S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[2], c[5], c[8], c[11], x, y, z);
+                S21_INTERLEAVE(_mm256_shuffle_ps, rx, ry, rz, a, b, d);
+                store_avx(p, a);
+                store_avx(p + 4, b);
+                store_avx(p + 8, d);
+            }
+            transform_sse(p, count - i, m);
+        }
+
+        __attribute__((target("avx")))
+        void reduce_avx(const float* p, size_t count, Accumulator& acc){
+            __m256 min[3], max[3];
+            for(int k = 0; k < 3; ++k){
+                min[k] = _mm256_set1_ps(acc.min[k]);
+                max[k] = _mm256_set1_ps(acc.max[k]);
+            }
+            size_t vectorized = count - count % 8;
+            for(size_t done = 0; done < vectorized; ){
+                size_t block = std::min(vectorized - done, kSumBlock);
+                __m256 sum[3] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+                for(size_t i = 0; i < block; i += 8, p += 24){
+                    __m256 a = load_avx(p), b = load_avx(p + 4), d = load_avx(p + 8);
+                    __m256 xyz[3];
+                    S21_DEINTERLEAVE(_mm256_shuffle_ps, a, b, d, xyz[0], xyz[1], xyz[2]);
+                    for(int k = 0; k < 3; ++k){
+                        min[k] = _mm256_min_ps(min[k], xyz[k]);
+                        max[k] = _mm256_max_ps(max[k], xyz[k]);
+                        sum[k] = _mm256_add_ps(sum[k], xyz[k]);
+                    }
+                }
+                for(int k = 0; k < 3; ++k){
+                    alignas(32) float lanes[8];
+                    _mm256_store_ps(lanes, sum[k]);
+                    double total = 0.0;
+                    for(float lane : lanes){
+                        total += lane;
+                    }
+                    acc.sum[k] += total;
+                }
+                done += block;
+            }
+            for(int k = 0; k < 3; ++k){
+                alignas(32) float lanes[8];
+                _mm256_store_ps(lanes, min[k]);
+                acc.min[k] = *std::min_element(lanes, lanes + 8);
+                _mm256_store_ps(lanes, max[k]);
+                acc.max[k] = *std::max_element(lanes, lanes + 8);
+            }
+            reduce_sse(p, count - vectorized, acc);
+        }
+
+        __attribute__((target("avx")))
+        void transform_soa_avx(float* x, float* y, float* z, size_t count, const float* m){
+            __m256 c[12];
+            for(int k = 0; k < 12; ++k){
+                c[k] = _mm256_set1_ps(m[(k / 3) * 4 + k % 3]);
+            }
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8){
+                __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i), vz = _mm256_loadu_ps(z + i);
+                _mm256_storeu_ps(x + i, S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[0], c[3], c[6], c[9], vx, vy, vz));
+                _mm256_storeu_ps(y + i, S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[1], c[4], c[7], c[10], vx, vy, vz));
+                _mm256_storeu_ps(z + i, S21_AFFINE(_mm256_add_ps, _mm256_mul_ps, c[2], c[5], c[8], c[11], vx, vy, vz));
+            }
+            transform_soa_sse(x + i, y + i, z + i, count - i, m);
+        }
+
+        __attribute__((target("avx")))
+        void reduce_axis_avx(const float* p, size_t count, Accumulator& acc, int k){
+            __m256 min = _mm256_set1_ps(acc.min[k]), max = _mm256_set1_ps(acc.max[k]);
+            size_t vectorized = count - count % 8;
+            for(size_t done = 0; done < vectorized; ){
+                size_t block = std::min(vectorized - done, kSumBlock);
+                __m256 sum = _mm256_setzero_ps();
+                for(size_t i = 0; i < block; i += 8, p += 8){
+                    __m256 v = _mm256_loadu_ps(p);
+                    min = _mm256_min_ps(min, v);
+                    max = _mm256_max_ps(max, v);
+                    sum = _mm256_add_ps(sum, v);
+                }
+                alignas(32) float lanes[8];
+                _mm256_store_ps(lanes, sum);
+                double total = 0.0;
+                for(float lane : lanes){
+                    total += lane;
+                }
+                acc.sum[k] += total;
+                done += block;
+            }
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, min);
+            acc.min[k] = *std::min_element(lanes, lanes + 8);
+            _mm256_store_ps(lanes, max);
+            acc.max[k] = *std::max_element(lanes, lanes + 8);
+            reduce_axis_sse(p, count - vectorized, acc, k);
+        }
+
+        __attribute__((target("avx")))
+        void deinterleave_avx(const float* p, size_t count, float* x, float* y, float* z){
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8, p += 24){
+                __m256 a = load_avx(p), b = load_avx(p + 4), d = load_avx(p + 8);
+                __m256 vx, vy, vz;
+                S21_DEINTERLEAVE(_mm256_shuffle_ps, a, b, d, vx, vy, vz);
+                _mm256_storeu_ps(x + i, vx);
+                _mm256_storeu_ps(y + i, vy);
+                _mm256_storeu_ps(z + i, vz);
+            }
+            deinterleave_sse(p, count - i, x + i, y + i, z + i);
+        }
+
+        __attribute__((target("avx")))
+        void interleave_avx(const float* x, const float* y, const float* z, size_t count, float* p){
+            size_t i = 0;
+            for(; i + 8 <= count; i += 8, p += 24){
+                __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i), vz = _mm256_loadu_ps(z + i);
+                __m256 a, b, d;
+                S21_INTERLEAVE(_mm256_shuffle_ps, vx, vy, vz, a, b, d);
+                store_avx(p, a);
+                store_avx(p + 4, b);
+                store_avx(p + 8, d);
+            }
+            interleave_sse(x + i, y + i, z + i, count - i, p);
+        }
+
+#undef S21_AFFINE
+#undef S21_INTERLEAVE
+#undef S21_DEINTERLEAVE
+#undef S21_SHUF
+#endif // S21_X86_KERNELS
+
+        Isa detect_isa(){
+#if defined(S21_X86_KERNELS) && defined(__GNUC__)
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx")){
+                return Isa::kAvx;
+            }
+            return Isa::kSse;
+#elif defined(S21_X86_KERNELS)
+            return Isa::kSse;
+#else
+            return Isa::kScalar;
+#endif
+        }
+
+        VertexKernels::Bounds make_bounds(const Accumulator& acc, size_t count){
+            VertexKernels::Bounds bounds;
+            bounds.min = glm::vec3(acc.min[0], acc.min[1], acc.min[2]);
+            bounds.max = glm::vec3(acc.max[0], acc.max[1], acc.max[2]);
+            bounds.centroid = glm::vec3(static_cast<float>(acc.sum[0] / count),
+                                        static_cast<float>(acc.sum[1] / count),
+                                        static_cast<float>(acc.sum[2] / count));
+            bounds.count = count;
+            return bounds;
+        }
+
+        std::atomic<Isa>& selected_isa(){
+            static std::atomic<Isa> isa{VertexKernels::best_isa()};
+            return isa;
+        }
+    } // namespace
+
+    void VertexKernels::transform(glm::vec3* vertices, size_t count, const glm::mat4& matrix){
+        if(count == 0){
+            return;
+        }
+        float* p = glm::value_ptr(*vertices);
+        const float* m = glm::value_ptr(matrix);
+        switch(isa()){
+#ifdef S21_X86_KERNELS
+            case Isa::kAvx:
+                transform_avx(p, count, m);
+                break;
+            case Isa::kSse:
+                transform_sse(p, count, m);
+                break;
+#endif
+            default:
+                transform_scalar(p, count, m);
+                break;
+        }
+    }
+
+    VertexKernels::Bounds VertexKernels::reduce(const glm::vec3* vertices, size_t count){
+        if(count == 0){
+            return Bounds();
+        }
+        const float* p = glm::value_ptr(*vertices);
+        Accumulator acc;
+        switch(isa()){
+#ifdef S21_X86_KERNELS
+            case Isa::kAvx:
+                reduce_avx(p, count, acc);
+                break;
+            case Isa::kSse:
+                reduce_sse(p, count, acc);
+                break;
+#endif
+            default:
+                reduce_scalar(p, count, acc);
+                break;
+        }
+        return make_bounds(acc, count);
+    }
+
+    VertexKernels::Bounds VertexKernels::merge(const Bounds& a, const Bounds& b){
+        if(a.count == 0){
+            return b;
+        }
+        if(b.count == 0){
+            return a;
+        }
+        Bounds result;
+        result.min = glm::min(a.min, b.min);
+        result.max = glm::max(a.max, b.max);
+        result.count = a.count + b.count;
+        double wa = static_cast<double>(a.count) / result.count;
+        for(int k = 0; k < 3; ++k){
+            result.centroid[k] = static_cast<float>(a.centroid[k] * wa + b.centroid[k] * (1.0 - wa));
+        }
+        return result;
+    }
+
+    void VertexKernels::transform(float* x, float* y, float* z, size_t count, const glm::mat4& matrix){
+        const float* m = glm::value_ptr(matrix);
+        switch(isa()){
+#ifdef S21_X86_KERNELS
+            case Isa::kAvx:
+                transform_soa_avx(x, y, z, count, m);
+                break;
+            case Isa::kSse:
+                transform_soa_sse(x, y, z, count, m);
+                break;
+#endif
+            default:
+                transform_soa_scalar(x, y, z, count, m);
+                break;
+        }
+    }
+
+    VertexKernels::Bounds VertexKernels::reduce(const float* x, const float* y, const float* z, size_t count){
+        if(count == 0){
+            return Bounds();
+        }
+        // Каждая ось лежит подряд, поэтому свертка идет по осям: массивы
+        // по-прежнему читаются ровно один раз
+        Accumulator acc;
+        const float* axes[3] = {x, y, z};
+        for(int k = 0; k < 3; ++k){
+            switch(isa()){
+#ifdef S21_X86_KERNELS
+                case Isa::kAvx:
+                    reduce_axis_avx(axes[k], count, acc, k);
+                    break;
+                case Isa::kSse:
+                    reduce_axis_sse(axes[k], count, acc, k);
+                    break;
+#endif
+                default:
+                    reduce_axis_scalar(axes[k], count, acc, k);
+                    break;
+            }
+        }
+        return make_bounds(acc, count);
+    }
+
+    void VertexKernels::deinterleave(const glm::vec3* vertices, size_t count, float* x, float* y, float* z){
+        if(count == 0){
+            return;
+        }
+        const float* p = glm::value_ptr(*vertices);
+        switch(isa()){
+#ifdef S21_X86_KERNELS
+            case Isa::kAvx:
+                deinterleave_avx(p, count, x, y, z);
+                break;
+            case Isa::kSse:
+                deinterleave_sse(p, count, x, y, z);
+                break;
+#endif
+            default:
+                deinterleave_scalar(p, count, x, y, z);
+                break;
+        }
+    }
+
+    void VertexKernels::interleave(const float* x, const float* y, const float* z, size_t count, glm::vec3* vertices){
+        if(count == 0){
+            return;
+        }
+        float* p = glm::value_ptr(*vertices);
+        switch(isa()){
+#ifdef S21_X86_KERNELS
+            case Isa::kAvx:
+                interleave_avx(x, y, z, count, p);
+                break;
+            case Isa::kSse:
+                interleave_sse(x, y, z, count, p);
+                break;
+#endif
+            default:
+                interleave_scalar(x, y, z, count, p);
+                break;
+        }
+    }
+
+    VertexKernels::Isa VertexKernels::best_isa(){
+        static const Isa best = detect_isa();
+        return best;
+    }
+
+    VertexKernels::Isa VertexKernels::isa(){
+        return selected_isa().load(std::memory_order_relaxed);
+    }
+
+    void VertexKernels::set_isa(Isa isa){
+        selected_isa().store(std::min(isa, best_isa()), std::memory_order_relaxed);
+    }
+
+    const char* VertexKernels::isa_name(Isa isa){
+        switch(isa){
+            case Isa::kAvx:
+                return "avx";
+            case Isa::kSse:
+                return "sse";
+            default:
+                return "scalar";
+        }
+    }
+} // namespace s21
@@ -0,0 +1,150 @@
+#ifndef SRC_MODEL_VERTEX_KERNELS_H
+#define SRC_MODEL_VERTEX_KERNELS_H
+#include <cstddef>
+#include <glm/ext.hpp>
+
+namespace s21 {
+    /**
+     * @brief Однопроходные векторные ядра для массивов вершин.
+     *
+     * Каждое ядро читает массив ровно один раз. Реализация (SSE, AVX или
+     * скалярная) выбирается при первом вызове по возможностям процессора;
+     * на других архитектурах всегда используется скалярная версия.
+     * Аффинное преобразование во всех реализациях считается в одном и том же
+     * порядке операций, поэтому результат не зависит от выбранного набора
+     * инструкций.
+     */
+    class VertexKernels {
+        public:
+            /**
+             * @brief Набор инструкций, которым выполняются ядра.
+             */
+            enum class Isa {
+                kScalar, // Обычный C++
+                kSse,    // SSE, по 4 вершины за итерацию
+                kAvx     // AVX, по 8 вершин за итерацию
+            };
+
+            /**
+             * @brief Результат свертки массива вершин.
+             */
+            struct Bounds {
+                glm::vec3 min = glm::vec3(0.0f); // Минимум по каждой оси
+                glm::vec3 max = glm::vec3(0.0f); // Максимум по каждой оси
+                glm::vec3 centroid = glm::vec3(0.0f); // Среднее арифметическое вершин
+                size_t count = 0; // Количество вершин
+            };
+
+            /**
+             * @brief Применяет аффинное преобразование ко всем вершинам за один проход.
+             *
+             * Результат совпадает с glm::vec3(matrix * glm::vec4(vertex, 1.0f)).
+             *
+             * @param vertices Указатель на вершины.
+             * @param count Количество вершин.
+             * @param matrix Матрица преобразования (последняя строка не используется).
+             */
+            static void transform(glm::vec3* vertices, size_t count, const glm::mat4& matrix);
+
+            /**
+             * @brief Находит ограничивающий параллелепипед и центр вершин за один проход.
+             *
+             * Сумма координат накапливается блоками в double, поэтому центр
+             * не теряет точность на больших моделях.
+             *
+             * @param vertices Указатель на вершины.
+             * @param count Количество вершин.
+             * @return Минимум, максимум и центр; для пустого массива - нули.
+             */
+            static Bounds reduce(const glm::vec3* vertices, size_t count);
+
+            /**
+             * @brief Объединяет свертки двух наборов вершин.
+             *
+             * Центр объединения - среднее центров, взвешенное по числу вершин.
+             *
+             * @param a Свертка первого набора.
+             * @param b Свертка второго набора.
+             * @return Свертка объединения наборов.
+             */
+            static Bounds merge(const Bounds& a, const Bounds& b);
+
+            /**
+             * @brief Применяет аффинное преобразование к вершинам, хранящимся по осям.
+             *
+             * Результат побитово совпадает с версией для массива glm::vec3.
+             *
+             * @param x Координаты x.
+             * @param y Координаты y.
+             * @param z Координаты z.
+             * @param count Количество вершин.
+             * @param matrix Матрица преобразования (последняя строка не используется).
+             */
+            static void transform(float* x, float* y, float* z, size_t count, const glm::mat4& matrix);
+
+            /**
+             * @brief Находит ограничивающий параллелепипед и центр вершин, хранящихся по осям.
+             *
+             * @param x Координаты x.
+             * @param y Координаты y.
+             * @param z Координаты z.
+             * @param count Количество вершин.
+             * @return Минимум, максимум и центр; для пустого массива - нули.
+             */
+            static Bounds reduce(const float* x, const float* y, const float* z, size_t count);
+
+            /**
+             * @brief Раскладывает массив glm::vec3 на три массива координат.
+             *
+             * @param vertices Исходные вершины.
+             * @param count Количество вершин.
+             * @param x Куда записать координаты x.
+             * @param y Куда записать координаты y.
+             * @param z Куда записать координаты z.
+             */
+            static void deinterleave(const glm::vec3* vertices, size_t count, float* x, float* y, float* z);
+
+            /**
+             * @brief Собирает три массива координат в массив glm::vec3.
+             *
+             * @param x Координаты x.
+             * @param y Координаты y.
+             * @param z Координаты z.
+             * @param count Количество вершин.
+             * @param vertices Куда записать вершины.
+             */
+            static void interleave(const float* x, const float* y, const float* z, size_t count, glm::vec3* vertices);
+
+            /**
+             * @brief Возвращает лучший набор инструкций, доступный на этом процессоре.
+             *
+             * @return Набор инструкций.
+             */
+            static Isa best_isa();
+
+            /**
+             * @brief Возвращает набор инструкций, используемый сейчас.
+             *
+             * @return Набор инструкций.
+             */
+            static Isa isa();
+
+            /**
+             * @brief Принудительно выбирает набор инструкций (для тестов и замеров).
+             *
+             * Недоступный на процессоре набор заменяется лучшим доступным.
+             *
+             * @param isa Желаемый набор инструкций.
+             */
+            static void set_isa(Isa isa);
+
+            /**
+             * @brief Возвращает название набора инструкций.
+             *
+             * @param isa Набор инструкций.
+             * @return Строка "scalar", "sse" или "avx".
+             */
+            static const char* isa_name(Isa isa);
+    };
+} // namespace s21
+#endif
@@ -1,6 +1,57 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+
+#include "../controller/controller.h"
+#include "../model/edge_list.h"
+#include "../model/frame_stats.h"
 #include "../model/model.h"
+#include "../model/mesh_format.h"
+#include "../model/mesh_reorder.h"
+#include "../model/mesh_weld.h"
+#include "../model/obj_parser.h"
+#include "../model/ply_parser.h"
+#include "../model/quantized_vertices.h"
+#include "../model/stl_parser.h"
+#include "../model/thread_pool.h"
+#include "../model/vertex_kernels.h"
 #include "gtest/gtest.h"
 
+static std::atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size) {
+  ++allocation_count;
+  if (void* ptr = std::malloc(size != 0 ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+// Освобождение вне строки: иначе GCC видит free() для памяти из operator new
+// и предупреждает (-Wmismatched-new-delete)
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+[[gnu::noinline]] void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+[[gnu::noinline]] void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
 TEST(Model, read_file) {
   s21::Model md;
   int code = 0;
@@ -63,6 +114,1512 @@ TEST(Model, scale) {
   md.clear_data();
 }
 
+TEST(ObjParser, floats_match_stringstream) {
+  const char* samples[] = {"0",           "-0.5",        "1.234567",
+                           "-12.3456789", "3.14159265358979", "1e-3",
+                           "+2.5E+2",     "0.000001234", "123456789012",
+                           "7.",          ".25",         "-1.17549435e-38"};
+  for (const char* sample : samples) {
+    float expected = 0.0f;
+    std::stringstream ss(sample);
+    ss >> expected;
+    float value = 0.0f;
+    const char* end = sample + strlen(sample);
+    EXPECT_EQ(end, s21::ObjParser::parse_float(sample, end, value)) << sample;
+    EXPECT_EQ(expected, value) << sample;
+  }
+}
+
+TEST(ObjParser, parse_buffer) {
+  std::string text =
+      "# comment\nv 1 2 3\r\nv -1.5 0.25 4e1\nvn 0 0 1\n\nf 1 2 3\nf 3/1/1 2/2/2 "
+      "1/3/3\n";
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  s21::ObjParser().parse(text.data(), text.data() + text.size(), vertices,
+                         faces);
+  ASSERT_EQ(2u, vertices.size());
+  EXPECT_EQ(glm::vec3(1, 2, 3), vertices[0]);
+  EXPECT_EQ(glm::vec3(-1.5f, 0.25f, 40.0f), vertices[1]);
+  ASSERT_EQ(2u, faces.size());
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}),
+            std::vector<uint32_t>(faces[0].begin(), faces[0].end()));
+  EXPECT_EQ(std::vector<uint32_t>({2, 1, 0}),
+            std::vector<uint32_t>(faces[1].begin(), faces[1].end()));
+}
+
+TEST(ObjParser, face_syntax_and_negative_indices) {
+  std::string text =
+      "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+      "f 1 2 3\n"
+      "f 1/1 2/2 3/3\n"
+      "f 1//1 2//2 3//3\n"
+      "f 1/1/1 2/2/2 3/3/3\n"
+      "f -4 -3 -2\n"
+      "f -4/1/1\t-2//2   -1/3\r\n"
+      "v 5 5 5\n"
+      "f -1 -5 +2 0 9\n";
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  s21::ObjParser().parse(text.data(), text.data() + text.size(), vertices,
+                         faces);
+  ASSERT_EQ(5u, vertices.size());
+  ASSERT_EQ(7u, faces.size());
+  for (size_t f = 0; f < 5; ++f) {
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}),
+              std::vector<uint32_t>(faces[f].begin(), faces[f].end()))
+        << f;
+  }
+  EXPECT_EQ(std::vector<uint32_t>({0, 2, 3}),
+            std::vector<uint32_t>(faces[5].begin(), faces[5].end()));
+  // Отрицательные индексы считаются от последней вершины перед гранью;
+  // несуществующие (0, за концом) не попадают в диапазон вершин
+  ASSERT_EQ(5u, faces[6].size());
+  EXPECT_EQ(4u, faces[6][0]);
+  EXPECT_EQ(0u, faces[6][1]);
+  EXPECT_EQ(1u, faces[6][2]);
+  EXPECT_LE(vertices.size(), faces[6][3]);
+  EXPECT_LE(vertices.size(), faces[6][4]);
+}
+
+TEST(ObjParser, parallel_matches_serial) {
+  std::string text;
+  for (int i = 0; i < 300000; ++i) {
+    text += "v " + std::to_string(i * 0.001f) + " -" + std::to_string(i) +
+            ".25 1e-2\n";
+    // Каждая вторая грань - с отрицательными индексами, которые во
+    // фрагментах разрешаются от начала фрагмента
+    if (i > 2 && i % 2 == 0) {
+      text += "f " + std::to_string(i - 2) + " " + std::to_string(i - 1) +
+              " " + std::to_string(i) + "\n";
+    } else if (i > 2) {
+      text += "f -4/1 -3//1 -2/1/1\n";
+    }
+  }
+  std::vector<glm::vec3> serial_vertices, parallel_vertices;
+  s21::FaceList serial_faces, parallel_faces;
+  s21::ObjParser serial;
+  serial.set_threads(1);
+  serial.parse(text.data(), text.data() + text.size(), serial_vertices,
+               serial_faces);
+  s21::ObjParser parallel;
+  parallel.set_threads(4);
+  parallel.parse(text.data(), text.data() + text.size(), parallel_vertices,
+                 parallel_faces);
+  EXPECT_EQ(300000u, serial_vertices.size());
+  EXPECT_TRUE(serial_vertices == parallel_vertices);
+  EXPECT_TRUE(serial_faces == parallel_faces);
+  // Грань после вершины i (с нуля) ссылается на вершины i-3, i-2, i-1
+  for (size_t f = 0; f < serial_faces.size(); ++f) {
+    ASSERT_EQ(f + 2, parallel_faces[f][2]);
+  }
+}
+
+// Куб из 12 треугольников: в STL каждая из 8 вершин повторяется
+static const float kCubeTriangles[12][3][3] = {
+    {{0, 0, 0}, {1, 1, 0}, {1, 0, 0}}, {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}},
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}}, {{0, 0, 1}, {1, 1, 1}, {0, 1, 1}},
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}}, {{0, 0, 0}, {1, 0, 1}, {0, 0, 1}},
+    {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}}, {{0, 1, 0}, {1, 1, 1}, {1, 1, 0}},
+    {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}}, {{0, 0, 0}, {0, 1, 1}, {0, 1, 0}},
+    {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}}, {{1, 0, 0}, {1, 1, 1}, {-0.0f, 0, 0}}};
+
+static std::string binaryStl() {
+  std::string data(80, ' ');
+  data.replace(0, 5, "solid");
+  uint32_t count = 12;
+  data.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const auto& triangle : kCubeTriangles) {
+    float record[12] = {};
+    std::memcpy(record + 3, triangle, sizeof(triangle));
+    data.append(reinterpret_cast<const char*>(record), sizeof(record));
+    data.append(2, '\0');
+  }
+  return data;
+}
+
+static void expectCube(const std::vector<glm::vec3>& vertices,
+                       const s21::FaceList& faces) {
+  ASSERT_EQ(8u, vertices.size());
+  ASSERT_EQ(12u, faces.size());
+  for (size_t f = 0; f < faces.size(); ++f) {
+    ASSERT_EQ(3u, faces[f].size());
+    for (size_t k = 0; k < 3; ++k) {
+      ASSERT_LT(faces[f][k], vertices.size());
+      EXPECT_EQ(glm::vec3(kCubeTriangles[f][k][0], kCubeTriangles[f][k][1],
+                          kCubeTriangles[f][k][2]),
+                vertices[faces[f][k]]);
+    }
+  }
+}
+
+TEST(StlParser, binary_and_ascii_weld_vertices) {
+  std::string binary = binaryStl();
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  ASSERT_TRUE(s21::StlParser().parse_binary(
+      binary.data(), binary.data() + binary.size(), vertices, faces));
+  expectCube(vertices, faces);
+  // Объявлено больше треугольников, чем есть в файле
+  std::vector<glm::vec3> truncated_vertices;
+  s21::FaceList truncated_faces;
+  EXPECT_FALSE(s21::StlParser().parse_binary(
+      binary.data(), binary.data() + binary.size() - 1, truncated_vertices,
+      truncated_faces));
+
+  std::string ascii = "solid cube\n";
+  for (const auto& triangle : kCubeTriangles) {
+    ascii += "  facet normal 0 0 0\r\n    outer loop\n";
+    for (const auto& corner : triangle) {
+      ascii += "      vertex " + std::to_string(corner[0]) + " " +
+               std::to_string(corner[1]) + " " + std::to_string(corner[2]) +
+               "\n";
+    }
+    ascii += "    endloop\n  endfacet\n";
+  }
+  ascii += "endsolid cube\n";
+  std::vector<glm::vec3> ascii_vertices;
+  s21::FaceList ascii_faces;
+  ASSERT_TRUE(s21::StlParser().parse_ascii(
+      ascii.data(), ascii.data() + ascii.size(), ascii_vertices, ascii_faces));
+  expectCube(ascii_vertices, ascii_faces);
+  EXPECT_EQ(faces, ascii_faces);
+
+  // Вершина без третьей координаты - ошибка, а не ноль
+  const std::string broken =
+      "solid bad\nfacet normal 0 0 0\nouter loop\nvertex 1 2 3\n"
+      "vertex 4 5\nvertex 7 8 9\nendloop\nendfacet\nendsolid bad\n";
+  ascii_vertices.clear();
+  ascii_faces.clear();
+  EXPECT_FALSE(s21::StlParser().parse_ascii(broken.data(),
+                                            broken.data() + broken.size(),
+                                            ascii_vertices, ascii_faces));
+}
+
+TEST(PlyParser, reads_vertices_and_faces) {
+  auto append = [](std::string& data, auto value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  // Вершины ровно x, y, z float - копируются целиком
+  std::string packed =
+      "ply\nformat binary_little_endian 1.0\ncomment test\n"
+      "element vertex 4\nproperty float x\nproperty float y\n"
+      "property float z\nelement face 2\n"
+      "property list uchar int vertex_indices\nend_header\n";
+  // Лишние свойства, double и short индексы - разбор по свойствам
+  std::string mixed =
+      "ply\r\nformat binary_little_endian 1.0\r\n"
+      "element vertex 4\r\nproperty double x\r\nproperty uchar red\r\n"
+      "property double y\r\nproperty double z\r\n"
+      "element face 2\r\nproperty uchar flags\r\n"
+      "property list uchar ushort vertex_index\r\n"
+      "element material 1\r\nproperty float shininess\r\nend_header\r\n";
+  // Индексы float того же размера, что и int, - тоже через преобразование
+  std::string floats =
+      "ply\nformat binary_little_endian 1.0\n"
+      "element vertex 4\nproperty float x\nproperty float y\n"
+      "property float z\nelement face 2\n"
+      "property list uchar float vertex_indices\nend_header\n";
+  const float corners[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 2}};
+  for (const auto& corner : corners) {
+    for (float coord : corner) {
+      append(packed, coord);
+      append(floats, coord);
+    }
+    append(mixed, double(corner[0]));
+    append(mixed, uint8_t(255));
+    append(mixed, double(corner[1]));
+    append(mixed, double(corner[2]));
+  }
+  append(packed, uint8_t(3));
+  for (int32_t index : {0, 1, 2}) append(packed, index);
+  append(packed, uint8_t(4));
+  for (int32_t index : {0, 1, 2, 3}) append(packed, index);
+  append(mixed, uint8_t(0));
+  append(mixed, uint8_t(3));
+  for (uint16_t index : {0, 1, 2}) append(mixed, index);
+  append(mixed, uint8_t(0));
+  append(mixed, uint8_t(4));
+  for (uint16_t index : {0, 1, 2, 3}) append(mixed, index);
+  append(mixed, 0.5f);
+  append(floats, uint8_t(3));
+  for (float index : {0, 1, 2}) append(floats, index);
+  append(floats, uint8_t(4));
+  for (float index : {0, 1, 2, 3}) append(floats, index);
+
+  for (const std::string& data : {packed, mixed, floats}) {
+    std::vector<glm::vec3> vertices;
+    s21::FaceList faces;
+    ASSERT_TRUE(s21::PlyParser().parse(data.data(), data.data() + data.size(),
+                                       vertices, faces));
+    ASSERT_EQ(4u, vertices.size());
+    EXPECT_EQ(glm::vec3(0, 1, 2), vertices[3]);
+    ASSERT_EQ(2u, faces.size());
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}),
+              std::vector<uint32_t>(faces[0].begin(), faces[0].end()));
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3}),
+              std::vector<uint32_t>(faces[1].begin(), faces[1].end()));
+    // Обрезанный файл не разбирается
+    vertices.clear();
+    faces.clear();
+    EXPECT_FALSE(s21::PlyParser().parse(
+        data.data(), data.data() + data.size() - 5, vertices, faces));
+  }
+  // Число граней из заголовка больше, чем поместится в файл
+  std::string huge =
+      "ply\nformat binary_little_endian 1.0\nelement face 4000000000000\n"
+      "property list uchar int vertex_indices\nend_header\n";
+  huge.append(64, '\3');
+  {
+    std::vector<glm::vec3> vertices;
+    s21::FaceList faces;
+    EXPECT_FALSE(s21::PlyParser().parse(
+        huge.data(), huge.data() + huge.size(), vertices, faces));
+  }
+  std::string ascii = "ply\nformat ascii 1.0\nend_header\n";
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  EXPECT_FALSE(s21::PlyParser().parse(
+      ascii.data(), ascii.data() + ascii.size(), vertices, faces));
+}
+
+TEST(MeshFormat, detected_by_magic_bytes) {
+  std::string binary = binaryStl();
+  std::string ascii = "  solid cube\nendsolid cube\n";
+  std::string ply = "ply\nformat binary_little_endian 1.0\nend_header\n";
+  std::string obj = "v 0 0 0\n";
+  EXPECT_EQ(s21::MeshFormat::kStlBinary,
+            s21::detect_mesh_format(binary.data(), binary.size()));
+  EXPECT_EQ(s21::MeshFormat::kStlAscii,
+            s21::detect_mesh_format(ascii.data(), ascii.size()));
+  EXPECT_EQ(s21::MeshFormat::kPly,
+            s21::detect_mesh_format(ply.data(), ply.size()));
+  EXPECT_EQ(s21::MeshFormat::kObj,
+            s21::detect_mesh_format(obj.data(), obj.size()));
+  EXPECT_EQ(s21::MeshFormat::kObj, s21::detect_mesh_format(obj.data(), 0));
+
+  // Двоичный STL с заголовком "solid" и байтами после треугольников
+  std::string trailing = binary + std::string(16, 'x');
+  ASSERT_EQ(0, trailing.compare(0, 5, "solid"));
+  EXPECT_EQ(s21::MeshFormat::kStlBinary,
+            s21::detect_mesh_format(trailing.data(), trailing.size()));
+  // Текстовый STL длиннее заголовка двоичного остается текстовым
+  std::string facets = "solid cube\n";
+  for (int i = 0; i < 4; ++i) {
+    facets += " facet normal 0 0 1\n  outer loop\n   vertex 0 0 0\n"
+              "   vertex 1 0 0\n   vertex 0 1 0\n  endloop\n endfacet\n";
+  }
+  facets += "endsolid cube\n";
+  EXPECT_EQ(s21::MeshFormat::kStlAscii,
+            s21::detect_mesh_format(facets.data(), facets.size()));
+
+  // Расширение файла не важно: формат берется из содержимого
+  const std::string source = "mesh_format_test.obj";
+  for (const std::string* data : {&binary, &trailing}) {
+    std::ofstream(source, std::ios::binary) << *data;
+    s21::Controller controller;
+    controller.setCacheDirectory("");
+    controller.loadModel(source);
+    EXPECT_EQ(8u, controller.getVerticesSize());
+    EXPECT_EQ(12u, controller.getFacesSize());
+  }
+  std::remove(source.c_str());
+}
+
+TEST(FaceList, csr_layout) {
+  s21::FaceList faces;
+  const uint32_t quad[] = {1, 2, 3, 4};
+  faces.push_face(quad, 4);
+  faces.push_index(4);
+  faces.push_index(3);
+  faces.push_index(5);
+  faces.close_face();
+  s21::FaceList more;
+  more.push_face(quad + 1, 3);
+  faces.append(more);
+  ASSERT_EQ(3u, faces.size());
+  EXPECT_EQ(std::vector<uint32_t>({0, 4, 7, 10}), faces.offset_data());
+  EXPECT_EQ(3u, faces[1].size());
+  EXPECT_EQ(5u, faces[1][2]);
+  size_t total = 0;
+  for (const auto face : faces) total += face.size();
+  EXPECT_EQ(10u, total);
+}
+
+TEST(MeshView, generations) {
+  s21::Model md;
+  md.read_file("object_files/cube.obj");
+  s21::MeshView view = md.view();
+  EXPECT_EQ(8u, view.vertices.size());
+  EXPECT_EQ(12u, view.faces->size());
+  s21::MeshViewTracker tracker;
+  s21::MeshViewTracker::Changes changes = tracker.sync(view);
+  EXPECT_TRUE(changes.vertices && changes.topology);
+  changes = tracker.sync(md.view());
+  EXPECT_FALSE(changes.vertices || changes.topology);
+  md.translate(glm::vec3(0.0f, 1.0f, 0.0f));
+  changes = tracker.sync(md.view());
+  EXPECT_TRUE(changes.vertices);
+  EXPECT_FALSE(changes.topology);
+  md.read_file("object_files/cube.obj");
+  EXPECT_TRUE(tracker.sync(md.view()).topology);
+}
+
+TEST(Model, matrix_mode_matches_vertices_mode) {
+  s21::Model cpu, gpu;
+  cpu.read_file("object_files/cube.obj");
+  gpu.read_file("object_files/cube.obj");
+  gpu.set_transform_mode(s21::TransformMode::kMatrix);
+  std::vector<glm::vec3> loaded(gpu.vertices_begin(), gpu.vertices_end());
+  uint64_t generation = gpu.get_geometry_generation();
+  for (s21::Model* md : {&cpu, &gpu}) {
+    md->rotate(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    md->scale(1.5f);
+    md->translate(glm::vec3(0.5f, -0.25f, 1.0f));
+    md->setPossition(glm::vec3(1.0f, 2.0f, 3.0f));
+    md->rotate(45.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+  }
+  EXPECT_EQ(generation, gpu.get_geometry_generation());
+  EXPECT_TRUE(std::equal(loaded.begin(), loaded.end(), gpu.vertices_begin()));
+  EXPECT_EQ(glm::mat4(1.0f), cpu.get_model_matrix());
+
+  gpu.bake();
+  EXPECT_NE(generation, gpu.get_geometry_generation());
+  EXPECT_EQ(glm::mat4(1.0f), gpu.get_model_matrix());
+  for (size_t i = 0; i < cpu.vertices_size(); i++) {
+    glm::vec3 a = cpu.vertices_begin()[i], b = gpu.vertices_begin()[i];
+    EXPECT_NEAR(a.x, b.x, 1e-5f);
+    EXPECT_NEAR(a.y, b.y, 1e-5f);
+    EXPECT_NEAR(a.z, b.z, 1e-5f);
+  }
+}
+
+TEST(VertexKernels, all_isas_match_glm) {
+  // Нечетное количество, чтобы задеть и векторную часть, и хвост
+  std::vector<glm::vec3> source(1027);
+  for (size_t i = 0; i < source.size(); i++) {
+    float t = static_cast<float>(i);
+    source[i] = glm::vec3(std::sin(t) * 3.0f, std::cos(t * 0.7f), t * 0.01f - 5.0f);
+  }
+  glm::mat4 matrix =
+      glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, -2.0f, 1.0f)) *
+      glm::rotate(glm::mat4(1.0f), 0.7f, glm::normalize(glm::vec3(1, 2, 3))) *
+      glm::scale(glm::mat4(1.0f), glm::vec3(1.5f));
+  std::vector<glm::vec3> expected = source;
+  for (auto& vertex : expected) vertex = matrix * glm::vec4(vertex, 1.0f);
+
+  using Isa = s21::VertexKernels::Isa;
+  for (Isa isa : {Isa::kScalar, Isa::kSse, Isa::kAvx}) {
+    s21::VertexKernels::set_isa(isa);
+    std::vector<glm::vec3> vertices = source;
+    s21::VertexKernels::transform(vertices.data(), vertices.size(), matrix);
+    EXPECT_EQ(expected, vertices) << s21::VertexKernels::isa_name(isa);
+
+    s21::VertexKernels::Bounds bounds =
+        s21::VertexKernels::reduce(source.data(), source.size());
+    glm::vec3 min(1e9f), max(-1e9f), sum(0.0f);
+    for (const auto& vertex : source) {
+      min = glm::min(min, vertex);
+      max = glm::max(max, vertex);
+      sum += vertex;
+    }
+    EXPECT_EQ(min, bounds.min);
+    EXPECT_EQ(max, bounds.max);
+    EXPECT_NEAR(sum.x / source.size(), bounds.centroid.x, 1e-5f);
+    EXPECT_NEAR(sum.y / source.size(), bounds.centroid.y, 1e-5f);
+    EXPECT_NEAR(sum.z / source.size(), bounds.centroid.z, 1e-5f);
+  }
+  s21::VertexKernels::set_isa(s21::VertexKernels::best_isa());
+}
+
+TEST(ThreadPool, parallel_for_covers_range) {
+  s21::ThreadPool pool(4);
+  for (size_t count : {0, 1, 9, 10, 12, 1001}) {
+    std::vector<int> hits(count, 0);
+    pool.parallel_for(count, 4, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) hits[i]++;
+    });
+    EXPECT_EQ(count, static_cast<size_t>(std::count(hits.begin(), hits.end(), 1)));
+  }
+}
+
+TEST(ThreadPool, parallel_transform_is_bit_identical) {
+  std::vector<glm::vec3> serial(300001);
+  for (size_t i = 0; i < serial.size(); i++) {
+    float t = static_cast<float>(i) * 0.001f;
+    serial[i] = glm::vec3(std::sin(t), t, std::cos(t * 3.0f));
+  }
+  std::vector<glm::vec3> parallel = serial;
+  glm::mat4 matrix =
+      glm::rotate(glm::mat4(1.0f), 0.3f, glm::vec3(0.0f, 1.0f, 0.0f)) *
+      glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, 0.2f, 0.3f));
+  s21::VertexKernels::transform(serial.data(), serial.size(), matrix);
+  s21::ThreadPool pool(4);
+  pool.parallel_for(parallel.size(), 4, [&](size_t begin, size_t end) {
+    s21::VertexKernels::transform(parallel.data() + begin, end - begin, matrix);
+  });
+  EXPECT_EQ(serial, parallel);
+}
+
+TEST(Model, soa_layout_matches_aos) {
+  s21::Model aos, soa;
+  soa.set_vertex_layout(s21::VertexLayout::kSoA);
+  aos.read_file("object_files/cube.obj");
+  soa.read_file("object_files/cube.obj");
+  for (s21::Model* md : {&aos, &soa}) {
+    md->rotate(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+    md->scale(1.5f);
+    md->setPossition(glm::vec3(1.0f, 2.0f, 3.0f));
+  }
+  std::vector<glm::vec3> expected(aos.vertices_begin(), aos.vertices_end());
+  s21::MeshView view = soa.view();
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                         view.vertices.begin(), view.vertices.end()));
+  const s21::SoaVertices& axes = aos.soa_vertices();
+  ASSERT_EQ(expected.size(), axes.size());
+  for (size_t i = 0; i < expected.size(); i++) EXPECT_EQ(expected[i], axes[i]);
+
+  soa.set_vertex_layout(s21::VertexLayout::kAoS);
+  soa.translate(glm::vec3(1.0f));
+  aos.translate(glm::vec3(1.0f));
+  EXPECT_TRUE(std::equal(aos.vertices_begin(), aos.vertices_end(),
+                         soa.vertices_begin(), soa.vertices_end()));
+}
+
+TEST(Model, recycle_reuses_buffers_across_loads) {
+  s21::Model reference, retired;
+  reference.read_file("object_files/cube.obj");
+  retired.read_file("object_files/cube.obj");
+  retired.get_edges();
+  const glm::vec3* vertex_data = retired.view().vertices.data();
+  const uint32_t* index_data = retired.get_faces().index_data().data();
+  const uint32_t* edge_data = retired.get_edges().data();
+
+  s21::Model md;
+  md.recycle(retired);
+  EXPECT_EQ(0u, retired.vertices_size());
+  EXPECT_EQ(0u, retired.faces_size());
+  EXPECT_EQ(0u, md.vertices_size());
+  ASSERT_TRUE(md.read_file("object_files/cube.obj"));
+  EXPECT_EQ(vertex_data, md.view().vertices.data());
+  EXPECT_EQ(index_data, md.get_faces().index_data().data());
+  EXPECT_EQ(edge_data, md.get_edges().data());
+  EXPECT_TRUE(std::equal(reference.vertices_begin(), reference.vertices_end(),
+                         md.vertices_begin(), md.vertices_end()));
+  EXPECT_EQ(reference.get_faces(), md.get_faces());
+  EXPECT_EQ(reference.get_edges(), md.get_edges());
+
+  // Буферы фрагментов параллельного разбора переживают разбор
+  std::string text;
+  for (int i = 0; i < 300000; ++i) {
+    text += "v " + std::to_string(i) + ".25 0.125 -" + std::to_string(i) +
+            ".5\n";
+    if (i > 1) {
+      text += "f " + std::to_string(i - 1) + " " + std::to_string(i) + " " +
+              std::to_string(i + 1) + "\n";
+    }
+  }
+  std::vector<glm::vec3> expected_vertices;
+  s21::FaceList expected_faces;
+  s21::ObjParser parser;
+  parser.set_threads(2);
+  ASSERT_TRUE(parser.parse(text.data(), text.data() + text.size(),
+                           expected_vertices, expected_faces));
+  s21::ObjParser::Scratch scratch;
+  parser.set_scratch(&scratch);
+  const glm::vec3* chunk_data = nullptr;
+  for (int pass = 0; pass < 2; ++pass) {
+    std::vector<glm::vec3> vertices;
+    s21::FaceList faces;
+    ASSERT_TRUE(parser.parse(text.data(), text.data() + text.size(),
+                             vertices, faces));
+    EXPECT_EQ(expected_vertices, vertices);
+    EXPECT_EQ(expected_faces, faces);
+    ASSERT_EQ(2u, scratch.chunks.size());
+    if (pass == 0) chunk_data = scratch.chunks[1].vertices.data();
+    EXPECT_EQ(chunk_data, scratch.chunks[1].vertices.data());
+  }
+
+  // Контроллер отдает память снятой модели следующей загрузке
+  s21::Controller controller;
+  controller.setCacheDirectory("");
+  controller.loadModel("object_files/cube.obj");
+  const glm::vec3* first = controller.getView().vertices.data();
+  controller.loadModel("object_files/cube.obj");
+  controller.loadModel("object_files/cube.obj");
+  EXPECT_EQ(first, controller.getView().vertices.data());
+  controller.releaseBuffers();
+  controller.loadModel("object_files/cube.obj");
+  EXPECT_EQ(reference.vertices_size(), controller.getVerticesSize());
+  EXPECT_EQ(reference.get_faces(), controller.getFaceList());
+}
+
+TEST(Model, normalization_fits_unit_cube) {
+  s21::Model md;
+  md.read_file("object_files/cube.obj");
+  md.scale(7.0f);
+  md.translate(glm::vec3(3.0f, -4.0f, 5.0f));
+  md.normalization();
+  glm::vec3 min(1e9f), max(-1e9f), sum(0.0f);
+  for (auto it = md.vertices_begin(); it != md.vertices_end(); ++it) {
+    min = glm::min(min, *it);
+    max = glm::max(max, *it);
+    sum += *it;
+  }
+  EXPECT_NEAR(2.0f, std::max({max.x - min.x, max.y - min.y, max.z - min.z}),
+              1e-5f);
+  EXPECT_NEAR(0.0f, glm::length(sum), 1e-5f);
+}
+
+TEST(MeshCache, round_trip_and_invalidation) {
+  const std::string source = "mesh_cache_test.obj";
+  const std::string directory = "mesh_cache_test";
+  {
+    std::ifstream in("object_files/cube.obj", std::ios::binary);
+    std::ofstream out(source, std::ios::binary);
+    out << in.rdbuf();
+  }
+  s21::MeshCache cache(directory);
+  s21::Model parsed, cached;
+  parsed.read_file(source.c_str());
+  EXPECT_FALSE(cache.load(source, cached));
+  ASSERT_TRUE(cache.store(source, parsed));
+  ASSERT_TRUE(cache.load(source, cached));
+  EXPECT_TRUE(std::equal(parsed.vertices_begin(), parsed.vertices_end(),
+                         cached.vertices_begin(), cached.vertices_end()));
+  EXPECT_EQ(parsed.get_faces(), cached.get_faces());
+
+  s21::Controller controller;
+  controller.setCacheDirectory(directory);
+  controller.loadModel(source);
+  EXPECT_EQ(parsed.get_faces(), controller.getFaceList());
+
+  // Испорченные смещения граней или счетчики делают кэш недействительным
+  std::string cache_file = cache.cache_path(source);
+  std::string stored;
+  {
+    std::ifstream in(cache_file, std::ios::binary);
+    stored.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  auto rewrite = [&](const std::string& bytes) {
+    std::ofstream(cache_file, std::ios::binary | std::ios::trunc) << bytes;
+  };
+  s21::MeshCache::Header header;
+  std::memcpy(&header, stored.data(), sizeof(header));
+  size_t offsets_at = stored.size() - (header.face_count + 1 + header.index_count) *
+                                   sizeof(s21::FaceList::index_type);
+  std::string broken = stored;
+  uint32_t backwards = 1;
+  std::memcpy(&broken[offsets_at + 2 * sizeof(uint32_t)], &backwards,
+              sizeof(backwards));
+  rewrite(broken);
+  EXPECT_FALSE(cache.load(source, cached));
+  broken = stored;
+  s21::MeshCache::Header huge = header;
+  huge.vertex_count = (UINT64_MAX / sizeof(glm::vec3)) + 2;
+  std::memcpy(&broken[0], &huge, sizeof(huge));
+  rewrite(broken);
+  EXPECT_FALSE(cache.load(source, cached));
+  rewrite(stored);
+  EXPECT_TRUE(cache.load(source, cached));
+
+  // Измененный источник делает кэш недействительным
+  std::ofstream(source, std::ios::app) << "# changed\n";
+  EXPECT_FALSE(cache.load(source, cached));
+
+  std::remove(cache_file.c_str());
+  std::remove(source.c_str());
+  std::remove(directory.c_str());
+}
+
+TEST(MeshCache, evicts_least_recently_loaded_over_limit) {
+  const std::string directory = "mesh_cache_limit_test";
+  const std::string sources[] = {"mesh_cache_a.obj", "mesh_cache_b.obj",
+                                 "mesh_cache_c.obj"};
+  for (const std::string& source : sources) {
+    std::ifstream in("object_files/cube.obj", std::ios::binary);
+    std::ofstream out(source, std::ios::binary);
+    out << in.rdbuf();
+  }
+  s21::Model md;
+  md.read_file(sources[0].c_str());
+  s21::MeshCache cache(directory);
+  ASSERT_TRUE(cache.store(sources[0], md));
+  uint64_t file_size = 0;
+  {
+    std::ifstream in(cache.cache_path(sources[0]),
+                     std::ios::binary | std::ios::ate);
+    file_size = static_cast<uint64_t>(in.tellg());
+  }
+
+  // Места хватает на два файла: третий вытесняет тот, что дольше не
+  // загружался
+  cache.set_limit(file_size * 2);
+  ASSERT_TRUE(cache.store(sources[1], md));
+  s21::Model loaded;
+  struct timespec pause = {0, 20000000};
+  nanosleep(&pause, nullptr);
+  ASSERT_TRUE(cache.load(sources[0], loaded));
+  nanosleep(&pause, nullptr);
+  ASSERT_TRUE(cache.store(sources[2], md));
+  EXPECT_TRUE(cache.load(sources[0], loaded));
+  EXPECT_FALSE(cache.load(sources[1], loaded));
+  EXPECT_TRUE(cache.load(sources[2], loaded));
+
+  // Модель больше предела не сохраняется
+  cache.set_limit(file_size - 1);
+  std::remove(cache.cache_path(sources[1]).c_str());
+  EXPECT_FALSE(cache.store(sources[1], md));
+  EXPECT_FALSE(cache.load(sources[1], loaded));
+
+  for (const std::string& source : sources) {
+    std::remove(cache.cache_path(source).c_str());
+    std::remove(source.c_str());
+  }
+  std::remove(directory.c_str());
+}
+
+TEST(LoadProgress, reports_counts_and_cancels) {
+  std::string text;
+  for (int i = 0; i < 200000; ++i) {
+    text += "v " + std::to_string(i) + " 0 0\n";
+  }
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  s21::LoadProgress progress;
+  s21::ObjParser parser;
+  parser.set_threads(2);
+  parser.set_progress(&progress);
+  ASSERT_TRUE(parser.parse(text.data(), text.data() + text.size(), vertices,
+                           faces));
+  EXPECT_EQ(text.size(), progress.bytes_parsed());
+  EXPECT_EQ(200000u, progress.vertices());
+
+  // Отмененная загрузка не трогает модель, в которую должна была читать
+  s21::LoadProgress cancelled;
+  cancelled.cancel();
+  parser.set_progress(&cancelled);
+  EXPECT_FALSE(parser.parse(text.data(), text.data() + text.size(), vertices,
+                            faces));
+
+  s21::Controller controller;
+  controller.setCacheDirectory("");
+  controller.loadModel("object_files/cube.obj");
+  s21::Model target = controller.prepareModel();
+  EXPECT_FALSE(
+      controller.loadModel("object_files/cube.obj", target, &cancelled));
+  EXPECT_EQ(0u, target.vertices_size());
+  s21::LoadProgress loaded;
+  ASSERT_TRUE(controller.loadModel("object_files/cube.obj", target, &loaded));
+  EXPECT_EQ(target.vertices_size(), loaded.vertices());
+  EXPECT_EQ(target.faces_size(), loaded.faces());
+  const uint64_t generation = controller.getView().topology_generation;
+  controller.swapModel(target);
+  EXPECT_NE(generation, controller.getView().topology_generation);
+}
+
+TEST(LoadStream, batches_reassemble_model) {
+  std::string text;
+  for (int i = 1; i <= 600000; ++i) {
+    text += "v " + std::to_string(i % 1000) + " " + std::to_string(i / 1000) +
+            " 0.5\n";
+    if (i > 2 && i % 3 == 0) {
+      text += "f -3 -2 -1\n";
+    } else if (i > 2) {
+      text += "f " + std::to_string(i - 2) + " " + std::to_string(i - 1) +
+              " " + std::to_string(i) + "\n";
+    }
+  }
+  for (size_t threads : {1, 4}) {
+    std::vector<glm::vec3> vertices, streamed_vertices;
+    s21::FaceList faces, streamed_faces;
+    s21::LoadStream stream;
+    s21::LoadStream::Batch batch;
+    s21::VertexKernels::Bounds streamed_bounds;
+    size_t batches = 0;
+    // Потребитель забирает порции прямо во время разбора
+    stream.set_callback([&] {
+      while (stream.take(batch)) {
+        ++batches;
+        streamed_vertices.insert(streamed_vertices.end(),
+                                 batch.vertices.begin(), batch.vertices.end());
+        streamed_faces.append(batch.faces);
+        streamed_bounds = batch.bounds;
+      }
+    });
+    s21::ObjParser parser;
+    parser.set_threads(threads);
+    parser.set_stream(&stream);
+    ASSERT_TRUE(parser.parse(text.data(), text.data() + text.size(), vertices,
+                             faces));
+    EXPECT_FALSE(stream.take(batch));
+    EXPECT_LT(3u, batches);
+    EXPECT_TRUE(vertices == streamed_vertices);
+    EXPECT_TRUE(faces == streamed_faces);
+    s21::VertexKernels::Bounds bounds =
+        s21::VertexKernels::reduce(vertices.data(), vertices.size());
+    EXPECT_EQ(bounds.min, streamed_bounds.min);
+    EXPECT_EQ(bounds.max, streamed_bounds.max);
+    EXPECT_EQ(vertices.size(), streamed_bounds.count);
+    EXPECT_NEAR(0.0f, glm::length(bounds.centroid - streamed_bounds.centroid),
+                1e-3f);
+  }
+}
+
+TEST(EdgeList, unique_edges_with_closing_sides) {
+  s21::FaceList faces;
+  const uint32_t triangles[] = {0, 1, 2, 2, 1, 3};
+  faces.push_face(triangles, 3);
+  faces.push_face(triangles + 3, 3);
+  const uint32_t quad[] = {0, 2, 4, 5};
+  faces.push_face(quad, 4);
+  const uint32_t segment[] = {5, 0};
+  faces.push_face(segment, 2);
+  const uint32_t invalid[] = {0, 6, 6};
+  faces.push_face(invalid, 3);
+  std::vector<uint32_t> edges = s21::EdgeList::build(faces, 6);
+  // Два треугольника с общим ребром 1-2: 5 ребер; квадрат добавляет 3
+  // новых (0-2 уже есть, 5-0 замыкающее), отрезок 5-0 повторяет ребро, а
+  // ребра к несуществующей вершине 6 отброшены
+  std::vector<uint32_t> expected = {0, 1, 1, 2, 0, 2, 1, 3,
+                                    2, 3, 2, 4, 4, 5, 0, 5};
+  EXPECT_EQ(expected, edges);
+
+  s21::Model model;
+  model.read_file("object_files/cube.obj");
+  const std::vector<uint32_t>& cube = model.get_edges();
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  for (size_t i = 0; i < cube.size(); i += 2) {
+    EXPECT_LT(cube[i], cube[i + 1]);
+    pairs.emplace_back(cube[i], cube[i + 1]);
+  }
+  std::sort(pairs.begin(), pairs.end());
+  EXPECT_TRUE(std::adjacent_find(pairs.begin(), pairs.end()) == pairs.end());
+  // Замкнутая сетка: V - E + F = 2
+  EXPECT_EQ(2, static_cast<long>(model.vertices_size()) -
+                   static_cast<long>(pairs.size()) +
+                   static_cast<long>(model.faces_size()));
+  EXPECT_EQ(&cube, &model.get_edges());
+}
+
+TEST(EdgeList, high_valence_vertex) {
+  // Веер вокруг вершины 0: все ребра к ней делят меньшую вершину
+  const uint32_t rim = 200000;
+  s21::FaceList fan;
+  for (uint32_t i = 1; i < rim; ++i) {
+    const uint32_t triangle[] = {0, i, i + 1};
+    fan.push_face(triangle, 3);
+  }
+  std::vector<uint32_t> edges = s21::EdgeList::build(fan, rim + 1);
+  ASSERT_EQ(2 * (2 * rim - 1), edges.size());
+  size_t spokes = 0;
+  for (size_t i = 0; i < edges.size(); i += 2) spokes += edges[i] == 0;
+  EXPECT_EQ(rim, spokes);
+}
+
+TEST(MeshWeld, welds_within_epsilon_and_drops_unreferenced) {
+  // Сетка, в которой у каждого треугольника свои копии вершин, сдвинутые
+  // меньше чем на epsilon, и вершины без граней между ними
+  const uint32_t grid = 300;
+  const float epsilon = 1e-4f;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> jitter(-0.45f * epsilon,
+                                               0.45f * epsilon);
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  size_t unreferenced = 0;
+  for (uint32_t i = 0; i + 1 < grid; ++i) {
+    for (uint32_t j = 0; j + 1 < grid; ++j) {
+      const uint32_t corners[6][2] = {{i, j},         {i, j + 1},
+                                      {i + 1, j + 1}, {i, j},
+                                      {i + 1, j + 1}, {i + 1, j}};
+      for (int t = 0; t < 2; ++t) {
+        uint32_t face[3];
+        for (int k = 0; k < 3; ++k) {
+          const uint32_t* corner = corners[3 * t + k];
+          face[k] = static_cast<uint32_t>(vertices.size());
+          vertices.emplace_back(corner[0] * 0.01f + jitter(random),
+                                corner[1] * 0.01f, 0.0f);
+        }
+        faces.push_face(face, 3);
+      }
+      if (j % 7 == 0) {
+        vertices.emplace_back(i * 0.01f, j * 0.01f, 1.0f);
+        ++unreferenced;
+      }
+    }
+  }
+  faces.push_index(static_cast<uint32_t>(vertices.size()) + 5);
+  faces.push_index(0);
+  faces.push_index(1);
+  faces.close_face();
+  const std::vector<glm::vec3> source = vertices;
+  const s21::FaceList source_faces = faces;
+
+  std::vector<glm::vec3> serial_vertices = source;
+  s21::FaceList serial_faces = source_faces;
+  s21::MeshWeld::Stats stats =
+      s21::MeshWeld::compact(serial_vertices, serial_faces, epsilon, 1);
+  EXPECT_EQ(source.size(), stats.vertices_before);
+  EXPECT_EQ(size_t(grid) * grid, stats.vertices_after);
+  EXPECT_EQ(unreferenced, stats.unreferenced);
+  EXPECT_EQ(source.size() - unreferenced - stats.vertices_after, stats.welded);
+  ASSERT_EQ(stats.vertices_after, serial_vertices.size());
+  ASSERT_EQ(source_faces.size(), serial_faces.size());
+  for (size_t f = 0; f + 1 < serial_faces.size(); ++f) {
+    for (size_t k = 0; k < 3; ++k) {
+      ASSERT_LT(serial_faces[f][k], serial_vertices.size());
+      glm::vec3 d =
+          serial_vertices[serial_faces[f][k]] - source[source_faces[f][k]];
+      ASSERT_LE(glm::dot(d, d), epsilon * epsilon) << f;
+    }
+  }
+  // Недопустимый индекс остается недопустимым
+  EXPECT_LE(serial_vertices.size(), serial_faces[serial_faces.size() - 1][0]);
+
+  // Результат не зависит от числа потоков
+  stats = s21::MeshWeld::compact(vertices, faces, epsilon, 4);
+  EXPECT_EQ(size_t(grid) * grid, stats.vertices_after);
+  EXPECT_TRUE(serial_vertices == vertices);
+  EXPECT_TRUE(serial_faces == faces);
+
+  // Вершины дальше epsilon не сливаются, даже через промежуточную
+  std::vector<glm::vec3> chain = {glm::vec3(0.0f),
+                                  glm::vec3(0.6f * epsilon, 0.0f, 0.0f),
+                                  glm::vec3(1.2f * epsilon, 0.0f, 0.0f)};
+  s21::FaceList chain_faces;
+  const uint32_t triangle[] = {0, 1, 2};
+  chain_faces.push_face(triangle, 3);
+  stats = s21::MeshWeld::compact(chain, chain_faces, epsilon);
+  EXPECT_EQ(2u, stats.vertices_after);
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1}),
+            std::vector<uint32_t>(chain_faces[0].begin(), chain_faces[0].end()));
+
+  // Контроллер сваривает модель после загрузки, счетчики - уже сжатой
+  const std::string filename = "mesh_weld_test.obj";
+  std::ofstream(filename) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 5 5 5\n"
+                             "v 1 0 0\nv 1 1 0\nf 1 2 3\nf 5 6 3\n";
+  s21::Controller controller;
+  controller.setCacheDirectory("");
+  controller.loadModel(filename);
+  EXPECT_EQ(6u, controller.getVerticesSize());
+  controller.setWeldEpsilon(0.0f);
+  controller.loadModel(filename);
+  EXPECT_EQ(4u, controller.getVerticesSize());
+  EXPECT_EQ(6u, controller.getWeldStats().vertices_before);
+  EXPECT_EQ(1u, controller.getWeldStats().welded);
+  EXPECT_EQ(1u, controller.getWeldStats().unreferenced);
+  // Без вершины (5, 5, 5) модель нормализуется заново
+  for (const glm::vec3& vertex : controller.getView().vertices) {
+    EXPECT_NEAR(1.0f, std::max(std::abs(vertex.x), std::abs(vertex.y)), 1e-6f);
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(MeshReorder, improves_vertex_cache_and_keeps_geometry) {
+  // Треугольная сетка с перемешанными вершинами и гранями
+  const uint32_t grid = 120;
+  std::mt19937 random(11);
+  std::vector<uint32_t> position(grid * grid);
+  for (uint32_t v = 0; v < position.size(); ++v) position[v] = v;
+  std::shuffle(position.begin(), position.end(), random);
+  std::vector<glm::vec3> vertices(grid * grid + 1);
+  for (uint32_t v = 0; v < grid * grid; ++v) {
+    vertices[position[v]] = glm::vec3(v / grid, v % grid, 0.0f);
+  }
+  // Последняя вершина без граней
+  vertices.back() = glm::vec3(-1.0f);
+  std::vector<std::array<uint32_t, 3>> triangles;
+  for (uint32_t i = 0; i + 1 < grid; ++i) {
+    for (uint32_t j = 0; j + 1 < grid; ++j) {
+      uint32_t a = position[i * grid + j], b = position[i * grid + j + 1];
+      uint32_t c = position[(i + 1) * grid + j];
+      uint32_t d = position[(i + 1) * grid + j + 1];
+      triangles.push_back({a, b, d});
+      triangles.push_back({a, d, c});
+    }
+  }
+  std::shuffle(triangles.begin(), triangles.end(), random);
+  s21::FaceList faces;
+  for (const auto& triangle : triangles) faces.push_face(triangle.data(), 3);
+  const uint32_t invalid[] = {0, 1, 9999999};
+  faces.push_face(invalid, 3);
+
+  auto corners = [](const std::vector<glm::vec3>& vertices,
+                    const s21::FaceList& faces) {
+    std::vector<std::array<float, 9>> result;
+    for (const auto face : faces) {
+      std::array<float, 9> key{};
+      for (size_t k = 0; k < 3 && face[k] < vertices.size(); ++k) {
+        for (int axis = 0; axis < 3; ++axis) {
+          key[3 * k + axis] = vertices[face[k]][axis];
+        }
+      }
+      result.push_back(key);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  const auto before = corners(vertices, faces);
+  s21::MeshReorder::Stats stats = s21::MeshReorder::optimize(vertices, faces);
+  EXPECT_GT(stats.acmr_before, 2.0);
+  EXPECT_LT(stats.acmr_after, 0.8);
+  EXPECT_NEAR(stats.acmr_after,
+              s21::MeshReorder::acmr(faces, vertices.size()), 1e-12);
+  EXPECT_EQ(before, corners(vertices, faces));
+  ASSERT_EQ(grid * grid + 1, vertices.size());
+  EXPECT_EQ(glm::vec3(-1.0f), vertices.back());
+
+  // Вершины пронумерованы в порядке первого использования
+  uint32_t next = 0;
+  for (uint32_t index : faces.index_data()) {
+    if (index >= vertices.size()) continue;
+    ASSERT_LE(index, next);
+    if (index == next) ++next;
+  }
+  EXPECT_EQ(grid * grid, next);
+
+  // Контроллер переставляет модель после загрузки
+  s21::Controller controller;
+  controller.setCacheDirectory("");
+  controller.loadModel("object_files/cube.obj");
+  const size_t faces_count = controller.getFacesSize();
+  const size_t vertices_count = controller.getVerticesSize();
+  controller.setOptimizeLocality(true);
+  controller.loadModel("object_files/cube.obj");
+  EXPECT_EQ(faces_count, controller.getFacesSize());
+  EXPECT_EQ(vertices_count, controller.getVerticesSize());
+}
+
+TEST(MeshLod, clusters_and_selects_levels) {
+  const uint32_t grid = 100;
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  for (uint32_t i = 0; i < grid; ++i) {
+    for (uint32_t j = 0; j < grid; ++j) {
+      vertices.emplace_back(i * 0.01f, j * 0.01f, 0.0f);
+      if (i + 1 < grid && j + 1 < grid) {
+        uint32_t a = i * grid + j, b = a + 1, c = a + grid, d = c + 1;
+        const uint32_t triangles[] = {a, b, d, a, d, c};
+        faces.push_face(triangles, 3);
+        faces.push_face(triangles + 3, 3);
+      }
+    }
+  }
+  s21::Model model;
+  model.set_transform_mode(s21::TransformMode::kMatrix);
+  model.load_normalized(vertices.data(), vertices.size(), faces);
+  s21::MeshLod::Settings settings;
+  settings.resolutions = {16, 4};
+  settings.min_faces = faces.size() + 1;
+  model.set_lod_settings(settings);
+  EXPECT_FALSE(model.build_lods());
+  settings.min_faces = 0;
+  model.set_lod_settings(settings);
+  ASSERT_TRUE(model.build_lods());
+
+  const s21::LodLevel* coarse = model.get_lod(0);
+  ASSERT_NE(nullptr, coarse);
+  EXPECT_EQ(4u, coarse->resolution);
+  EXPECT_EQ(16u, coarse->vertices.size());
+  const s21::LodLevel* fine =
+      model.get_lod(model.get_edges().size() / 2 - 1);
+  ASSERT_NE(nullptr, fine);
+  EXPECT_EQ(16u, fine->resolution);
+  EXPECT_EQ(fine, model.get_lod(fine->edges.size() / 2));
+  EXPECT_EQ(coarse, model.get_lod(fine->edges.size() / 2 - 1));
+  EXPECT_EQ(nullptr, model.get_lod(model.get_edges().size() / 2));
+  for (const s21::LodLevel* level : {coarse, fine}) {
+    EXPECT_LT(level->edges.size(), model.get_edges().size());
+    for (size_t i = 0; i < level->edges.size(); i += 2) {
+      EXPECT_LT(level->edges[i], level->edges[i + 1]);
+      EXPECT_LT(level->edges[i + 1], level->vertices.size());
+    }
+  }
+
+  // Поворот матрицей не трогает вершины, а запекание делает уровни устаревшими
+  model.rotate(30.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+  EXPECT_EQ(coarse, model.get_lod(0));
+  model.bake();
+  EXPECT_EQ(nullptr, model.get_lod(0));
+}
+
+TEST(MeshLod, parallel_parts_match_serial_clustering) {
+  // Облако на несколько частей (см. MeshLod::cluster)
+  std::mt19937 random(11);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  std::vector<glm::vec3> vertices(300000);
+  for (glm::vec3& vertex : vertices) {
+    vertex = glm::vec3(coordinate(random), coordinate(random),
+                       coordinate(random));
+  }
+  std::vector<uint32_t> edges;
+  for (uint32_t i = 0; i + 1 < vertices.size(); i += 2) {
+    edges.push_back(i);
+    edges.push_back(i + 1);
+  }
+  const unsigned resolution = 16;
+  s21::LodLevel level =
+      s21::MeshLod::cluster(vertices.data(), vertices.size(), edges, resolution);
+
+  // Проход подряд: номер кластера - по первой встрече ячейки
+  glm::vec3 min(1.0f), max(-1.0f);
+  for (const glm::vec3& vertex : vertices) {
+    min = glm::min(min, vertex);
+    max = glm::max(max, vertex);
+  }
+  glm::vec3 range = max - min;
+  float scale = resolution / std::max(range.x, std::max(range.y, range.z));
+  std::map<uint64_t, uint32_t> ids;
+  std::vector<std::array<double, 3>> sums;
+  std::vector<uint32_t> members;
+  for (const glm::vec3& vertex : vertices) {
+    glm::vec3 p = (vertex - min) * scale;
+    uint64_t key = 0;
+    for (int k = 2; k >= 0; --k) {
+      key = key * resolution +
+            std::min(static_cast<uint32_t>(std::max(p[k], 0.0f)),
+                     resolution - 1);
+    }
+    auto inserted = ids.emplace(key, static_cast<uint32_t>(members.size()));
+    if (inserted.second) {
+      sums.push_back({0.0, 0.0, 0.0});
+      members.push_back(0);
+    }
+    for (int k = 0; k < 3; ++k) sums[inserted.first->second][k] += vertex[k];
+    ++members[inserted.first->second];
+  }
+  ASSERT_EQ(members.size(), level.vertices.size());
+  for (size_t id = 0; id < members.size(); ++id) {
+    for (int k = 0; k < 3; ++k) {
+      float mean = static_cast<float>(sums[id][k] / members[id]);
+      EXPECT_NEAR(mean, level.vertices[id][k], 1e-6f);
+    }
+  }
+
+  s21::MeshLod::Settings settings;
+  settings.resolutions.clear();
+  EXPECT_TRUE(s21::MeshLod::build(vertices.data(), vertices.size(), edges,
+                                  settings)
+                  .empty());
+}
+
+TEST(MeshBvh, queries_match_brute_force) {
+  // Волнистая поверхность, достаточно большая для параллельного построения
+  const uint32_t grid = 200;
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  for (uint32_t i = 0; i < grid; ++i) {
+    for (uint32_t j = 0; j < grid; ++j) {
+      vertices.emplace_back(i * 0.01f - 1.0f, j * 0.01f - 1.0f,
+                            0.1f * std::sin(i * 0.2f) * std::cos(j * 0.3f));
+      if (i + 1 < grid && j + 1 < grid) {
+        uint32_t a = i * grid + j, b = a + 1, c = a + grid, d = c + 1;
+        const uint32_t triangles[] = {a, b, d, a, d, c};
+        faces.push_face(triangles, 3);
+        faces.push_face(triangles + 3, 3);
+      }
+    }
+  }
+  s21::Model model;
+  model.set_load_threads(4);
+  model.load_normalized(vertices.data(), vertices.size(), faces);
+  s21::Model matrix_model;
+  matrix_model.set_transform_mode(s21::TransformMode::kMatrix);
+  matrix_model.load_normalized(vertices.data(), vertices.size(), faces);
+
+  // Перебор всех граней: ближайшее попадание и грани в параллелепипеде
+  auto brute_pick = [&](const glm::vec3& origin, const glm::vec3& direction) {
+    s21::MeshView view = model.view();
+    float best = INFINITY;
+    for (const auto face : faces) {
+      glm::vec3 a = view.vertices[face[0]];
+      glm::vec3 ab = view.vertices[face[1]] - a;
+      glm::vec3 ac = view.vertices[face[2]] - a;
+      glm::vec3 p = glm::cross(direction, ac);
+      float det = glm::dot(ab, p);
+      glm::vec3 s = origin - a;
+      float u = glm::dot(s, p) / det;
+      glm::vec3 q = glm::cross(s, ab);
+      float v = glm::dot(direction, q) / det;
+      float t = glm::dot(ac, q) / det;
+      if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f) {
+        best = std::min(best, t);
+      }
+    }
+    return best;
+  };
+  auto check_picks = [&](std::mt19937& random) {
+    std::uniform_real_distribution<float> spread(-1.2f, 1.2f);
+    for (int k = 0; k < 40; ++k) {
+      glm::vec3 origin(spread(random), spread(random), 3.0f);
+      glm::vec3 direction(spread(random) * 0.3f, spread(random) * 0.3f, -1.0f);
+      float expected = brute_pick(origin, direction);
+      s21::MeshBvh::Hit hit;
+      bool found = model.ray_pick(origin, direction, hit);
+      ASSERT_EQ(expected != INFINITY, found);
+      if (!found) continue;
+      EXPECT_NEAR(expected, hit.distance, 1e-4f);
+      EXPECT_LT(hit.face, faces.size());
+      s21::MeshBvh::Hit matrix_hit;
+      ASSERT_TRUE(matrix_model.ray_pick(origin, direction, matrix_hit));
+      EXPECT_NEAR(hit.distance, matrix_hit.distance, 1e-4f);
+      EXPECT_NEAR(hit.point.z, matrix_hit.point.z, 1e-4f);
+    }
+  };
+  std::mt19937 random(7);
+  check_picks(random);
+
+  glm::vec3 box_min(-0.3f, 0.1f, -0.05f), box_max(0.2f, 0.5f, 0.05f);
+  std::vector<uint32_t> selected;
+  glm::vec4 planes[6];
+  s21::MeshBvh::box_planes(box_min, box_max, planes);
+  model.query_region(planes, 6, selected);
+  std::sort(selected.begin(), selected.end());
+  std::vector<uint32_t> expected;
+  s21::MeshView view = model.view();
+  for (uint32_t f = 0; f < faces.size(); ++f) {
+    glm::vec3 lo(INFINITY), hi(-INFINITY);
+    for (uint32_t index : faces[f]) {
+      lo = glm::min(lo, view.vertices[index]);
+      hi = glm::max(hi, view.vertices[index]);
+    }
+    if (lo.x <= box_max.x && hi.x >= box_min.x && lo.y <= box_max.y &&
+        hi.y >= box_min.y && lo.z <= box_max.z && hi.z >= box_min.z) {
+      expected.push_back(f);
+    }
+  }
+  EXPECT_FALSE(expected.empty());
+  EXPECT_EQ(expected, selected);
+
+  // Поворот вершин пересчитывает объемы, не перестраивая дерево
+  const s21::MeshBvh* tree = &model.get_bvh();
+  size_t nodes = tree->get_nodes().size();
+  model.rotate(25.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+  matrix_model.rotate(25.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+  EXPECT_EQ(tree, &model.get_bvh());
+  EXPECT_EQ(nodes, model.get_bvh().get_nodes().size());
+  check_picks(random);
+}
+
+TEST(MeshChunks, culls_only_invisible_chunks) {
+  const uint32_t grid = 300;
+  std::vector<glm::vec3> vertices;
+  s21::FaceList faces;
+  for (uint32_t i = 0; i < grid; ++i) {
+    for (uint32_t j = 0; j < grid; ++j) {
+      vertices.emplace_back(i * 0.005f - 0.75f, j * 0.005f - 0.75f, 0.0f);
+      if (i + 1 < grid && j + 1 < grid) {
+        uint32_t a = i * grid + j, b = a + 1, c = a + grid, d = c + 1;
+        const uint32_t quad[] = {a, b, d, c};
+        faces.push_face(quad, 4);
+      }
+    }
+  }
+  s21::Model model;
+  model.load_normalized(vertices.data(), vertices.size(), faces);
+  const s21::MeshChunks& chunks = model.get_chunks();
+  ASSERT_GT(chunks.get_chunks().size(), 4u);
+
+  // Перестановка не теряет и не повторяет ребер и вершин
+  std::vector<uint32_t> sorted_edges = chunks.edge_indices();
+  std::vector<uint32_t> expected_edges = model.get_edges();
+  std::sort(sorted_edges.begin(), sorted_edges.end());
+  std::sort(expected_edges.begin(), expected_edges.end());
+  EXPECT_EQ(expected_edges, sorted_edges);
+  std::vector<uint32_t> sorted_points = chunks.point_indices();
+  std::sort(sorted_points.begin(), sorted_points.end());
+  for (uint32_t v = 0; v < sorted_points.size(); ++v) {
+    ASSERT_EQ(v, sorted_points[v]);
+  }
+  EXPECT_EQ(vertices.size(), sorted_points.size());
+
+  glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 5), glm::vec3(0, 0, 0),
+                               glm::vec3(0.0f, 1.0f, 0.0f));
+  auto mvp_for = [&](float fov) {
+    return glm::perspective(glm::radians(fov), 1.0f, 0.01f, 100.0f) * view *
+           model.get_model_matrix();
+  };
+  std::vector<s21::MeshChunks::Range> edge_ranges, point_ranges;
+
+  // Модель целиком в кадре: рисуется все, и одним диапазоном
+  s21::MeshChunks::Stats stats =
+      chunks.cull(mvp_for(45.0f), 800, 600, true, edge_ranges, point_ranges);
+  EXPECT_EQ(stats.chunks, stats.drawn);
+  EXPECT_EQ(expected_edges.size() / 2, stats.edges_drawn);
+  EXPECT_EQ(vertices.size(), stats.points_drawn);
+  EXPECT_EQ(1u, edge_ranges.size());
+
+  // Приближение: часть кусков отброшена, но каждое ребро в кадре нарисовано
+  glm::mat4 zoomed = mvp_for(3.0f);
+  stats = chunks.cull(zoomed, 800, 600, false, edge_ranges, point_ranges);
+  EXPECT_GT(stats.culled_frustum, 0u);
+  EXPECT_GT(stats.drawn, 0u);
+  EXPECT_EQ(expected_edges.size() / 2, stats.edges_drawn + stats.edges_culled);
+  std::vector<bool> drawn(chunks.edge_indices().size());
+  for (const s21::MeshChunks::Range& range : edge_ranges) {
+    std::fill(drawn.begin() + range.first,
+              drawn.begin() + range.first + range.count, true);
+  }
+  s21::MeshView mesh = model.view();
+  auto visible = [&](uint32_t index) {
+    glm::vec4 clip = zoomed * glm::vec4(mesh.vertices[index], 1.0f);
+    return std::fabs(clip.x) < clip.w && std::fabs(clip.y) < clip.w;
+  };
+  size_t checked = 0;
+  for (size_t i = 0; i < drawn.size(); i += 2) {
+    if (visible(chunks.edge_indices()[i])) {
+      ++checked;
+      EXPECT_TRUE(drawn[i]);
+    }
+  }
+  EXPECT_GT(checked, 0u);
+
+  // В окне в один пиксель каждый кусок меньше пикселя
+  stats = chunks.cull(mvp_for(45.0f), 1, 1, true, edge_ranges, point_ranges);
+  EXPECT_EQ(stats.chunks, stats.culled_small);
+  EXPECT_TRUE(edge_ranges.empty());
+  EXPECT_TRUE(point_ranges.empty());
+}
+
+TEST(FrameStats, ring_percentiles_and_export) {
+  s21::FrameStats stats(8);
+  EXPECT_EQ(0u, stats.size());
+  EXPECT_EQ(0.0, stats.summarize().cpu_p99);
+
+  // Запись кадра не выделяет память
+  size_t before = allocation_count;
+  for (int i = 0; i < 20; ++i) {
+    stats.begin_frame();
+    stats.mark(s21::FrameStats::kSetup);
+    stats.mark(s21::FrameStats::kEdges);
+    stats.mark(s21::FrameStats::kEdges);
+    stats.add_submitted(10, 5);
+    stats.add_submitted(2, 1);
+    stats.end_frame();
+  }
+  EXPECT_EQ(before, allocation_count.load());
+
+  // В буфере остаются последние кадры, от старых к новым
+  ASSERT_EQ(8u, stats.size());
+  EXPECT_EQ(12u, stats.at(0).number);
+  EXPECT_EQ(19u, stats.last().number);
+  EXPECT_EQ(12u, stats.last().edges);
+  EXPECT_EQ(6u, stats.last().points);
+  const s21::FrameStats::Frame& frame = stats.last();
+  EXPECT_GE(frame.cpu, frame.phases[s21::FrameStats::kSetup] +
+                           frame.phases[s21::FrameStats::kEdges]);
+  EXPECT_LT(frame.gpu, 0.0);
+
+  // Время видеокарты приходит позже и только для кадров в буфере
+  stats.set_gpu_time(18, 1.5);
+  stats.set_gpu_time(3, 7.0);
+  EXPECT_EQ(1.5, stats.at(6).gpu);
+  s21::FrameStats::Summary summary = stats.summarize();
+  EXPECT_EQ(8u, summary.frames);
+  EXPECT_EQ(1u, summary.gpu_frames);
+  EXPECT_EQ(1.5, summary.gpu_p99);
+  EXPECT_LE(summary.cpu_p50, summary.cpu_p95);
+  EXPECT_LE(summary.cpu_p95, summary.cpu_p99);
+  EXPECT_LE(summary.cpu_p99, summary.cpu_max);
+
+  std::vector<double> values;
+  for (int i = 100; i >= 1; --i) values.push_back(i);
+  EXPECT_EQ(50.0, s21::FrameStats::percentile(values, 0.50));
+  EXPECT_EQ(95.0, s21::FrameStats::percentile(values, 0.95));
+  EXPECT_EQ(100.0, s21::FrameStats::percentile(values, 1.0));
+
+  std::ostringstream csv;
+  stats.write_csv(csv);
+  std::string line;
+  std::istringstream csv_lines(csv.str());
+  std::getline(csv_lines, line);
+  EXPECT_EQ(
+      "frame,cpu_ms,setup_ms,prepare_ms,edges_ms,points_ms,gpu_ms,edges,points",
+      line);
+  size_t rows = 0;
+  while (std::getline(csv_lines, line)) ++rows;
+  EXPECT_EQ(8u, rows);
+
+  std::ostringstream json;
+  stats.write_json(json);
+  EXPECT_NE(std::string::npos, json.str().find("\"gpu_ms\": 1.5"));
+  EXPECT_NE(std::string::npos, json.str().find("\"gpu_ms\": null"));
+  EXPECT_NE(std::string::npos, json.str().find("\"frames\": 8"));
+
+  stats.clear();
+  EXPECT_EQ(0u, stats.size());
+}
+
+TEST(TransformQueue, coalesces_into_one_update) {
+  s21::Model queued, direct;
+  queued.read_file("object_files/cube.obj");
+  direct.read_file("object_files/cube.obj");
+  // Счетчик поколений общий: следующий номер больше номера direct на один
+  uint64_t generation = direct.get_geometry_generation();
+
+  // Ввод "120" по одной цифре, сброс полей и масштаб до кадра
+  s21::TransformQueue queue;
+  EXPECT_FALSE(queue.has_pending());
+  for (float angle : {1.0f, 12.0f, 120.0f}) {
+    queue.set_rotation(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+  queue.set_rotation(30.0f, glm::vec3(-1.0f, 0.0f, 0.0f));
+  queue.set_position(glm::vec3(5.0f, 0.0f, 0.0f));
+  queue.set_position(glm::vec3(1.0f, 2.0f, 3.0f));
+  queue.scale(2.0f);
+  queue.scale(0.75f);
+  EXPECT_TRUE(queue.has_pending());
+  EXPECT_TRUE(queued.apply(queue.take()));
+  EXPECT_FALSE(queue.has_pending());
+  // Вершины переписаны один раз: счетчик поколений сдвинулся на одно
+  EXPECT_EQ(generation + 1, queued.get_geometry_generation());
+
+  // Порядок: повороты x, y, z, масштаб, положение
+  direct.rotate(30.0f, glm::vec3(-1.0f, 0.0f, 0.0f));
+  direct.rotate(120.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+  direct.scale(1.5f);
+  direct.setPossition(glm::vec3(1.0f, 2.0f, 3.0f));
+  for (size_t i = 0; i < direct.vertices_size(); i++) {
+    glm::vec3 a = direct.vertices_begin()[i], b = queued.vertices_begin()[i];
+    EXPECT_NEAR(a.x, b.x, 1e-5f);
+    EXPECT_NEAR(a.y, b.y, 1e-5f);
+    EXPECT_NEAR(a.z, b.z, 1e-5f);
+  }
+
+  // Пустая очередь и те же значения ничего не меняют
+  generation = queued.get_geometry_generation();
+  EXPECT_FALSE(queued.apply(queue.take()));
+  queue.set_rotation(120.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+  queue.set_position(glm::vec3(1.0f, 2.0f, 3.0f));
+  EXPECT_FALSE(queued.apply(queue.take()));
+  EXPECT_EQ(generation, queued.get_geometry_generation());
+}
+
+TEST(QuantizedVertices, error_within_bound) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  std::vector<glm::vec3> source(10000);
+  for (glm::vec3& vertex : source) {
+    vertex = glm::vec3(coordinate(random), coordinate(random),
+                       coordinate(random) * 0.01f);
+  }
+  source[0] = glm::vec3(-1.0f, -1.0f, -0.01f);
+  source[1] = glm::vec3(1.0f, 1.0f, 0.01f);
+
+  s21::QuantizedVertices quantized;
+  quantized.assign(source.data(), source.size());
+  ASSERT_EQ(source.size(), quantized.size());
+  EXPECT_EQ(source.size() * 6, quantized.memory_bytes());
+  glm::vec3 bound = quantized.error_bound();
+  EXPECT_NEAR(1.0f / 65535, bound.x, 1e-9f);
+  EXPECT_NEAR(0.01f / 65535, bound.z, 1e-9f);
+
+  // Шейдер раскодирует матрицей; на процессоре - тем же выражением
+  std::vector<glm::vec3> decoded(source.size());
+  quantized.decode(decoded.data());
+  glm::mat4 matrix = quantized.dequantization_matrix();
+  for (size_t i = 0; i < source.size(); i++) {
+    const uint16_t* code = quantized.data() + i * 3;
+    glm::vec3 normalized = glm::vec3(code[0], code[1], code[2]) / 65535.0f;
+    glm::vec3 shader = glm::vec3(matrix * glm::vec4(normalized, 1.0f));
+    for (int k = 0; k < 3; k++) {
+      // Полступени плюс округление float
+      float tolerance = bound[k] + 1e-6f * std::fabs(source[i][k]) + 1e-7f;
+      EXPECT_LE(std::fabs(decoded[i][k] - source[i][k]), tolerance);
+      EXPECT_NEAR(decoded[i][k], shader[k], 1e-6f);
+    }
+  }
+
+  // Плоская модель: ось без размаха раскодируется точно
+  std::vector<glm::vec3> flat{{0.0f, 0.5f, 2.0f}, {1.0f, 0.5f, 2.0f}};
+  quantized.assign(flat.data(), flat.size());
+  EXPECT_EQ(flat[0], quantized[0]);
+  EXPECT_EQ(flat[1], quantized[1]);
+  quantized.clear();
+  EXPECT_TRUE(quantized.empty());
+}
+
+TEST(QuantizedVertices, model_caches_codes_per_generation) {
+  s21::Model model;
+  model.read_file("object_files/cube.obj");
+  const s21::QuantizedVertices& first = model.quantized_vertices();
+  ASSERT_EQ(model.vertices_size(), first.size());
+  for (size_t i = 0; i < first.size(); i++) {
+    glm::vec3 expected = *(model.vertices_begin() + i);
+    for (int k = 0; k < 3; k++) {
+      EXPECT_NEAR(expected[k], first[i][k], first.error_bound()[k] + 1e-6f);
+    }
+  }
+
+  // Повторная загрузка в видеопамять без изменения вершин ничего не собирает
+  size_t before = allocation_count;
+  const s21::QuantizedVertices& again = model.quantized_vertices();
+  EXPECT_EQ(before, allocation_count.load());
+  EXPECT_EQ(&first, &again);
+
+  model.translate(glm::vec3(1.0f, 0.0f, 0.0f));
+  const s21::QuantizedVertices& moved = model.quantized_vertices();
+  EXPECT_NEAR(model.vertices_begin()->x, moved[0].x, 1e-4f);
+
+  model.clear_data();
+  EXPECT_TRUE(model.quantized_vertices().empty());
+}
+
+TEST(MeshView, idle_repaint_allocates_nothing) {
+  s21::Controller controller;
+  controller.setCacheDirectory("");
+  controller.loadModel("object_files/cube.obj");
+  s21::MeshViewTracker tracker;
+  s21::FrameStats frame_stats;
+  std::vector<s21::MeshChunks::Range> edge_ranges;
+  std::vector<s21::MeshChunks::Range> point_ranges;
+  glm::mat4 projection =
+      glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.01f, 100.0f) *
+      glm::lookAt(glm::vec3(0, 0, 5), glm::vec3(0), glm::vec3(0, 1, 0));
+
+  // Процессорная часть WidgetGL::paintGL: paintRetained (отсечение кусков)
+  // на четных кадрах, paintImmediate с упрощенной моделью на нечетных
+  float checksum = 0.0f;
+  auto paint = [&](int frame) {
+    frame_stats.begin_frame();
+    controller.applyTransforms();
+    frame_stats.mark(s21::FrameStats::kSetup);
+    s21::MeshView view = controller.getView();
+    s21::MeshViewTracker::Changes changes = tracker.sync(view);
+    if (changes.vertices || changes.topology) checksum = -1.0f;
+    const s21::MeshChunks& chunks = controller.getChunks();
+    if (frame % 2 == 0) {
+      chunks.cull(projection * view.model_matrix, 800.0f, 600.0f, true,
+                  edge_ranges, point_ranges);
+    } else {
+      edge_ranges.assign(
+          1, {0, static_cast<uint32_t>(chunks.edge_indices().size())});
+      point_ranges.assign(
+          1, {0, static_cast<uint32_t>(chunks.point_indices().size())});
+    }
+    frame_stats.mark(s21::FrameStats::kPrepare);
+    for (const auto face : *view.faces) {
+      for (uint32_t index : face) checksum += view.vertices[index].x;
+    }
+    frame_stats.mark(s21::FrameStats::kEdges);
+    frame_stats.add_submitted(chunks.edge_indices().size(),
+                              chunks.point_indices().size());
+    frame_stats.end_frame();
+  };
+  // Первые кадры выделяют диапазоны кусков, дальше память переиспользуется
+  paint(0);
+  paint(1);
+  checksum = 0.0f;
+
+  size_t before = allocation_count;
+  for (int frame = 0; frame < 1000; ++frame) paint(frame);
+  EXPECT_EQ(before, allocation_count.load());
+  EXPECT_NE(-1.0f, checksum);
+  EXPECT_FALSE(edge_ranges.empty());
+  EXPECT_EQ(1000u + 2u, frame_stats.last().number + 1);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();